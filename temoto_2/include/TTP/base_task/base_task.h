@@ -12,8 +12,9 @@
 #include "common/temoto_id.h"
 #include "common/tools.h"
 #include "TTP/task_descriptor.h"
+#include "TTP/base_task/task_event.h"
 #include "temoto_2/StopTaskMsg.h"
-#include <boost/any.hpp>
+#include <atomic>
 #include <string>
 #include <exception>
 
@@ -57,22 +58,34 @@ public:
    */
   void startTaskWrapped(TaskInterface task_interface)
   {
+    // The task was stopped before its turn came
+    if (stop_task_)
+    {
+      setState(TaskState::STOPPED);
+      return;
+    }
+
+    setState(TaskState::STARTED);
     try
     {
       startTask(task_interface);
       task_is_finished_ = true;
+      setState(stop_task_ ? TaskState::STOPPED : TaskState::FINISHED);
     }
     catch(error::ErrorStack& error_stack)
     {
       SEND_ERROR(FORWARD_ERROR(error_stack));
+      setState(TaskState::FAILED);
     }
     catch(std::exception& e)
     {
       SEND_ERROR(CREATE_ERROR(error::Code::UNHANDLED_EXCEPTION, "Caught unhandled std exception: " + std::string(e.what())));
+      setState(TaskState::FAILED);
     }
     catch(...)
     {
       SEND_ERROR(CREATE_ERROR(error::Code::UNHANDLED_EXCEPTION, "Caught unhandled exception."));
+      setState(TaskState::FAILED);
     }
   }
 
@@ -93,6 +106,52 @@ public:
     return 0;
   }
 
+  /**
+   * @brief abortTask Called when the task has not stopped in time after stopTask. Tasks which
+   * block on something that does not check stop_task_ (a service call, a child process, etc.)
+   * should interrupt it here
+   */
+  virtual void abortTask()
+  {}
+
+  /**
+   * @brief resetTaskWrapped Brings the task back to its initial state, so that the instance
+   * can be started again
+   * @return False if the task does not support being reused
+   */
+  bool resetTaskWrapped()
+  {
+    try
+    {
+      if (!resetTask())
+      {
+        return false;
+      }
+    }
+    catch(...)
+    {
+      return false;
+    }
+
+    input_subjects.clear();
+    output_subjects.clear();
+    stop_task_ = false;
+    task_is_finished_ = false;
+    task_state_ = TaskState::CREATED;
+    return true;
+  }
+
+  /**
+   * @brief resetTask Tasks which can be reused override this and reset their own state. The
+   * instances of such tasks are pooled after they have finished, instead of being constructed
+   * for every execution
+   * @return
+   */
+  virtual bool resetTask()
+  {
+    return false;
+  }
+
   /**
    * @brief taskFinished
    * @return
@@ -102,6 +161,15 @@ public:
     return task_is_finished_;
   }
 
+  /**
+   * @brief getState
+   * @return
+   */
+  TaskState getState() const
+  {
+    return task_state_;
+  }
+
   /**
    * @brief getStatus
    * @return
@@ -156,7 +224,7 @@ public:
 protected:
 
   std::string description;
-  bool stop_task_ = false;
+  std::atomic<bool> stop_task_{false};
   bool task_is_finished_ = false;
 
 private:
@@ -173,6 +241,26 @@ private:
    */
   TemotoID::ID task_id_ = TemotoID::UNASSIGNED_ID;
 
+  std::atomic<TaskState> task_state_{TaskState::CREATED};
+
+  /**
+   * @brief Queue of the task manager, which receives the state transitions of the task
+   */
+  TaskEventQueue* task_event_queue_ = nullptr;
+
+  /**
+   * @brief setState
+   * @param state
+   */
+  void setState(TaskState state)
+  {
+    task_state_ = state;
+    if (task_event_queue_)
+    {
+      task_event_queue_->push(TaskEvent{task_id_, state, std::chrono::steady_clock::now()});
+    }
+  }
+
   /**
    * @brief setID
    * @param task_id
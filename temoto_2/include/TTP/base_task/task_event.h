@@ -0,0 +1,53 @@
+#ifndef TASK_EVENT_H
+#define TASK_EVENT_H
+
+#include "common/temoto_id.h"
+#include "tbb/concurrent_queue.h"
+
+#include <chrono>
+
+namespace TTP
+{
+
+/**
+ * @brief Stages in the life of a task instance
+ */
+enum class TaskState : int
+{
+  CREATED,   // Instantiated or reset, not started yet
+  STARTED,   // startTask is running
+  FINISHED,  // startTask returned
+  FAILED,    // startTask threw
+  STOPPED    // startTask returned after the task was asked to stop, or was never started
+};
+
+inline const char* taskStateToString(TaskState state)
+{
+  switch (state)
+  {
+    case TaskState::CREATED:  return "created";
+    case TaskState::STARTED:  return "started";
+    case TaskState::FINISHED: return "finished";
+    case TaskState::FAILED:   return "failed";
+    case TaskState::STOPPED:  return "stopped";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Transition of a task into a new state
+ */
+struct TaskEvent
+{
+  TemotoID::ID task_id;
+  TaskState state;
+  std::chrono::steady_clock::time_point time;
+};
+
+/**
+ * @brief The tasks push their events without blocking, the task manager drains the queue
+ */
+typedef tbb::concurrent_bounded_queue<TaskEvent> TaskEventQueue;
+
+} // END of TTP namespace
+#endif
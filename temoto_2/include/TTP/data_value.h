@@ -0,0 +1,130 @@
+#ifndef DATA_VALUE_H
+#define DATA_VALUE_H
+
+#include <boost/variant.hpp>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+
+namespace TTP
+{
+
+/**
+ * @brief Value of a piece of subject data. Numbers, strings (topics included) and pointers are
+ * stored in place, so copying a value allocates only for the strings which do not fit into the
+ * small string buffer. The numbers are stored as double and can be read as any arithmetic type.
+ * A pointer can be read only as the same type it was stored as, e.g. a std::shared_ptr<T> as
+ * std::shared_ptr<T>. Reading a value as a wrong type throws boost::bad_get.
+ */
+class DataValue
+{
+public:
+
+  DataValue() = default;
+
+  template <class T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+  DataValue(T number) : value_(static_cast<double>(number))
+  {}
+
+  DataValue(std::string string) : value_(std::move(string))
+  {}
+
+  DataValue(const char* string) : value_(std::string(string))
+  {}
+
+  // Without this overload a non-const char* would be stored as a pointer by DataValue(T*)
+  DataValue(char* string) : value_(std::string(string))
+  {}
+
+  /**
+   * @brief Stores a raw pointer, the value does not own the pointed object.
+   */
+  template <class T>
+  DataValue(T* pointer)
+  : value_(Pointer{ std::shared_ptr<const void>(std::shared_ptr<const void>(), pointer), typeid(T*) })
+  {}
+
+  template <class T>
+  DataValue(std::shared_ptr<T> pointer)
+  : value_(Pointer{ std::shared_ptr<const void>(std::move(pointer)), typeid(std::shared_ptr<T>) })
+  {}
+
+  bool empty() const
+  {
+    return value_.which() == 0;
+  }
+
+  bool isNumber() const
+  {
+    return boost::get<double>(&value_) != nullptr;
+  }
+
+  bool isString() const
+  {
+    return boost::get<std::string>(&value_) != nullptr;
+  }
+
+  bool isPointer() const
+  {
+    return boost::get<Pointer>(&value_) != nullptr;
+  }
+
+  template <class T>
+  T get() const
+  {
+    return getAs(Tag<T>());
+  }
+
+private:
+
+  struct Pointer
+  {
+    std::shared_ptr<const void> pointer;
+    std::type_index type;
+  };
+
+  template <class T>
+  struct Tag
+  {};
+
+  template <class T>
+  typename std::enable_if<std::is_arithmetic<T>::value, T>::type getAs(Tag<T>) const
+  {
+    return static_cast<T>(boost::get<double>(value_));
+  }
+
+  const std::string& getAs(Tag<std::string>) const
+  {
+    return boost::get<std::string>(value_);
+  }
+
+  template <class T>
+  T* getAs(Tag<T*>) const
+  {
+    return static_cast<T*>(const_cast<void*>(getPointer(typeid(T*)).get()));
+  }
+
+  template <class T>
+  std::shared_ptr<T> getAs(Tag<std::shared_ptr<T>>) const
+  {
+    const std::shared_ptr<const void>& pointer = getPointer(typeid(std::shared_ptr<T>));
+    return std::shared_ptr<T>(pointer, static_cast<T*>(const_cast<void*>(pointer.get())));
+  }
+
+  const std::shared_ptr<const void>& getPointer(const std::type_index& type) const
+  {
+    const Pointer& pointer = boost::get<Pointer>(value_);
+    if (pointer.type != type)
+    {
+      throw boost::bad_get();
+    }
+    return pointer.pointer;
+  }
+
+  boost::variant<boost::blank, double, std::string, Pointer> value_;
+};
+
+} // END of TTP namespace
+#endif
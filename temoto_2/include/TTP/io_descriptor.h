@@ -1,7 +1,8 @@
 #ifndef IO_DESCRIPTOR_H
 #define IO_DESCRIPTOR_H
 
-#include <boost/any.hpp>
+#include "TTP/data_value.h"
+#include <memory>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -16,6 +17,9 @@ namespace TTP
 class Subject;
 typedef std::vector<Subject> Subjects;
 
+// Subjects passed between the tasks, shared by all the receiving tasks without copying
+typedef std::shared_ptr<const Subjects> SubjectsPtr;
+
 Subject getSubjectByType(const std::string& type, Subjects& subjects);
 
 /**
@@ -26,11 +30,11 @@ class Data
 public:
 
   std::string type = "";
-  boost::any value;
+  DataValue value;
 
   Data(){}
 
-  Data(std::string type_in, boost::any value_in) : type(type_in), value(value_in){}
+  Data(std::string type_in, DataValue value_in) : type(std::move(type_in)), value(std::move(value_in)){}
 
 //  Data& operator=(const Data& rhs)
 //  {
@@ -82,7 +86,7 @@ public:
 
   void addData(std::string datatype, float data);
   void addData(std::string datatype, std::string data);
-  void addData(std::string datatype, boost::any data);
+  void addData(std::string datatype, DataValue data);
 
   void markIncomplete();
   void markComplete();
@@ -32,9 +32,8 @@ public:
 
   /**
    * @brief branch_finder
-   * @param num_str_map
    */
-  branch_finder(std::shared_ptr<TTP::nummap> num_str_map);
+  branch_finder();
 
   void operator()(const leaf_node&) override;
   void operator()(const internal_node&) override;
@@ -49,9 +48,6 @@ public:
 
 private:
 
-  // Pointer to the string-to-number lookup table
-  std::shared_ptr<TTP::nummap> num_str_map_;
-
   // The storage for the task descriptors found so far
   std::vector<TTP::TaskDescriptor> task_descs_;
 
@@ -26,21 +26,20 @@ public:
 
     /**
      * @brief Looks for any potential tasks from input text and
-     * sets them in hierarchical order,i.e., task tree
+     * sets them in hierarchical order,i.e., task tree. Each sentence
+     * of the text gets a task tree of its own, the sentences are
+     * processed in parallel. Can be called from multiple threads.
      * @param input_text
-     * @return
+     * @return Task trees of the sentences that contain tasks
      */
-    TaskTree processText(std::string input_text);
+    std::vector<TaskTree> processText(std::string input_text);
 
 private:
 
+    // The models are not modified after loading, so they are shared by the threads
     meta::sequence::perceptron tagger_;
 
     meta::parser::sr_parser parser_;
-
-    TaskTree task_tree_;
-
-    std::shared_ptr<nummap> str_int_map_;
 };
 
 }// END of TTP namespace
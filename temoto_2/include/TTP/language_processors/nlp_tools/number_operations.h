@@ -6,13 +6,11 @@
 #include <vector>
 #include <iostream>
 #include <stdexcept>
-#include <unordered_map>
+#include <string>
 
 namespace TTP
 {
 
-typedef std::unordered_map<std::string, int> nummap;
-
 const std::vector<std::string> first14 = {"zero", "one", "two", "three", "four", "five", "six", "seven",
                                           "eight", "nine", "ten", "eleven", "twelve", "thirteen",
                                           "fourteen" };
@@ -26,11 +24,13 @@ const std::vector<std::string> prefixes = {"twen", "thir", "for", "fif", "six",
 std::string inttostr( const unsigned int number );
 
 /**
- * @brief Function that generates an str->int map
- * @param max_nr
- * @return
+ * @brief Parses a number in words, as written by inttostr, without building a lookup table.
+ * Accepts exactly the strings inttostr produces for 0 ... 999999.
+ * @param str
+ * @param number The parsed number, set only if the parsing succeeds
+ * @return False if the string is not a number in words
  */
-nummap generateStrToNrMap(int max_nr);
+bool strtoint( const std::string& str, unsigned int& number );
 
 }
 
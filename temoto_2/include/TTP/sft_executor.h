@@ -0,0 +1,100 @@
+#ifndef SFT_EXECUTOR_H
+#define SFT_EXECUTOR_H
+
+#include "tbb/task_arena.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TTP
+{
+
+/**
+ * @brief Long-lived executor for the semantic frame trees. A fixed number of threads take the
+ * submitted jobs from a bounded queue and run them inside a shared tbb::task_arena, so the flow
+ * graphs built by the jobs run their nodes on the workers of the arena instead of spawning
+ * threads of their own. The threads are dedicated to the jobs, because the tasks may block for as
+ * long as they run and would otherwise starve the TBB workers.
+ */
+class SFTExecutor
+{
+public:
+
+  typedef std::function<void()> Job;
+
+  /**
+   * @param thread_count Number of jobs that may run at the same time.
+   * @param queue_size Number of jobs that may wait for a free thread, further ones are rejected.
+   * @param concurrency Number of TBB workers the running jobs share for their flow graph nodes.
+   */
+  SFTExecutor(size_t thread_count, size_t queue_size, size_t concurrency);
+
+  ~SFTExecutor();
+
+  SFTExecutor(const SFTExecutor&) = delete;
+  SFTExecutor& operator=(const SFTExecutor&) = delete;
+
+  /**
+   * @brief Queues a job. The done callback is invoked by the executing thread right after the
+   * job has returned or thrown.
+   * @return False if the queue is full or the executor has been shut down.
+   */
+  bool submit(Job job, Job done = Job());
+
+  /**
+   * @brief Stops accepting jobs and drops the ones which have not started yet. Does not wait for
+   * the running jobs, these are waited for by the destructor.
+   */
+  void shutdown();
+
+  /**
+   * @brief Shuts the executor down and waits for the running jobs until the deadline. The jobs
+   * are never abandoned, as they use their owner, join or the destructor waits for the ones still
+   * running.
+   * @return False if some of the jobs were still running at the deadline.
+   */
+  bool waitIdle(std::chrono::steady_clock::time_point deadline);
+
+  /**
+   * @brief Shuts the executor down and waits for the running jobs, however long they take.
+   */
+  void join();
+
+private:
+
+  struct QueuedJob
+  {
+    Job job;
+    Job done;
+  };
+
+  void executorThread();
+
+  size_t queue_size_;
+
+  tbb::task_arena arena_;
+
+  std::deque<QueuedJob> job_queue_;
+
+  std::mutex job_queue_mutex_;
+
+  std::condition_variable job_queue_cv_;
+
+  bool running_ = true;
+
+  /// Number of threads which have not returned yet, guarded by job_queue_mutex_
+  size_t running_threads_ = 0;
+
+  std::condition_variable threads_done_cv_;
+
+  std::vector<std::thread> threads_;
+};
+
+} // END of TTP namespace
+#endif
@@ -4,6 +4,7 @@
 #include "TTP/base_task/base_task.h"
 #include "TTP/task_descriptor.h"
 #include <boost/shared_ptr.hpp>
+#include <functional>
 
 namespace TTP
 {
@@ -12,20 +13,38 @@ class TaskContainer
 {
 public:
 
+    /**
+     * @brief Stores the interface of the task into its descriptor. The descriptor is shared with
+     * the task manager, which reads it from other threads
+     */
+    typedef std::function<void(TaskDescriptor&, const TaskInterface&)> InterfaceUpdater;
+
     /**
      * @brief TaskContainer
      * @param pointer to the task
-     * @param task_interface
+     * @param task_descriptor
+     * @param update_interface Called with the completed input subjects before the task is started
+     * and with the output subjects after it has finished
      */
-    TaskContainer(boost::shared_ptr<BaseTask> task_pointer, boost::shared_ptr<TaskDescriptor> task_descriptor);
+    TaskContainer(boost::shared_ptr<BaseTask> task_pointer,
+                  boost::shared_ptr<TaskDescriptor> task_descriptor,
+                  InterfaceUpdater update_interface);
 
-    Subjects operator()(Subjects input_subjects);
+    /**
+     * @brief Runs the task. The subjects are shared with the other children of the parent task,
+     * so they are only read
+     * @param input_subjects
+     * @return Output subjects of the task
+     */
+    SubjectsPtr operator()(const SubjectsPtr& input_subjects);
 
 private:
 
     boost::shared_ptr<BaseTask> task_pointer_;
 
     boost::shared_ptr<TaskDescriptor> task_descriptor_;
+
+    InterfaceUpdater update_interface_;
 };
 }// END of TTP namespace
 
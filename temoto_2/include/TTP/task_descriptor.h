@@ -9,6 +9,8 @@ namespace TTP
 class TaskDescriptorProcessor;
 class TaskTreeBuilder;
 class TaskManager;
+class TaskIndex;
+class TaskIndexCache;
 
 typedef std::string Action;
 
@@ -34,6 +36,8 @@ class TaskDescriptor
   friend TaskDescriptorProcessor;
   friend TaskTreeBuilder;
   friend TaskManager;
+  friend TaskIndex;
+  friend TaskIndexCache;
 
 public:
 
@@ -0,0 +1,72 @@
+#ifndef TASK_INDEX_H
+#define TASK_INDEX_H
+
+#include "TTP/task_descriptor.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TTP
+{
+
+/**
+ * @brief Inverted index over the indexed tasks. The tasks are looked up by their action and by
+ * their stemmed action and aliases. For each stemmed action, the interfaces of its tasks are kept
+ * in posting lists by the types of their input subjects, so that only the interfaces which can
+ * take the subjects of a task tree node are scored.
+ *
+ * The index refers to the tasks by their position in the vector it was built from, so it has to
+ * be built again whenever that vector changes.
+ */
+class TaskIndex
+{
+public:
+
+  /**
+   * @brief Interface of an indexed task together with the number of subjects of each type it
+   * takes and provides.
+   */
+  struct InterfaceEntry
+  {
+    const TaskDescriptor* task;
+    const TaskInterface* interface;
+    std::map<std::string, unsigned int> input_types;
+    std::map<std::string, unsigned int> output_types;
+  };
+
+  void build(const std::vector<TaskDescriptor>& tasks);
+
+  /**
+   * @brief Returns the tasks of the given (non-stemmed) action.
+   */
+  std::vector<const TaskDescriptor*> findByAction(const Action& action) const;
+
+  /**
+   * @brief Returns the interfaces of the tasks which match the stemmed action, either by their
+   * action or by an alias, and can take the given subjects. An interface qualifies if the subjects
+   * contain at least as many subjects of each type as the interface requires. The interfaces are
+   * returned in the order of the tasks and their interfaces.
+   */
+  std::vector<const InterfaceEntry*> findInterfaces(const Action& action_stemmed,
+                                                    const std::vector<Subject>& subjects) const;
+
+private:
+
+  struct ActionPostings
+  {
+    /// Posting lists of the interfaces by the types of their input subjects
+    std::map<std::string, std::vector<size_t>> by_input_type;
+  };
+
+  std::vector<InterfaceEntry> interfaces_;
+
+  /// Tasks by their action
+  std::map<Action, std::vector<const TaskDescriptor*>> by_action_;
+
+  /// Postings by the stemmed action and the stemmed aliases of the tasks
+  std::map<Action, ActionPostings> by_action_stemmed_;
+};
+
+} // END of TTP namespace
+#endif
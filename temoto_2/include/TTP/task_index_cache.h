@@ -0,0 +1,123 @@
+#ifndef TASK_INDEX_CACHE_H
+#define TASK_INDEX_CACHE_H
+
+#include "TTP/task_descriptor.h"
+#include <yaml-cpp/yaml.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace TTP
+{
+
+/**
+ * @brief Keeps the task descriptors of an actions directory together with the mtimes and sizes of
+ * the descriptor.xml and package.xml files they were parsed from. A task has to be parsed again
+ * only when one of these files has changed. The cache is stored in a YAML file, so that it
+ * survives the restarts of the agent.
+ */
+class TaskIndexCache
+{
+public:
+
+  /**
+   * @brief Identifies the version of a file without reading it.
+   */
+  struct FileStamp
+  {
+    int64_t mtime_sec = 0;
+    int64_t mtime_nsec = 0;
+    int64_t size = -1;
+
+    bool operator==(const FileStamp& other) const
+    {
+      return mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec && size == other.size;
+    }
+  };
+
+  /**
+   * @brief Stamps of the files a task descriptor is parsed from.
+   */
+  struct TaskStamp
+  {
+    FileStamp descriptor;
+    FileStamp package;
+
+    bool operator==(const TaskStamp& other) const
+    {
+      return descriptor == other.descriptor && package == other.package;
+    }
+  };
+
+  /**
+   * @brief Gets the stamp of a regular file.
+   * @return False if the file is missing.
+   */
+  static bool getFileStamp(const std::string& path, FileStamp& stamp);
+
+  /**
+   * @brief Gets the stamps of the descriptor.xml and package.xml in the task directory.
+   * @return False if either of the files is missing.
+   */
+  static bool getTaskStamp(const std::string& task_dir, TaskStamp& stamp);
+
+  /**
+   * @brief Returns the path of the cache file for an actions directory. The file is located in
+   * $ROS_HOME, or in ~/.ros if ROS_HOME is not set.
+   */
+  static std::string getCacheFilePath(const std::string& actions_dir);
+
+  /**
+   * @brief Switches to the given cache file. The entries are loaded from the file unless it is
+   * already in use.
+   * @return False if the file exists but could not be parsed, the cache is empty then.
+   */
+  bool open(const std::string& cache_file_path);
+
+  /**
+   * @brief Writes the entries to the cache file if they have changed since they were loaded.
+   * @return False if the file could not be written.
+   */
+  bool save();
+
+  /**
+   * @brief Finds the descriptor of the task directory which was parsed from files with the same
+   * stamp.
+   */
+  bool find(const std::string& task_dir, const TaskStamp& stamp, TaskDescriptor& descriptor);
+
+  void set(const std::string& task_dir, const TaskStamp& stamp, const TaskDescriptor& descriptor);
+
+  /**
+   * @brief Drops the entries which have not been found or set since the previous call, i.e. the
+   * tasks which were not seen by the last indexing.
+   */
+  void dropUnused();
+
+private:
+
+  struct Entry
+  {
+    TaskStamp stamp;
+    TaskDescriptor descriptor;
+    bool used = false;
+  };
+
+  static YAML::Node encodeDescriptor(const TaskDescriptor& descriptor);
+
+  static TaskDescriptor decodeDescriptor(const YAML::Node& node);
+
+  std::string cache_file_path_;
+
+  /// Entries by the path of the task directory
+  std::map<std::string, Entry> entries_;
+
+  bool modified_ = false;
+
+  std::mutex cache_mutex_;
+};
+
+} // END of TTP namespace
+#endif
@@ -0,0 +1,116 @@
+#ifndef TASK_LIBRARY_CACHE_H
+#define TASK_LIBRARY_CACHE_H
+
+#include "TTP/base_task/base_task.h"
+#include "TTP/task_index_cache.h"
+
+#include <class_loader/class_loader.h>
+#include <boost/shared_ptr.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TTP
+{
+
+/**
+ * @brief Keeps the task libraries loaded between the executions. Every task instance holds a
+ * reference to the class loader of its library, so a library is never unloaded while its tasks
+ * are alive. When more than the allowed number of libraries are loaded, the least recently used
+ * library without living instances is unloaded. Libraries are loaded again only when their file
+ * has changed on disk.
+ *
+ * Finished instances of the tasks which can be reset are kept in a pool and reused by the next
+ * executions of the same task.
+ */
+class TaskLibraryCache
+{
+public:
+
+  /**
+   * @param capacity Number of libraries which are kept loaded, the pinned libraries included.
+   * @param pool_size Number of finished instances kept for each task class, 0 disables pooling.
+   */
+  TaskLibraryCache(size_t capacity, size_t pool_size);
+
+  /**
+   * @brief Loads the library, unless it is already loaded and has not changed on disk.
+   * @return Names of the task classes in the library.
+   */
+  std::vector<std::string> load(const std::string& lib_path);
+
+  /**
+   * @brief Loads the library and keeps it loaded regardless of how recently it was used.
+   */
+  void pin(const std::string& lib_path);
+
+  /**
+   * @brief Returns a pooled instance of the class or creates a new one.
+   */
+  boost::shared_ptr<BaseTask> createInstance(const std::string& lib_path, const std::string& class_name);
+
+  /**
+   * @brief Offers a finished instance to the pool. The instance is kept only if the task could be
+   * reset and its library has not changed in the meantime, otherwise it is destroyed.
+   */
+  void releaseInstance( const std::string& lib_path
+                      , const std::string& class_name
+                      , boost::shared_ptr<BaseTask> instance);
+
+  /**
+   * @brief Unloads the library if none of its instances are alive.
+   */
+  void unload(const std::string& lib_path);
+
+  /**
+   * @brief Returns the paths of the loaded libraries which have changed or have been removed on disk.
+   */
+  std::vector<std::string> getChanged();
+
+  /**
+   * @brief Unloads the libraries which have changed or have been removed on disk, and have no
+   * living instances. The rest of the changed libraries are loaded again once they are released.
+   */
+  void unloadChanged();
+
+private:
+
+  struct Library
+  {
+    boost::shared_ptr<class_loader::ClassLoader> loader;
+    TaskIndexCache::FileStamp stamp;
+    std::vector<std::string> classes;
+
+    /// Pooled instances by their class names
+    std::map<std::string, std::vector<boost::shared_ptr<BaseTask>>> idle_instances;
+
+    uint64_t last_used = 0;
+    bool pinned = false;
+  };
+
+  Library& loadLocked(const std::string& lib_path);
+
+  bool isInUse(const Library& library) const;
+
+  bool hasChanged(const std::string& lib_path, const Library& library) const;
+
+  void evictLocked();
+
+  size_t capacity_;
+
+  size_t pool_size_;
+
+  /// Incremented on each use of a library, orders the libraries by their last use
+  uint64_t use_counter_ = 0;
+
+  /// Loaded libraries by their paths
+  std::map<std::string, Library> libraries_;
+
+  std::mutex libraries_mutex_;
+};
+
+} // END of TTP namespace
+#endif
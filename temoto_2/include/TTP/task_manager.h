@@ -5,8 +5,13 @@
 #include "common/temoto_id.h"
 #include "common/base_subsystem.h"
 #include "TTP/task_descriptor.h"
+#include "TTP/task_index.h"
+#include "TTP/task_index_cache.h"
+#include "TTP/task_library_cache.h"
+#include "TTP/sft_executor.h"
 #include "TTP/task_tree.h"
 #include "TTP/base_task/base_task.h"
+#include "TTP/base_task/task_event.h"
 #include "TTP/language_processors/meta/meta_lp.h"
 
 #include "temoto_2/StopTask.h"
@@ -16,12 +21,18 @@
 
 #include "tbb/flow_graph.h"
 #include <class_loader/multi_library_class_loader.h>
-#include <boost/any.hpp>
 #include "boost/filesystem.hpp"
 #include <exception>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <thread>
-#include <future>
 
 namespace TTP
 {
@@ -75,9 +86,9 @@ public:
 
   /**
    * @brief getIndexedTasks
-   * @return
+   * @return Copy of the indexed tasks, since the index can be rebuilt at any time
    */
-  std::vector <TaskDescriptor>& getIndexedTasks();
+  std::vector <TaskDescriptor> getIndexedTasks();
 
   void connectTaskTree(TaskTreeNode& node, std::vector<Subject> parent_subjects, unsigned int depth = 0);
 
@@ -124,27 +135,120 @@ private:
 
   const std::string description_file_ = "descriptor.xml";
 
-  bool action_executioner_busy_ = false;
-
   bool nlp_enabled_;
 
+  /**
+   * @brief State of a semantic frame tree in execution
+   */
+  struct SFTContext
+  {
+    unsigned int id;
+    std::chrono::steady_clock::time_point start_time;
+
+    /// Libraries of the tasks in the tree, which cannot be replaced while the tree is running
+    std::set<std::string> lib_paths;
+
+    /// Tasks of the tree, released once the tree and its flow graph are gone
+    std::vector<TemotoID::ID> task_ids;
+  };
+
+  /**
+   * @brief Trees which are running, by their IDs
+   */
+  std::map<unsigned int, std::shared_ptr<const SFTContext>> running_sfts_;
+
+  /**
+   * @brief Libraries waiting for the trees which use them to finish before being replaced. The
+   * new trees which need any of these libraries wait until the replacement is done
+   */
+  std::set<std::string> replaced_task_libs_;
 
-  ros::Timer thread_joining_timer_;
+  unsigned int sft_counter_ = 0;
 
-  std::vector<std::thread> flow_graph_threads_;
+  /**
+   * @brief Guards running_sfts_, replaced_task_libs_ and sft_counter_
+   */
+  std::mutex sft_mutex_;
 
-  std::vector<std::future<void>> flow_graph_futures_;
+  /**
+   * @brief Notified whenever a tree has finished or the libraries have been replaced
+   */
+  std::condition_variable sft_cv_;
 
   std::vector<std::pair<boost::shared_ptr<TaskDescriptor>, boost::shared_ptr<BaseTask>>> asynchronous_tasks_;
 
   std::vector<std::pair<boost::shared_ptr<TaskDescriptor>, boost::shared_ptr<BaseTask>>> synchronous_tasks_;
 
-  std::vector<std::string> synchronous_task_libs_;
+  /**
+   * @brief Guards asynchronous_tasks_, synchronous_tasks_ and the task descriptors they hold. The
+   * trees which look for the outputs of the running asynchronous tasks take it shared
+   */
+  std::shared_timed_mutex tasks_mutex_;
+
+  /**
+   * @brief Default time in seconds a task is given to stop, and after that to abort, before it is
+   * abandoned. Overridden by the private "task_stop_timeout" parameter of the node
+   */
+  static constexpr double DEFAULT_TASK_STOP_TIMEOUT = 5.0;
+
+  std::chrono::milliseconds task_stop_timeout_;
+
+  /**
+   * @brief State transitions of the tasks, drained by the task event thread
+   */
+  TaskEventQueue task_events_;
+
+  std::thread task_event_thread_;
+
+  /**
+   * @brief Start times of the running tasks by their IDs, used only by the task event thread
+   */
+  std::map<TemotoID::ID, std::chrono::steady_clock::time_point> task_start_times_;
+
+  /**
+   * @brief Notified by the task event thread after each state transition
+   */
+  std::mutex task_state_mutex_;
+
+  std::condition_variable task_state_cv_;
 
   TTP::MetaLP* language_processor_;
 
   ros::Subscriber human_chatter_subscriber_;
 
+  /**
+   * @brief Maximum number of instructions waiting to be processed, further ones are dropped
+   */
+  static const size_t INSTRUCTION_QUEUE_SIZE = 16;
+
+  /**
+   * @brief Instructions received from the human chatter topic, waiting to be processed
+   */
+  std::deque<std::string> instruction_queue_;
+
+  std::mutex instruction_queue_mutex_;
+
+  std::condition_variable instruction_queue_cv_;
+
+  bool instruction_thread_running_ = false;
+
+  std::thread instruction_thread_;
+
+  /**
+   * @brief Number of semantic frame trees executed at the same time
+   */
+  static const size_t SFT_EXECUTOR_THREADS = 4;
+
+  /**
+   * @brief Maximum number of semantic frame trees waiting for execution, further ones are rejected
+   */
+  static const size_t SFT_QUEUE_SIZE = 16;
+
+  /**
+   * @brief Number of TBB workers shared by the flow graphs of the executed trees
+   */
+  static const size_t SFT_FLOW_GRAPH_CONCURRENCY = 4;
+
   /**
    * @brief n_
    */
@@ -155,6 +259,11 @@ private:
    */
   TemotoID::IDManager id_manager_;
 
+  /**
+   * @brief Guards id_manager_, the tasks of the trees are instantiated in parallel
+   */
+  std::mutex id_mutex_;
+
 
   ros::ServiceServer stop_task_server_;
 
@@ -173,12 +282,58 @@ private:
    */
   std::vector <TaskDescriptor> tasks_indexed_;
 
+  /**
+   * @brief Inverted index over tasks_indexed_, rebuilt whenever the tasks are indexed
+   */
+  TaskIndex task_index_;
+
+  /**
+   * @brief Guards tasks_indexed_ and task_index_. The trees take it shared while they are being
+   * connected, indexing takes it exclusively only for swapping in the new index
+   */
+  std::shared_timed_mutex task_index_mutex_;
+
+  /**
+   * @brief Allows only one indexing at a time
+   */
+  std::mutex indexing_mutex_;
+
+  /**
+   * @brief Descriptors of the indexed tasks by their directories, parsed again only when changed
+   */
+  TaskIndexCache task_index_cache_;
+
   /**
    * @brief class_loader_
    */
   class_loader::MultiLibraryClassLoader* class_loader_;
 
-  std::map<std::string, boost::shared_ptr<class_loader::ClassLoader>> class_loaders_;
+  /**
+   * @brief Number of task libraries kept loaded between the executions
+   */
+  static const size_t MAX_LOADED_TASK_LIBS = 32;
+
+  /**
+   * @brief Number of finished instances kept for each resettable task class
+   */
+  static const size_t TASK_INSTANCE_POOL_SIZE = 2;
+
+  /**
+   * @brief Loaded task libraries and the pooled task instances
+   */
+  TaskLibraryCache task_library_cache_;
+
+  /**
+   * @brief Packages of the tasks which are loaded right after indexing and kept loaded. Read from
+   * the private "preload_tasks" parameter of the node
+   */
+  std::vector<std::string> preloaded_task_packages_;
+
+  /**
+   * @brief Executes the semantic frame trees. Declared last, so that the running trees are waited
+   * for before the rest of the members are destroyed
+   */
+  SFTExecutor sft_executor_;
 
   void initCore(std::string ai_libs_path, std::string chatter_topic);
 
@@ -198,6 +353,29 @@ private:
    */
   void indexTasksCallback (temoto_2::IndexTasks index_msg);
 
+  /**
+   * @brief Looks for the tasks in a directory entry, going into subdirectories up to the search depth.
+   * @param entry
+   * @param search_depth
+   * @param tasks_found
+   */
+  void findTasksInEntry(const boost::filesystem::directory_entry& entry,
+                        int search_depth,
+                        std::vector<TaskDescriptor>& tasks_found);
+
+  /**
+   * @brief Returns the cached descriptor of the task, parsing it only if the descriptor.xml or
+   * package.xml has changed.
+   * @param task_dir
+   * @return
+   */
+  TaskDescriptor getTaskDescriptor(const std::string& task_dir);
+
+  /**
+   * @brief Loads the libraries of the indexed tasks listed in preloaded_task_packages_
+   */
+  void preloadTasks();
+
   /**
    * @brief humanChatterCb
    * @param chat
@@ -205,10 +383,79 @@ private:
   void humanChatterCb (std_msgs::String chat);
 
   /**
-   * @brief threadJoiningTimerCallback
-   * @param event
+   * @brief Processes the queued instructions one by one
+   */
+  void instructionThread();
+
+  /**
+   * @brief Drains the task events as they arrive and wakes up the ones waiting for the tasks
+   */
+  void taskEventThread();
+
+  /**
+   * @brief Waits until the task is not running
+   * @param task
+   * @param deadline
+   * @return False if the task was still running at the deadline
+   */
+  bool waitForTaskEnd(const boost::shared_ptr<BaseTask>& task,
+                      std::chrono::steady_clock::time_point deadline);
+
+  /**
+   * @brief Asks the tasks to stop and waits for them up to task_stop_timeout_. The tasks which
+   * are still running are aborted and waited for again, the ones which do not react to that
+   * either are abandoned.
+   * @param tasks
+   * @return False if any of the tasks was abandoned
+   */
+  bool stopTaskInstances(const std::vector<boost::shared_ptr<BaseTask>>& tasks);
+
+  /**
+   * @brief Collects the IDs of the tasks in the tree
+   * @param node
+   * @param task_ids
+   */
+  void getTaskIds(TaskTreeNode& node, std::vector<TemotoID::ID>& task_ids);
+
+  /**
+   * @brief Stops tracking the synchronous tasks of an executed tree and returns them to the
+   * library cache
+   * @param task_ids
+   */
+  void releaseSynchronousTasks(const std::vector<TemotoID::ID>& task_ids);
+
+  /**
+   * @brief Collects the paths of the task libraries in the tree
+   * @param node
+   * @param lib_paths
+   */
+  void getLibPaths(TaskTreeNode& node, std::set<std::string>& lib_paths);
+
+  /**
+   * @brief Registers the tree as running. Waits first if any of the libraries of the tree is
+   * being replaced
+   * @param context
+   */
+  void registerSFT(const std::shared_ptr<SFTContext>& context);
+
+  /**
+   * @brief Removes the tree from the running trees and wakes up the indexing waiting for it
+   * @param context
+   */
+  void unregisterSFT(const SFTContext& context);
+
+  /**
+   * @brief Unloads the changed task libraries once the trees using them have finished. The trees
+   * which do not use any of the changed libraries are not waited for
+   */
+  void replaceChangedLibraries();
+
+  /**
+   * @brief Updates the interface of a task descriptor held by the task registries
+   * @param task_descriptor
+   * @param task_interface
    */
-  void threadJoiningTimerCallback(const ros::TimerEvent &e);
+  void updateTaskInterface(TaskDescriptor& task_descriptor, const TaskInterface& task_interface);
 
 };
 
@@ -24,7 +24,7 @@ class TaskTreeNode
 public:
 
     // TODO: MAKE PRIVATE!!!!!!!!!!
-    std::unique_ptr< tbb::flow::broadcast_node<Subjects> > root_fgn_;
+    std::unique_ptr< tbb::flow::broadcast_node<SubjectsPtr> > root_fgn_;
 
     /**
      * @brief A default constructor that is used for creating root nodes only
@@ -59,7 +59,7 @@ private:
     // task descriptors are needed for stopping the tasks correctly
     boost::shared_ptr<TaskDescriptor> task_descriptor_ptr_;
 
-    std::unique_ptr< tbb::flow::function_node<Subjects, Subjects> > task_fgn_;
+    std::unique_ptr< tbb::flow::function_node<SubjectsPtr, SubjectsPtr> > task_fgn_;
 
     std::vector<TaskTreeNode> child_nodes_;
 };
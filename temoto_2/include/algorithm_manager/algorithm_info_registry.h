@@ -1,18 +1,17 @@
 #ifndef ALGORITHM_INFO_DATABASE_H
 #define ALGORITHM_INFO_DATABASE_H
 
+#include "common/info_registry.h"
 #include "algorithm_manager/algorithm_info.h"
 #include "temoto_2/LoadAlgorithm.h"
 
-#include <mutex>
-
 namespace algorithm_manager
 {
 
 /**
  * @brief Class that maintains and handles the algorithm info objects
  */
-class AlgorithmInfoRegistry
+class AlgorithmInfoRegistry : public common::InfoRegistry<AlgorithmInfo>
 {
 public:
 
@@ -43,34 +42,17 @@ public:
 
   bool updateRemoteAlgorithm(const AlgorithmInfo& si, bool advertised = false);
 
-  const std::vector<AlgorithmInfo>& getLocalAlgorithms() const;
-
-  const std::vector<AlgorithmInfo>& getRemoteAlgorithms() const;
-
-private:
-
   /**
-   * @brief findAlgorithm
-   * @param req
-   * @param algorithms
-   * @return
+   * @brief Returns a copy of the local algorithms, so that it can be used without holding the
+   * lock.
    */
-  bool findAlgorithm( temoto_2::LoadAlgorithm::Request& req
-                 , const std::vector<AlgorithmInfo>& algorithms
-                 , AlgorithmInfo& si_ret ) const;
-
-  bool findAlgorithm( const AlgorithmInfo& si
-                 , const std::vector<AlgorithmInfo>& algorithms
-                 , AlgorithmInfo& si_ret ) const;
+  std::vector<AlgorithmInfo> getLocalAlgorithms() const;
 
-  /// List of all locally defined algorithms.
-  std::vector<AlgorithmInfo> local_algorithms_;
-
-  /// List of all algorithms in remote managers.
-  std::vector<AlgorithmInfo> remote_algorithms_;
-
-  /// Mutex for protecting algorithm info vectors from data races
-  mutable std::mutex read_write_mutex;
+  /**
+   * @brief Returns a copy of the remote algorithms, so that it can be used without holding the
+   * lock.
+   */
+  std::vector<AlgorithmInfo> getRemoteAlgorithms() const;
 };
 
 } // algorithm_manager namespace
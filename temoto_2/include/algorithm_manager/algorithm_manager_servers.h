@@ -10,6 +10,8 @@
 #include "std_msgs/String.h"
 #include "common/temoto_id.h"
 
+#include <mutex>
+
 namespace algorithm_manager
 {
 
@@ -77,6 +79,9 @@ private:
   /// List of allocated algorithms
   std::map<temoto_id::ID, AlgorithmInfo> allocated_algorithms_;
 
+  /// Guards allocated_algorithms_, the load callbacks of the algorithms are executed in parallel.
+  std::mutex allocated_algorithms_mutex_;
+
 }; // AlgorithmManagerServers
 
 } // algorithm_manager namespace
@@ -81,4 +81,23 @@ static bool operator==(const temoto_2::LoadAlgorithm::Request& r1
   // The algorithm infos are equal
   return true;
 }
+
+// Hash of the fields compared by the operator== above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::LoadAlgorithm::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadAlgorithm::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.algorithm_type);
+    hashCombine(seed, r.package_name);
+    hashCombine(seed, r.executable);
+    hashCombineUnordered(seed, r.input_topics);
+    hashCombineUnordered(seed, r.output_topics);
+    return seed;
+  }
+};
+}
 #endif
@@ -20,19 +20,23 @@ public:
 
   AlgorithmSnooper( BaseSubsystem* b, AlgorithmInfoRegistry* sid);
 
-  void advertiseAlgorithm(AlgorithmInfo& si) const;
+  void advertiseAlgorithm(const AlgorithmInfo& si) const;
 
   void advertiseLocalAlgorithms() const;
 
   void startSnooping();
 
+  ~AlgorithmSnooper();
+
   std::vector<AlgorithmInfoPtr> parseAlgorithms(const YAML::Node& config);
 
 private:
 
-  void syncCb(const temoto_2::ConfigSync& msg, const PayloadType& payload);
+  static std::string getSyncKey(const AlgorithmInfo& si);
 
-  void updateMonitoringTimerCb(const ros::TimerEvent &e);
+  static PayloadType getSyncPayload(const AlgorithmInfo& si);
+
+  void syncCb(const temoto_2::ConfigSync& msg, const PayloadType& payload);
 
 
   ros::NodeHandle nh_;
@@ -43,8 +47,6 @@ private:
 
   TTP::TaskManager action_engine_;
 
-  ros::Timer update_monitoring_timer_;
-
 };
 
 } // algorithm_manager namespace
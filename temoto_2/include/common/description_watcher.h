@@ -0,0 +1,310 @@
+#ifndef DESCRIPTION_WATCHER_H
+#define DESCRIPTION_WATCHER_H
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace common
+{
+
+/**
+ * @brief Finds the description files of the packages in a workspace and keeps track of their
+ * changes. The files are looked for in the workspace directory and in its immediate
+ * subdirectories. The parsed files are cached by their path and mtime, so a file is parsed again
+ * only when it has changed. After the initial scan, inotify reports the created, modified and
+ * deleted files. If inotify is not available, the workspace is scanned again on every wait.
+ */
+template <class InfoType>
+class DescriptionWatcher
+{
+public:
+
+  /// Parses a description file, may throw
+  typedef std::function<std::vector<InfoType>(const std::string&)> ParseFunction;
+
+  DescriptionWatcher( const std::string& base_dir
+                    , const std::string& description_file
+                    , const std::vector<std::string>& ignore_dirs
+                    , ParseFunction parse )
+  : base_dir_(base_dir)
+  , description_file_(description_file)
+  , ignore_dirs_(ignore_dirs)
+  , parse_(parse)
+  {
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  }
+
+  ~DescriptionWatcher()
+  {
+    if (inotify_fd_ >= 0)
+    {
+      close(inotify_fd_);
+    }
+  }
+
+  DescriptionWatcher(const DescriptionWatcher&) = delete;
+  DescriptionWatcher& operator=(const DescriptionWatcher&) = delete;
+
+  /**
+   * @brief Scans the workspace, the directories are walked and the files are parsed in parallel.
+   * @return The infos of the files which are new or have changed since they were last parsed.
+   */
+  std::vector<InfoType> scan()
+  {
+    std::vector<std::string> dirs = listDirs();
+    std::vector<InfoType> changed_infos;
+    std::atomic<size_t> next_dir(0);
+
+    auto worker = [&]
+    {
+      std::vector<InfoType> worker_infos;
+      for (size_t i = next_dir++; i < dirs.size(); i = next_dir++)
+      {
+        watchDir(dirs[i]);
+        parseIfChanged(dirs[i] + "/" + description_file_, worker_infos);
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      changed_infos.insert(changed_infos.end(), worker_infos.begin(), worker_infos.end());
+    };
+
+    unsigned int worker_count = std::min<size_t>(std::thread::hardware_concurrency(), dirs.size());
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < worker_count; i++)
+    {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+
+    return changed_infos;
+  }
+
+  /**
+   * @brief Waits until description files are created or modified.
+   * @param timeout_ms Maximum time to wait.
+   * @return The infos of the created and modified files, empty if nothing changed in time.
+   */
+  std::vector<InfoType> waitForChanges(int timeout_ms)
+  {
+    if (inotify_fd_ < 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+      return scan();
+    }
+
+    struct pollfd fd = { inotify_fd_, POLLIN, 0 };
+    if (poll(&fd, 1, timeout_ms) <= 0)
+    {
+      return {};
+    }
+
+    std::set<std::string> changed_files;
+    std::vector<std::string> new_dirs;
+    bool overflow = false;
+
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0)
+    {
+      const struct inotify_event* event;
+      for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + event->len)
+      {
+        event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+        // Some events were lost, only a new scan can tell what has changed
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+          overflow = true;
+          continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto dir_it = watched_dirs_.find(event->wd);
+        if (dir_it == watched_dirs_.end())
+        {
+          continue;
+        }
+
+        // The directory was removed
+        if (event->mask & IN_IGNORED)
+        {
+          watched_dirs_.erase(dir_it);
+          continue;
+        }
+
+        std::string name = (event->len > 0) ? event->name : "";
+
+        // A new package in the workspace
+        if (event->mask & IN_ISDIR)
+        {
+          if (dir_it->second == base_dir_ && (event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+              !isIgnored(name))
+          {
+            new_dirs.push_back(base_dir_ + "/" + name);
+          }
+          continue;
+        }
+
+        if (name != description_file_)
+        {
+          continue;
+        }
+
+        std::string path = dir_it->second + "/" + name;
+        if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+        {
+          cache_.erase(path);
+          changed_files.erase(path);
+        }
+        if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+        {
+          changed_files.insert(path);
+        }
+      }
+    }
+
+    if (overflow)
+    {
+      return scan();
+    }
+
+    // The files of a new package may have been written before it was watched
+    for (const auto& dir : new_dirs)
+    {
+      watchDir(dir);
+      changed_files.insert(dir + "/" + description_file_);
+    }
+
+    std::vector<InfoType> changed_infos;
+    for (const auto& path : changed_files)
+    {
+      parseIfChanged(path, changed_infos);
+    }
+    return changed_infos;
+  }
+
+private:
+
+  struct CachedFile
+  {
+    struct timespec mtime;
+    off_t size;
+  };
+
+  /**
+   * @brief Returns the workspace directory and its subdirectories which are not ignored.
+   */
+  std::vector<std::string> listDirs() const
+  {
+    std::vector<std::string> dirs{ base_dir_ };
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator itr(base_dir_, ec), end_itr; !ec && itr != end_itr;
+         itr.increment(ec))
+    {
+      if (boost::filesystem::is_directory(itr->status()) &&
+          !isIgnored(itr->path().filename().string()))
+      {
+        dirs.push_back(itr->path().string());
+      }
+    }
+    return dirs;
+  }
+
+  bool isIgnored(const std::string& dir) const
+  {
+    return std::find(ignore_dirs_.begin(), ignore_dirs_.end(), dir) != ignore_dirs_.end();
+  }
+
+  void watchDir(const std::string& dir)
+  {
+    if (inotify_fd_ < 0)
+    {
+      return;
+    }
+
+    int wd = inotify_add_watch( inotify_fd_, dir.c_str()
+                              , IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM
+                              | IN_ONLYDIR );
+    if (wd >= 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      watched_dirs_[wd] = dir;
+    }
+  }
+
+  /**
+   * @brief Parses the file if it is not cached with the same mtime and size. A file that fails to
+   * parse is cached as well, so that it is not parsed again until it changes.
+   */
+  void parseIfChanged(const std::string& path, std::vector<InfoType>& changed_infos)
+  {
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cache_.erase(path);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto cache_it = cache_.find(path);
+      if (cache_it != cache_.end() &&
+          cache_it->second.mtime.tv_sec == file_stat.st_mtim.tv_sec &&
+          cache_it->second.mtime.tv_nsec == file_stat.st_mtim.tv_nsec &&
+          cache_it->second.size == file_stat.st_size)
+      {
+        return;
+      }
+      cache_[path] = CachedFile{ file_stat.st_mtim, file_stat.st_size };
+    }
+
+    try
+    {
+      std::vector<InfoType> infos = parse_(path);
+      changed_infos.insert(changed_infos.end(), infos.begin(), infos.end());
+    }
+    catch(...)
+    {
+      // The file is parsed again once it has been fixed
+    }
+  }
+
+  std::string base_dir_;
+  std::string description_file_;
+  std::vector<std::string> ignore_dirs_;
+  ParseFunction parse_;
+
+  int inotify_fd_;
+
+  /// Watched directories by their watch descriptors
+  std::map<int, std::string> watched_dirs_;
+
+  /// Parsed description files by their path
+  std::map<std::string, CachedFile> cache_;
+
+  std::mutex mutex_;
+};
+
+} // common namespace
+
+#endif
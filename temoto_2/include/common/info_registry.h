@@ -0,0 +1,356 @@
+#ifndef INFO_REGISTRY_H
+#define INFO_REGISTRY_H
+
+#include "diagnostic_msgs/KeyValue.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace common
+{
+
+/**
+ * @brief Keeps the info objects of the resources a manager can load, such as sensors or
+ * algorithms, in a local and a remote partition. The infos are indexed by their type and by their
+ * package and executable, so that a lookup only visits the infos which may match. Lookups take a
+ * shared lock and may run concurrently.
+ *
+ * InfoType has to provide getType, getPackageName, getExecutable, getOutputTopics, getReliability,
+ * setAdvertised and operator==.
+ */
+template <class InfoType>
+class InfoRegistry
+{
+public:
+
+  enum class Scope
+  {
+    LOCAL,   ///< Resources of this temoto namespace
+    REMOTE   ///< Resources of other temoto namespaces
+  };
+
+  /// Called with the new state of a local info after it was added or updated
+  typedef std::function<void(const InfoType&)> UpdateCallback;
+
+  /**
+   * @brief Finds the most reliable info of the given type.
+   * @param package_name If not empty, only the infos of this package are considered.
+   * @param executable If not empty, only the infos of this executable are considered.
+   * @param output_topics Topic types (keys) the resource has to provide.
+   */
+  bool find( Scope scope
+           , const std::string& type
+           , const std::string& package_name
+           , const std::string& executable
+           , const std::vector<diagnostic_msgs::KeyValue>& output_topics
+           , InfoType& info_ret ) const
+  {
+    std::shared_lock<std::shared_timed_mutex> guard(read_write_mutex_);
+
+    const InfoEntry* entry =
+        findBest(getSet(scope), type, package_name, executable, output_topics);
+    if (entry)
+    {
+      info_ret = entry->info;
+    }
+    return entry;
+  }
+
+  bool find(Scope scope, const InfoType& info, InfoType& info_ret) const
+  {
+    std::shared_lock<std::shared_timed_mutex> guard(read_write_mutex_);
+
+    const InfoEntry* entry = findEqual(getSet(scope), info);
+    if (entry)
+    {
+      info_ret = entry->info;
+    }
+    return entry;
+  }
+
+  bool find(Scope scope, const InfoType& info) const
+  {
+    std::shared_lock<std::shared_timed_mutex> guard(read_write_mutex_);
+
+    return findEqual(getSet(scope), info);
+  }
+
+  /**
+   * @brief Adds the info, unless an equal one already exists.
+   */
+  bool add(Scope scope, const InfoType& info)
+  {
+    {
+      std::lock_guard<std::shared_timed_mutex> guard(read_write_mutex_);
+
+      InfoSet& infos = getSet(scope);
+      if (findEqual(infos, info))
+      {
+        return false;
+      }
+
+      size_t index = infos.entries.size();
+      infos.entries.emplace_back(info);
+      infos.by_type[info.getType()].push_back(index);
+      infos.by_executable[getExecutableKey(info)].push_back(index);
+    }
+
+    notifyUpdate(scope, info);
+    return true;
+  }
+
+  /**
+   * @brief Replaces the info which is equal to the given one.
+   */
+  bool update(Scope scope, const InfoType& info, bool advertised = false)
+  {
+    InfoType updated_info;
+    {
+      std::lock_guard<std::shared_timed_mutex> guard(read_write_mutex_);
+
+      InfoSet& infos = getSet(scope);
+      const InfoEntry* found_entry = findEqual(infos, info);
+      if (!found_entry)
+      {
+        return false;
+      }
+
+      size_t index = found_entry - infos.entries.data();
+      InfoEntry& entry = infos.entries[index];
+
+      // Move the info to its new type
+      if (entry.info.getType() != info.getType())
+      {
+        auto& old_type_indexes = infos.by_type[entry.info.getType()];
+        old_type_indexes.erase(std::find(old_type_indexes.begin(), old_type_indexes.end(), index));
+        if (old_type_indexes.empty())
+        {
+          infos.by_type.erase(entry.info.getType());
+        }
+        infos.by_type[info.getType()].push_back(index);
+      }
+
+      entry = InfoEntry(info);
+      entry.info.setAdvertised(advertised);
+      updated_info = entry.info;
+    }
+
+    // Marking an info as advertised is not a change that has to be advertised
+    if (!advertised)
+    {
+      notifyUpdate(scope, updated_info);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Returns a copy of the infos, so that it can be used without holding the lock.
+   */
+  std::vector<InfoType> getInfos(Scope scope) const
+  {
+    std::shared_lock<std::shared_timed_mutex> guard(read_write_mutex_);
+
+    const InfoSet& infos = getSet(scope);
+    std::vector<InfoType> info_copies;
+    info_copies.reserve(infos.entries.size());
+    for (const auto& entry : infos.entries)
+    {
+      info_copies.push_back(entry.info);
+    }
+    return info_copies;
+  }
+
+  /**
+   * @brief Sets the callback which is called after a local info is added or updated, replacing
+   * the previous one. The callback is called without holding the lock. Returns once none of the
+   * calls to the previous callback are running anymore, so that the owner of the previous callback
+   * may be destroyed afterwards. Hence it must not be called from within the callback.
+   */
+  void setUpdateCallback(UpdateCallback update_cb)
+  {
+    std::unique_lock<std::mutex> lock(update_cb_mutex_);
+    update_cb_ = update_cb;
+    update_cb_idle_.wait(lock, [this] { return update_cb_calls_ == 0; });
+  }
+
+private:
+
+  /**
+   * @brief An info together with the number of output topics of each type it provides.
+   */
+  struct InfoEntry
+  {
+    InfoEntry(const InfoType& new_info) : info(new_info)
+    {
+      for (const auto& topic : info.getOutputTopics())
+      {
+        output_topic_types[topic.first]++;
+      }
+    }
+
+    InfoType info;
+    std::map<std::string, unsigned int> output_topic_types;
+  };
+
+  /**
+   * @brief The infos of one scope. The infos are never removed, so the indexes refer to them by
+   * their position.
+   */
+  struct InfoSet
+  {
+    std::vector<InfoEntry> entries;
+    std::map<std::string, std::vector<size_t>> by_type;
+    std::map<std::string, std::vector<size_t>> by_executable;  ///< by package and executable
+  };
+
+  const InfoSet& getSet(Scope scope) const
+  {
+    return (scope == Scope::LOCAL) ? local_infos_ : remote_infos_;
+  }
+
+  InfoSet& getSet(Scope scope)
+  {
+    return (scope == Scope::LOCAL) ? local_infos_ : remote_infos_;
+  }
+
+  static std::string getExecutableKey(const InfoType& info)
+  {
+    return info.getPackageName() + "/" + info.getExecutable();
+  }
+
+  // Expects the read_write_mutex_ to be locked by the caller. The returned entry is valid while
+  // the lock is held.
+  const InfoEntry* findBest( const InfoSet& infos
+                           , const std::string& type
+                           , const std::string& package_name
+                           , const std::string& executable
+                           , const std::vector<diagnostic_msgs::KeyValue>& output_topics ) const
+  {
+    // Only the infos of the requested type are looked at
+    const auto type_it = infos.by_type.find(type);
+    if (type_it == infos.by_type.end())
+    {
+      return nullptr;
+    }
+
+    // Count the requested output topic types, each topic of a resource can serve one of them
+    std::map<std::string, unsigned int> requested_topic_types;
+    for (const auto& topic : output_topics)
+    {
+      requested_topic_types[topic.key]++;
+    }
+
+    const InfoEntry* best = nullptr;
+    for (size_t index : type_it->second)
+    {
+      const InfoEntry& entry = infos.entries[index];
+
+      // If package_name or executable is specified, skip all non-matching infos
+      if ((!package_name.empty() && entry.info.getPackageName() != package_name) ||
+          (!executable.empty() && entry.info.getExecutable() != executable))
+      {
+        continue;
+      }
+
+      // The resource has to provide all the requested output topic types
+      bool has_topics = std::all_of(requested_topic_types.begin(), requested_topic_types.end(),
+                                    [&](const std::pair<const std::string, unsigned int>& type)
+                                    {
+                                      const auto it = entry.output_topic_types.find(type.first);
+                                      return it != entry.output_topic_types.end() &&
+                                             it->second >= type.second;
+                                    });
+      if (!has_topics)
+      {
+        continue;
+      }
+
+      if (!best || entry.info.getReliability() > best->info.getReliability())
+      {
+        best = &entry;
+      }
+    }
+
+    return best;
+  }
+
+  // Expects the read_write_mutex_ to be locked by the caller.
+  const InfoEntry* findEqual(const InfoSet& infos, const InfoType& info) const
+  {
+    // Equal infos share the package and the executable
+    const auto executable_it = infos.by_executable.find(getExecutableKey(info));
+    if (executable_it == infos.by_executable.end())
+    {
+      return nullptr;
+    }
+
+    for (size_t index : executable_it->second)
+    {
+      if (infos.entries[index].info == info)
+      {
+        return &infos.entries[index];
+      }
+    }
+    return nullptr;
+  }
+
+  void notifyUpdate(Scope scope, const InfoType& info)
+  {
+    if (scope != Scope::LOCAL)
+    {
+      return;
+    }
+
+    UpdateCallback update_cb;
+    {
+      std::lock_guard<std::mutex> guard(update_cb_mutex_);
+      if (!update_cb_)
+      {
+        return;
+      }
+      update_cb = update_cb_;
+      update_cb_calls_++;
+    }
+
+    try
+    {
+      update_cb(info);
+    }
+    catch (...)
+    {
+      endUpdateCall();
+      throw;
+    }
+    endUpdateCall();
+  }
+
+  void endUpdateCall()
+  {
+    std::lock_guard<std::mutex> guard(update_cb_mutex_);
+    if (--update_cb_calls_ == 0)
+    {
+      update_cb_idle_.notify_all();
+    }
+  }
+
+  InfoSet local_infos_;
+  InfoSet remote_infos_;
+
+  /// Mutex for protecting the info sets from data races
+  mutable std::shared_timed_mutex read_write_mutex_;
+
+  UpdateCallback update_cb_;
+  unsigned int update_cb_calls_ = 0;  ///< Number of update callbacks running at the moment
+  std::mutex update_cb_mutex_;
+  std::condition_variable update_cb_idle_;
+};
+
+} // common namespace
+
+#endif
@@ -105,4 +105,64 @@ static bool operator==(const temoto_2::LoadSpeech::Request& r1,
     }
     return true;
 }
+
+// Hashes of the fields compared by the operators above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::LoadTracker::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadTracker::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.detection_method);
+    return seed;
+  }
+};
+
+template <>
+struct RequestFingerprint<temoto_2::TrackObject::Request>
+{
+  Fingerprint operator()(const temoto_2::TrackObject::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.object_name);
+    return seed;
+  }
+};
+
+template <>
+struct RequestFingerprint<temoto_2::LoadGesture::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadGesture::Request& r) const
+  {
+    Fingerprint seed = 0;
+    for (const auto& specifier : r.gesture_specifiers)
+    {
+      hashCombine(seed, specifier.dev);
+      hashCombine(seed, specifier.type);
+      hashCombine(seed, specifier.package_name);
+      hashCombine(seed, specifier.executable);
+    }
+    return seed;
+  }
+};
+
+template <>
+struct RequestFingerprint<temoto_2::LoadSpeech::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadSpeech::Request& r) const
+  {
+    Fingerprint seed = 0;
+    for (const auto& specifier : r.speech_specifiers)
+    {
+      hashCombine(seed, specifier.dev);
+      hashCombine(seed, specifier.type);
+      hashCombine(seed, specifier.package_name);
+      hashCombine(seed, specifier.executable);
+    }
+    return seed;
+  }
+};
+}
 #endif
@@ -25,4 +25,22 @@ static bool operator==(const temoto_2::LoadRvizPlugin::Request& r1,
 			r1.config == r2.config
 		  );
 }
+
+// Hash of the fields compared by the operator== above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::LoadRvizPlugin::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadRvizPlugin::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.type);
+    hashCombine(seed, r.name);
+    hashCombine(seed, r.topic);
+    hashCombine(seed, r.config);
+    return seed;
+  }
+};
+}
 #endif
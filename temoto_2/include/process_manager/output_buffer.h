@@ -0,0 +1,73 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace process_manager
+{
+
+/**
+ * @brief Bounded ring buffer which keeps the latest output of a process. Appending never
+ * allocates, the oldest bytes are overwritten once the buffer is full.
+ */
+class OutputBuffer
+{
+public:
+  OutputBuffer(size_t capacity) : buffer_(capacity), start_(0), size_(0)
+  {
+  }
+
+  void append(const char* data, size_t count)
+  {
+    if (buffer_.empty())
+    {
+      return;
+    }
+
+    // Only the last capacity bytes of the data can remain in the buffer
+    if (count > buffer_.size())
+    {
+      data += count - buffer_.size();
+      count = buffer_.size();
+    }
+
+    size_t end = (start_ + size_) % buffer_.size();
+    size_t first_part = std::min(count, buffer_.size() - end);
+    std::copy(data, data + first_part, buffer_.begin() + end);
+    std::copy(data + first_part, data + count, buffer_.begin());
+
+    size_ += count;
+    if (size_ > buffer_.size())
+    {
+      start_ = (start_ + size_ - buffer_.size()) % buffer_.size();
+      size_ = buffer_.size();
+    }
+  }
+
+  /**
+   * @brief Returns the latest bytes of the output.
+   * @param max_bytes Maximum number of bytes to return, everything if zero.
+   */
+  std::string tail(size_t max_bytes = 0) const
+  {
+    size_t count = (max_bytes == 0) ? size_ : std::min(max_bytes, size_);
+    std::string output;
+    output.reserve(count);
+    for (size_t i = size_ - count; i < size_; i++)
+    {
+      output += buffer_[(start_ + i) % buffer_.size()];
+    }
+    return output;
+  }
+
+private:
+  std::vector<char> buffer_;
+  size_t start_;
+  size_t size_;
+};
+
+}  // namespace process_manager
+
+#endif
@@ -2,9 +2,15 @@
 #define PROCESS_MANAGER_H
 
 #include "process_manager/process_manager_services.h"
+#include "process_manager/process_monitor.h"
 #include "rmp/resource_manager.h"
 #include <stdio.h> //pid_t TODO: check where pid_t actually is
+#include <atomic>
 #include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 #include <sys/stat.h>
 
 #include "common/base_subsystem.h"
@@ -25,7 +31,19 @@ namespace process_manager
 			void loadCb(temoto_2::LoadProcess::Request &req, temoto_2::LoadProcess::Response &res);
 			void unloadCb(temoto_2::LoadProcess::Request &req, temoto_2::LoadProcess::Response &res);
 
-			void update(const ros::TimerEvent& e);
+      /**
+       * @brief Returns the latest captured output (stdout and stderr) of a process and the topic
+       * where its further output is published.
+       */
+      bool getOutputCb(temoto_2::GetProcessOutput::Request& req,
+                       temoto_2::GetProcessOutput::Response& res);
+
+      /**
+       * @brief Blocks SIGCHLD in the calling thread. Has to be called before any threads are
+       * started (i.e. before ros::init), so that exited children are reported to the supervisor
+       * of the process manager instead of being delivered to an arbitrary thread.
+       */
+      static void blockChildSignals();
 
       const std::string& getName() const
       {
@@ -34,31 +52,100 @@ namespace process_manager
 
     private:
 
+      /**
+       * @brief Resolved program of a request and the arguments which precede the requested ones
+       * (e.g. the launch file for roslaunch).
+       */
+      struct Executable
+      {
+        std::string program;
+        std::vector<std::string> leading_args;
+      };
+
+      /**
+       * @brief Finds the program which has to be executed for the request. The result is cached,
+       * so the file system is searched only on the first request of an executable.
+       */
+      Executable resolveExecutable(const temoto_2::LoadProcess::Request& req);
+
+      /**
+       * @brief Spawns the resolved executable without a shell in between. Returns the pid of the
+       * child.
+       * @param output_fd If given, stdout and stderr of the child are redirected to it.
+       */
+      pid_t spawnProcess(const temoto_2::LoadProcess::Request& req, const Executable& executable,
+                         int output_fd = -1);
+
+      /**
+       * @brief Collects the readiness conditions of the request, with the names resolved.
+       */
+      ReadinessConditions getReadinessConditions(const temoto_2::LoadProcess::Request& req);
+
+      /**
+       * @brief Stops a process which was started but is not going to be unloaded via RMP.
+       */
+      void stopProcess(pid_t pid);
+
+      /**
+       * @brief Topic where the output of the process with the given resource id is published.
+       */
+      std::string getOutputTopic(temoto_id::ID resource_id) const;
+
+      /**
+       * @brief Body of the supervisor thread. Waits for SIGCHLD and reaps the exited children.
+       */
+      void supervise();
+
+      /**
+       * @brief Reaps all exited children and sends a FAILED status for each process which stopped
+       * without being unloaded.
+       */
+      void reapChildren();
+
+      const int SUPERVISOR_FALLBACK_PERIOD_MS = 1000;
+
+      // Seconds to wait for the readiness conditions if the request does not specify it
+      const double DEFAULT_READY_TIMEOUT = 30;
+
+      // Threads serving the load requests. A request with readiness conditions holds its thread
+      // until the conditions are met, so a few slow processes must not block the others.
+      const unsigned int LOAD_THREAD_COUNT = 8;
 
       std::string log_class_, log_subsys_, log_group_;
 
       // TODO: This section should be replaced by a single container which also holds
       // the state of each process.
-      std::vector<temoto_2::LoadProcess> loading_processes_;
       std::map<pid_t, temoto_2::LoadProcess> running_processes_;
       std::map<pid_t, temoto_2::LoadProcess> failed_processes_;
-      std::vector<pid_t> unloading_processes_;
 
-      std::mutex loading_mutex_;
-      std::mutex unloading_mutex_;
-      std::mutex running_mutex_;
+      // Processes which were killed on unload but have not been reaped yet.
+      std::set<pid_t> stopping_processes_;
+
+      std::mutex processes_mutex_;
+
+      std::map<std::string, Executable> executables_;
+      std::mutex executables_mutex_;
+
+      int signal_fd_;
+      int wakeup_fd_;
+      std::atomic<bool> supervising_;
+      std::thread supervisor_thread_;
 
 			ros::NodeHandle nh_;
 
+      ros::ServiceServer get_output_server_;
+
 			// Resource management protocol
 			rmp::ResourceManager<ProcessManager> resource_manager_;
 
+      // Forwards the output of the processes and checks their readiness
+      ProcessMonitor process_monitor_;
+
 			// Listens for calls to start or kill processes
 			//ros::ServiceServer spawn_kill_srv_;
 
 			// Holds clients toi connect and send info to other (Sensor, Context, etc.) managers
 			//ros::ServiceClient resource_status_client_;
-      void waitForLock(std::mutex& m);
       inline bool executableExists (const std::string& name) {
           struct stat buffer;
           return (stat(name.c_str(), &buffer) == 0);
@@ -4,6 +4,7 @@
 #include <string>
 #include "rmp/resource_manager_services.h"
 #include "temoto_2/LoadProcess.h"
+#include "temoto_2/GetProcessOutput.h"
 
 namespace process_manager
 {
@@ -11,6 +12,7 @@ namespace process_manager
 	{
 		const std::string MANAGER = "process_manager";
 		const std::string SERVER = "load_process";
+		const std::string SERVER_GET_OUTPUT = "get_process_output";
 	}
 
   namespace action
@@ -31,8 +33,45 @@ static bool operator==(const temoto_2::LoadProcess::Request& r1,
 			r1.action == r2.action &&
 			r1.package_name == r2.package_name &&
 			r1.executable == r2.executable &&
-			r1.args == r2.args
+			r1.args == r2.args &&
+			r1.ready_topics == r2.ready_topics &&
+			r1.ready_services == r2.ready_services &&
+			r1.ready_params == r2.ready_params &&
+			r1.ready_log_regex == r2.ready_log_regex &&
+			r1.ready_timeout == r2.ready_timeout
 		  );
 }
 
+// Hash of the fields compared by the operator== above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::LoadProcess::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadProcess::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.action);
+    hashCombine(seed, r.package_name);
+    hashCombine(seed, r.executable);
+    hashCombine(seed, r.args);
+    for (const auto& topic : r.ready_topics)
+    {
+      hashCombine(seed, topic);
+    }
+    for (const auto& service : r.ready_services)
+    {
+      hashCombine(seed, service);
+    }
+    for (const auto& param : r.ready_params)
+    {
+      hashCombine(seed, param);
+    }
+    hashCombine(seed, r.ready_log_regex);
+    hashCombine(seed, r.ready_timeout);
+    return seed;
+  }
+};
+}
+
 #endif
@@ -0,0 +1,189 @@
+#ifndef PROCESS_MONITOR_H
+#define PROCESS_MONITOR_H
+
+#include "common/base_subsystem.h"
+#include "process_manager/output_buffer.h"
+
+#include "ros/ros.h"
+
+#include <sys/types.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace process_manager
+{
+
+/**
+ * @brief Conditions which have to be met before a started process is considered ready.
+ */
+struct ReadinessConditions
+{
+  /// Absolute names of the topics which have to be advertised
+  std::vector<std::string> topics;
+
+  /// Absolute names of the services which have to be available
+  std::vector<std::string> services;
+
+  /// Absolute names of the parameters which have to be set
+  std::vector<std::string> params;
+
+  /// Regular expression which has to match a line in the output of the process
+  std::string log_regex;
+
+  /// The process is considered not ready if the conditions are not met by then
+  std::chrono::steady_clock::time_point deadline;
+
+  bool empty() const
+  {
+    return topics.empty() && services.empty() && params.empty() && log_regex.empty();
+  }
+};
+
+/**
+ * @brief State of a pending readiness check, see ProcessMonitor::addReadinessCheck.
+ */
+struct ReadinessCheck
+{
+  pid_t pid;
+  ReadinessConditions conditions;
+  std::regex log_regex;
+  bool log_matched = false;
+  bool done = false;
+  bool ready = false;
+  std::string message;
+};
+
+typedef std::shared_ptr<ReadinessCheck> ReadinessCheckPtr;
+
+/**
+ * @brief Watches the processes started by the process manager in a single event loop. It captures
+ * the output of the processes and decides when they have become ready. The ROS master is queried
+ * once per check period for all pending checks, instead of each waiting caller polling it on its
+ * own.
+ */
+class ProcessMonitor : public BaseSubsystem
+{
+public:
+  /**
+   * @brief Constructor
+   * @param b Pointer to the parent subsystem that embeds this object.
+   */
+  ProcessMonitor(BaseSubsystem* b);
+
+  ~ProcessMonitor();
+
+  /**
+   * @brief Starts capturing the output of a process. The output is kept in a bounded buffer,
+   * published when the publisher has subscribers and forwarded to the output of the process
+   * manager. The monitor takes the ownership of the descriptor and closes it when the process
+   * closes its end.
+   * @param pid Process which writes to the descriptor.
+   * @param fd Read end of the output pipe of the process.
+   * @param publisher Publisher of the output stream of the process.
+   */
+  void watchOutput(pid_t pid, int fd, ros::Publisher publisher);
+
+  /**
+   * @brief Gets the latest captured output of a process.
+   * @param max_bytes Maximum number of bytes to return, everything if zero.
+   * @return False if the output of the process is not captured.
+   */
+  bool getOutput(pid_t pid, size_t max_bytes, std::string& output, std::string& topic);
+
+  /**
+   * @brief Drops the captured output of a process, called once the process is unloaded.
+   */
+  void forgetOutput(pid_t pid);
+
+  /**
+   * @brief Starts checking the readiness of a process. Has to be called before the exit of the
+   * process can be reported via processExited, otherwise the check runs until its deadline.
+   */
+  ReadinessCheckPtr addReadinessCheck(pid_t pid, const ReadinessConditions& conditions);
+
+  /**
+   * @brief Blocks until the check is completed.
+   * @return True if the process became ready, otherwise the reason is in check->message.
+   */
+  bool waitUntilReady(const ReadinessCheckPtr& check);
+
+  /**
+   * @brief Fails the pending readiness checks of an exited process.
+   */
+  void processExited(pid_t pid);
+
+private:
+  struct OutputStream
+  {
+    pid_t pid;
+    std::string partial_line;
+  };
+
+  struct ProcessOutput
+  {
+    ProcessOutput(ros::Publisher publisher) : buffer(OUTPUT_BUFFER_SIZE), publisher(publisher)
+    {
+    }
+
+    OutputBuffer buffer;
+    ros::Publisher publisher;
+  };
+
+  void run();
+
+  void wakeUp();
+
+  /**
+   * @brief Reads the available output of the process. Returns false when the process has closed
+   * its end of the pipe.
+   */
+  bool readOutput(int fd, OutputStream& stream);
+
+  void matchLogLine(pid_t pid, const std::string& line);
+
+  /**
+   * @brief Evaluates the pending checks and completes the ones which are ready or past their
+   * deadline.
+   */
+  void checkReadiness();
+
+  void complete(const ReadinessCheckPtr& check, bool ready, const std::string& message);
+
+  /**
+   * @brief Returns the names of all services known to the ROS master.
+   */
+  std::set<std::string> getServices();
+
+  const std::chrono::milliseconds CHECK_PERIOD = std::chrono::milliseconds(100);
+
+  // Bytes of output kept for each process
+  static const size_t OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+  // Open output pipes by their descriptors
+  std::map<int, OutputStream> output_streams_;
+
+  // Captured output by the pid of the process. Outlives the pipe, so that the output of a failed
+  // process can be inspected until it is unloaded.
+  std::map<pid_t, ProcessOutput> outputs_;
+
+  std::vector<ReadinessCheckPtr> checks_;
+  std::mutex monitor_mutex_;
+  std::condition_variable check_done_cv_;
+
+  int wakeup_fd_;
+  std::atomic<bool> running_;
+  std::thread monitor_thread_;
+};
+
+}  // namespace process_manager
+
+#endif
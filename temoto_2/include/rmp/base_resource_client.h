@@ -2,6 +2,7 @@
 #define BASE_RESOURCE_CLIENT_H
 
 #include <string>
+#include <vector>
 #include "common/temoto_id.h"
 #include "common/base_subsystem.h"
 #include "rmp/resource_manager.h"
@@ -20,7 +21,7 @@ class BaseResourceClient : public BaseSubsystem
 {
 	public:
     BaseResourceClient(ResourceManager<Owner>& resource_manager)
-      : BaseSubsystem(resource_manager), resource_manager_(resource_manager)
+      : BaseSubsystem(resource_manager), resource_manager_(resource_manager), pending_calls_(0)
     {
     }
         
@@ -37,14 +38,32 @@ class BaseResourceClient : public BaseSubsystem
     virtual void setFailedFlag(temoto_id::ID external_resource_id) = 0;
     virtual bool hasFailed(temoto_id::ID internal_resource_id) = 0;
     virtual void unloadResources() = 0;
+    virtual void unloadResources(const std::vector<temoto_id::ID>& resource_ids) = 0;
     virtual bool internalResourceExists(temoto_id::ID) = 0;
     virtual std::string toString() = 0;
 
+    // Calls which are waiting for a response of the server. A client with pending calls is kept
+    // even when it has no queries. Expects the clients of the resource manager to be locked.
+    void beginCall()
+    {
+      pending_calls_++;
+    }
+
+    void endCall()
+    {
+      pending_calls_--;
+    }
+
+    bool isIdle() const
+    {
+      return pending_calls_ == 0 && getQueryCount() <= 0;
+    }
+
   protected:
 		ResourceManager<Owner>& resource_manager_;
         
 	private:
-
+    size_t pending_calls_;
 };
 
 template <class Owner>
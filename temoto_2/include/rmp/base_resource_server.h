@@ -6,8 +6,10 @@
 #include "common/temoto_id.h"
 #include "common/base_subsystem.h"
 #include "rmp/resource_manager.h"
+#include "temoto_2/RMPResponse.h"
 #include <vector>
 #include <utility>
+#include <future>
 
 namespace rmp
 {
@@ -16,6 +18,22 @@ namespace rmp
 template<class Owner>
 class ResourceManager;
 
+template<class Owner>
+class BaseResourceServer;
+
+/**
+ * @brief Describes the load callback that a thread is executing. Client calls made from within
+ * the callback are linked to the query of that callback, which lets independent load callbacks of
+ * the same server run in parallel.
+ */
+template<class Owner>
+struct LoadContext
+{
+  const ResourceManager<Owner>* resource_manager = nullptr;
+  BaseResourceServer<Owner>* server = nullptr;
+  temoto_id::ID query_id = temoto_id::UNASSIGNED_ID;
+};
+
 template<class Owner>
 class BaseResourceServer : public BaseSubsystem
 {
@@ -43,36 +61,75 @@ class BaseResourceServer : public BaseSubsystem
 			return name_;
 		};
 
-		virtual void linkInternalResource(temoto_id::ID resource_id) = 0;
+		virtual void linkInternalResource(temoto_id::ID query_id, temoto_id::ID resource_id) = 0;
 		virtual void unlinkInternalResource(temoto_id::ID resource_id) = 0;
 		virtual bool isLinkedTo(temoto_id::ID resource_id) const = 0;
 		virtual bool hasInternalResource(temoto_id::ID resource_id) const = 0;
 		virtual bool hasExternalResource(temoto_id::ID resource_id) const = 0;
+		virtual bool isLoading(temoto_id::ID resource_id) const = 0;
 		virtual void unloadResource(temoto_2::UnloadResource::Request& req, temoto_2::UnloadResource::Response& res) = 0;
+
+    /**
+     * @brief Loads a resource from a serialized request, as the requests of a batch are carried
+     * without their type. The load is queued to the load threads of the server, so that the owner's
+     * callbacks never run on more threads than the server was given. The future holds the rmp part
+     * of the response, the whole response is serialized into serialized_res. Both arguments have
+     * to outlive the future.
+     */
+    virtual std::future<temoto_2::RMPResponse>
+    loadSerialized(const std::vector<uint8_t>& serialized_req,
+                   std::vector<uint8_t>& serialized_res) = 0;
+
     virtual std::vector<std::pair<temoto_id::ID, std::string>>
     getExternalResourcesByInternalId(temoto_id::ID internal_resource_id) = 0;
     virtual std::vector<std::pair<temoto_id::ID, std::string>>
     getExternalResourcesByExternalId(temoto_id::ID external_resource_id) = 0;
 
-  protected:
+    /**
+     * @brief Returns the load context of the calling thread. The context is empty when the thread
+     * is not executing a load callback of any server.
+     */
+    static const LoadContext<Owner>& getLoadContext()
+    {
+      return load_context_;
+    }
 
-		void activateServer()
-		{
-			resource_manager_.setActiveServer(this);
-		};
+  protected:
 
-		void deactivateServer()
-		{
-			resource_manager_.setActiveServer(NULL);
-		};
+    /**
+     * @brief Sets the load context of the calling thread for the lifetime of the guard.
+     */
+    class LoadContextGuard
+    {
+    public:
+      LoadContextGuard(BaseResourceServer<Owner>* server, temoto_id::ID query_id)
+        : previous_context_(load_context_)
+      {
+        load_context_.resource_manager = &server->resource_manager_;
+        load_context_.server = server;
+        load_context_.query_id = query_id;
+      }
+
+      ~LoadContextGuard()
+      {
+        load_context_ = previous_context_;
+      }
+
+    private:
+      LoadContext<Owner> previous_context_;
+    };
 
 		ResourceManager<Owner>& resource_manager_;
 		std::string name_;
 
 
 	private:
+    static thread_local LoadContext<Owner> load_context_;
 };
 
+template<class Owner>
+thread_local LoadContext<Owner> BaseResourceServer<Owner>::load_context_;
+
 }
 
 
@@ -6,6 +6,7 @@
 #include <map>
 #include <utility>
 #include "common/temoto_id.h"
+#include "rmp/request_fingerprint.h"
 
 namespace rmp
 {
@@ -24,7 +25,11 @@ class ClientQuery : public BaseSubsystem
 public:
   // special constructor for resource client
   ClientQuery(const ServiceMsgType& msg, Owner* owner)
-    : BaseSubsystem(*owner, __func__), msg_(msg), owner_(owner), failed_(false)
+    : BaseSubsystem(*owner, __func__)
+    , msg_(msg)
+    , owner_(owner)
+    , failed_(false)
+    , fingerprint_(rmp::fingerprint(msg.request))
   {
     this->log_group_ = "rmp." + this->log_group_;
   }
@@ -67,6 +72,11 @@ public:
     return msg_;
   }
 
+  Fingerprint getFingerprint() const
+  {
+    return fingerprint_;
+  }
+
   const temoto_id::ID getExternalId() const
   {
     return msg_.response.rmp.resource_id;
@@ -113,6 +123,8 @@ private:
   ServiceMsgType msg_;  /// Store request and response, note that RMP specific fields (resource_id,
                         /// topic, ...) are related to first query and are not intended to be used
                         /// herein.
+
+  Fingerprint fingerprint_;  /// Hash of the request part, used by the client for indexing.
 };
 }
 
@@ -5,8 +5,15 @@
 #include <ros/serialization.h>
 #include "common/base_subsystem.h"
 #include "common/temoto_log_macros.h"
+#include "rmp/message_serialization.h"
+#include <boost/make_shared.hpp>
 #include <string>
 #include <sstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
 #include "temoto_2/ConfigSync.h"
 
 namespace ser = ros::serialization;
@@ -20,9 +27,24 @@ const std::string ADVERTISE_CONFIG = "advertise_config";
 const std::string ADD_CONFIG = "add_config";
 const std::string REMOVE_CONFIG = "remove_config";
 const std::string REQUEST_CONFIG = "request_config";
+const std::string UPDATE_CONFIG = "update_config";
+const std::string SNAPSHOT_CONFIG = "snapshot_config";
 }
 
+// Version of the ConfigSync message layout, messages of other versions are ignored
+const uint8_t SYNC_PROTOCOL_VERSION = 1;
 
+/**
+ * @brief Synchronizes configurations between the instances of temoto.
+ *
+ * The configuration of a namespace may be kept as entries, see advertiseEntry. Only the changed
+ * entries are sent, each change gets the next sequence number of the sender. A receiver applies
+ * the changes in place and notifies the owner only about the changed entries. When it detects a
+ * gap in the sequence numbers, it asks the sender for a snapshot of all its entries. Instances
+ * which start later get the snapshot when they subscribe to the sync topic.
+ *
+ * Configurations which are not kept as entries are sent as a whole with advertise.
+ */
 template <class Owner, class PayloadType>
 class ConfigSynchronizer : public BaseSubsystem
 {
@@ -38,44 +60,16 @@ public:
     , sync_cb_(sync_cb)
     , owner_(owner)
     , BaseSubsystem(*owner, __func__)
+    , session_(std::random_device()())
+    , sequence_(0)
+    , remote_configs_requested_(false)
   {
-    // Setup publisher and subscriber
-    sync_pub_ = nh_.advertise<temoto_2::ConfigSync>(sync_topic, 1000);
+    // Setup publisher and subscriber. The constructor does not wait for the other instances,
+    // whoever connects later is brought up to date by subscriberConnectedCb.
+    sync_pub_ = nh_.advertise<temoto_2::ConfigSync>(
+        sync_topic, 1000, boost::bind(&ConfigSynchronizer::subscriberConnectedCb, this, _1));
     sync_sub_ = nh_.subscribe(sync_topic, 1000, &ConfigSynchronizer::wrappedSyncCb, this);
 
-    // Ask from master how many nodes have subscribed to sync_topic
-    // Wait until all connections are established.
-    int total_connections = 0;
-    int active_connections = 0;
-    while (true)
-    {
-      XmlRpc::XmlRpcValue args, result, payload;
-      args[0] = ros::this_node::getName();
-      ros::S_string node_set;
-      if (ros::master::execute("getSystemState", args, result, payload, true))
-      {
-        for (int i = 0; i < payload.size(); ++i)
-        {
-          for (int j = 0; j < payload[i].size(); ++j)
-          {
-            std::string topic = payload[i][j][0];
-            XmlRpc::XmlRpcValue nodes = payload[i][j][1];
-            if (topic == sync_topic_)
-            {
-              total_connections = nodes.size();
-            }
-          }
-        }
-      }
-      active_connections = sync_pub_.getNumSubscribers();
-      TEMOTO_DEBUG("Waiting for subscribers: %d/%d", active_connections, total_connections);
-      if (active_connections == total_connections)
-      {
-        break;
-      }
-      ros::Duration(0.1).sleep();
-    }
-
     TEMOTO_INFO("ConfigSynchronizer created.");
   }
 
@@ -90,10 +84,11 @@ public:
    */
   void requestRemoteConfigs()
   {
-    temoto_2::ConfigSync msg;
-    msg.temoto_namespace = common::getTemotoNamespace();
-    msg.action = sync_action::REQUEST_CONFIG;
-    sync_pub_.publish(msg);
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      remote_configs_requested_ = true;
+    }
+    requestSnapshot("");
   }
 
   /**
@@ -104,66 +99,381 @@ public:
   {
     try
     {
-      temoto_2::ConfigSync msg;
-      msg.temoto_namespace = common::getTemotoNamespace();
-      msg.action = sync_action;
+      temoto_2::ConfigSync::Ptr msg = boost::make_shared<temoto_2::ConfigSync>();
+      msg->version = SYNC_PROTOCOL_VERSION;
+      msg->temoto_namespace = common::getTemotoNamespace();
+      msg->action = sync_action;
 
-      // Serialize the payload
-      uint32_t payload_size = ros::serialization::serializationLength(payload);
-      boost::shared_array<uint8_t> buffer(new uint8_t[payload_size]);
-      ser::OStream stream(buffer.get(), payload_size);
-      ser::serialize(stream, payload);
+      // Serialize the payload straight into the message. The message is published by pointer,
+      // so that it is not copied again for the subscribers in the same process.
+      serializeMessage(payload, msg->payload);
+      sync_pub_.publish(msg);
+    }
 
-      // Create a byte array
-      std::vector<uint8_t> payload_byte_array;
+    catch (...)
+    {
+      TEMOTO_ERROR("Siit lendas laiali @ advertise");
+    }
 
-      // Fill out the byte array
-      for (uint32_t i=0; i<payload_size; i++)
+  }
+
+  /**
+   * @brief Advertises an entry of the local configuration. Nothing is sent when the entry is
+   * unchanged since it was last advertised.
+   * @param key Identifies the entry within the local configuration.
+   */
+  void advertiseEntry(const std::string& key, const PayloadType& payload) const
+  {
+    advertiseEntries({ std::make_pair(key, payload) });
+  }
+
+  /**
+   * @brief Advertises several entries of the local configuration in a single message, only the
+   * entries which have changed since they were last advertised are sent.
+   */
+  void advertiseEntries(const std::vector<std::pair<std::string, PayloadType>>& entries) const
+  {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    temoto_2::ConfigSync msg = createEntryMsg(sync_action::UPDATE_CONFIG);
+    for (const auto& entry : entries)
+    {
+      temoto_2::ConfigSyncEntry entry_msg;
+      entry_msg.key = entry.first;
+      entry_msg.payload = serializeMessage(entry.second);
+
+      auto local_it = local_entries_.find(entry.first);
+      if (local_it != local_entries_.end() && local_it->second.payload == entry_msg.payload)
       {
-        payload_byte_array.push_back(buffer.get()[i]);
+        continue;
       }
-
-      msg.payload = payload_byte_array;
-      sync_pub_.publish(msg);
+      msg.entries.push_back(entry_msg);
     }
 
-    catch (...)
+    publishChanges(msg);
+  }
+
+  /**
+   * @brief Removes an entry from the local configuration of all the receivers.
+   */
+  void removeEntry(const std::string& key) const
+  {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    if (local_entries_.find(key) == local_entries_.end())
     {
-      TEMOTO_ERROR("Siit lendas laiali @ advertise");
+      return;
     }
 
+    temoto_2::ConfigSync msg = createEntryMsg(sync_action::UPDATE_CONFIG);
+    temoto_2::ConfigSyncEntry entry_msg;
+    entry_msg.key = key;
+    entry_msg.removed = true;
+    msg.entries.push_back(entry_msg);
+    publishChanges(msg);
   }
 
 private:
 
-  void wrappedSyncCb(const temoto_2::ConfigSync& msg)
+  // Expects the sync_mutex_ to be locked by the caller.
+  temoto_2::ConfigSync createEntryMsg(const std::string& action) const
+  {
+    temoto_2::ConfigSync msg;
+    msg.version = SYNC_PROTOCOL_VERSION;
+    msg.temoto_namespace = common::getTemotoNamespace();
+    msg.action = action;
+    msg.session = session_;
+    msg.sequence = sequence_;
+    return msg;
+  }
+
+  // Gives the changes of the message the next sequence number, applies them to the local entries
+  // and publishes them. Expects the sync_mutex_ to be locked by the caller.
+  void publishChanges(temoto_2::ConfigSync& msg) const
+  {
+    if (msg.entries.empty())
+    {
+      return;
+    }
+
+    msg.sequence = ++sequence_;
+    for (auto& entry_msg : msg.entries)
+    {
+      entry_msg.sequence = msg.sequence;
+      if (entry_msg.removed)
+      {
+        local_entries_.erase(entry_msg.key);
+      }
+      else
+      {
+        local_entries_[entry_msg.key] = entry_msg;
+      }
+    }
+    sync_pub_.publish(msg);
+  }
+
+  void publishSnapshot(const std::string& target_namespace) const
+  {
+    temoto_2::ConfigSync msg;
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      if (!createSnapshotMsg(target_namespace, msg))
+      {
+        return;
+      }
+    }
+    sync_pub_.publish(msg);
+  }
+
+  // Returns false if nothing has been advertised as entries. Expects the sync_mutex_ to be locked
+  // by the caller.
+  bool createSnapshotMsg(const std::string& target_namespace, temoto_2::ConfigSync& msg) const
+  {
+    if (sequence_ == 0)
+    {
+      return false;
+    }
+
+    msg = createEntryMsg(sync_action::SNAPSHOT_CONFIG);
+    msg.target_namespace = target_namespace;
+    for (const auto& local_entry : local_entries_)
+    {
+      msg.entries.push_back(local_entry.second);
+    }
+    return true;
+  }
+
+  temoto_2::ConfigSync createRequestMsg(const std::string& target_namespace) const
+  {
+    temoto_2::ConfigSync msg;
+    msg.version = SYNC_PROTOCOL_VERSION;
+    msg.temoto_namespace = common::getTemotoNamespace();
+    msg.target_namespace = target_namespace;
+    msg.action = sync_action::REQUEST_CONFIG;
+    return msg;
+  }
+
+  // Asks the given namespace, or everyone if empty, for a snapshot of their entries.
+  void requestSnapshot(const std::string& target_namespace)
+  {
+    sync_pub_.publish(createRequestMsg(target_namespace));
+  }
+
+  /**
+   * @brief Called by ROS when an instance, which may have started after this one, connects to the
+   * sync topic. Only the new subscriber gets the snapshot of the local entries and, if the remote
+   * configs were requested, a repeated request, as it may have missed the original one.
+   */
+  void subscriberConnectedCb(const ros::SingleSubscriberPublisher& subscriber)
+  {
+    temoto_2::ConfigSync snapshot_msg;
+    bool has_snapshot;
+    bool requested;
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      has_snapshot = createSnapshotMsg("", snapshot_msg);
+      requested = remote_configs_requested_;
+    }
+
+    TEMOTO_DEBUG("'%s' subscribed to '%s'.", subscriber.getSubscriberName().c_str(),
+                 sync_topic_.c_str());
+    if (has_snapshot)
+    {
+      subscriber.publish(snapshot_msg);
+    }
+    if (requested)
+    {
+      subscriber.publish(createRequestMsg(""));
+    }
+  }
+
+  // State of the entries received from a remote namespace
+  struct RemoteState
+  {
+    uint32_t session = 0;
+    uint64_t sequence = 0;
+    bool synchronized = false;
+    ros::Time snapshot_requested;
+    std::map<std::string, uint64_t> entry_sequences;  ///< entry key -> sequence of its last change
+  };
+
+  /**
+   * @brief Applies the entries of an update or a snapshot and forwards the changed ones to the
+   * owner, one entry at a time. A snapshot also removes the entries which it does not contain.
+   */
+  void applyEntries(const temoto_2::ConfigSync& msg)
   {
-    // Ignore messages that are ours
-    if (msg.temoto_namespace == common::getTemotoNamespace())
+    std::vector<const temoto_2::ConfigSyncEntry*> changed_entries;
+    std::vector<std::string> removed_keys;
     {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      RemoteState& remote = remote_states_[msg.temoto_namespace];
+      bool is_snapshot = msg.action == sync_action::SNAPSHOT_CONFIG;
+
+      if (!is_snapshot)
+      {
+        // Updates are applied only on top of a known state of the same session
+        if (remote.synchronized && remote.session == msg.session &&
+            msg.sequence <= remote.sequence)
+        {
+          return;  // already applied
+        }
+
+        if (!remote.synchronized || remote.session != msg.session ||
+            msg.sequence != remote.sequence + 1)
+        {
+          remote.synchronized = false;
+          if (remote.snapshot_requested.isZero() ||
+              ros::Time::now() > remote.snapshot_requested + ros::Duration(SNAPSHOT_RETRY_PERIOD))
+          {
+            TEMOTO_DEBUG("Missing changes from '%s', requesting a snapshot.",
+                         msg.temoto_namespace.c_str());
+            remote.snapshot_requested = ros::Time::now();
+            requestSnapshot(msg.temoto_namespace);
+          }
+          return;
+        }
+      }
+      else if (remote.synchronized && remote.session == msg.session &&
+               msg.sequence <= remote.sequence)
+      {
+        return;  // nothing new in this snapshot
+      }
+
+      if (remote.session != msg.session)
+      {
+        // The sender has restarted, its sequence numbers have started over
+        remote.entry_sequences.clear();
+        remote.session = msg.session;
+      }
+
+      std::map<std::string, uint64_t> snapshot_sequences;
+      for (const auto& entry_msg : msg.entries)
+      {
+        auto seq_it = remote.entry_sequences.find(entry_msg.key);
+        bool is_known = seq_it != remote.entry_sequences.end();
+        if (entry_msg.removed)
+        {
+          if (is_known)
+          {
+            remote.entry_sequences.erase(seq_it);
+            removed_keys.push_back(entry_msg.key);
+          }
+          continue;
+        }
+
+        snapshot_sequences[entry_msg.key] = entry_msg.sequence;
+        if (!is_known || seq_it->second != entry_msg.sequence)
+        {
+          remote.entry_sequences[entry_msg.key] = entry_msg.sequence;
+          changed_entries.push_back(&entry_msg);
+        }
+      }
+
+      if (is_snapshot)
+      {
+        for (auto seq_it = remote.entry_sequences.begin(); seq_it != remote.entry_sequences.end();)
+        {
+          if (snapshot_sequences.find(seq_it->first) == snapshot_sequences.end())
+          {
+            removed_keys.push_back(seq_it->first);
+            seq_it = remote.entry_sequences.erase(seq_it);
+          }
+          else
+          {
+            ++seq_it;
+          }
+        }
+      }
+
+      remote.sequence = msg.sequence;
+      remote.synchronized = true;
+    }
+
+    // The owner is called without holding the lock, so that it can advertise from the callback
+    temoto_2::ConfigSync entry_header;
+    entry_header.version = msg.version;
+    entry_header.temoto_namespace = msg.temoto_namespace;
+    entry_header.session = msg.session;
+
+    for (const auto* entry_msg : changed_entries)
+    {
+      PayloadType payload;
+      try
+      {
+        deserializeMessage(entry_msg->payload, payload);
+      }
+      catch (std::exception& e)
+      {
+        TEMOTO_WARN("Unable to deserialize entry '%s' from '%s': %s", entry_msg->key.c_str(),
+                    msg.temoto_namespace.c_str(), e.what());
+        continue;
+      }
+      entry_header.action = sync_action::ADVERTISE_CONFIG;
+      entry_header.sequence = entry_msg->sequence;
+      callOwner(entry_header, payload);
+    }
+
+    for (const auto& key : removed_keys)
+    {
+      TEMOTO_DEBUG("Entry '%s' was removed from '%s'.", key.c_str(), msg.temoto_namespace.c_str());
+      entry_header.action = sync_action::REMOVE_CONFIG;
+      entry_header.sequence = msg.sequence;
+      callOwner(entry_header, PayloadType());
+    }
+  }
+
+  // A failing entry does not stop the rest of the entries from being applied
+  void callOwner(const temoto_2::ConfigSync& msg, const PayloadType& payload)
+  {
+    try
+    {
+      (owner_->*sync_cb_)(msg, payload);
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      SEND_ERROR(FORWARD_ERROR(error_stack));
+    }
+  }
+
+  void wrappedSyncCb(const temoto_2::ConfigSync::ConstPtr& msg_ptr)
+  {
+    const temoto_2::ConfigSync& msg = *msg_ptr;
+
+    // Ignore messages that are ours or addressed to someone else
+    if (msg.temoto_namespace == common::getTemotoNamespace() ||
+        (!msg.target_namespace.empty() && msg.target_namespace != common::getTemotoNamespace()))
+    {
+      return;
+    }
+
+    if (msg.version != SYNC_PROTOCOL_VERSION)
+    {
+      TEMOTO_WARN("Ignoring a message of sync protocol version %d from '%s'.", msg.version,
+                  msg.temoto_namespace.c_str());
       return;
     }
 
     try
     {
+      if (msg.action == sync_action::UPDATE_CONFIG || msg.action == sync_action::SNAPSHOT_CONFIG)
+      {
+        applyEntries(msg);
+        return;
+      }
+
+      // Answer with the local entries, if there are any. The request is also forwarded to the
+      // owner, which may advertise configurations that are not kept as entries.
+      if (msg.action == sync_action::REQUEST_CONFIG)
+      {
+        publishSnapshot(msg.temoto_namespace);
+      }
+
       // Create empty payload msg
       PayloadType payload;
 
       // Deserialize the payload if the action type is ADVERTISE
       if (msg.action == sync_action::ADVERTISE_CONFIG)
       {
-        uint32_t payload_size = msg.payload.size();
-        boost::shared_array<uint8_t> buffer(new uint8_t[payload_size]);
-
-        // Fill buffer with the serialized payload
-        for (uint32_t i=0; i<payload_size; i++)
-        {
-          (buffer.get())[i] = msg.payload[i];
-        }
-
-        // Convert the serialized payload to msg
-        ser::IStream stream(buffer.get(), payload_size);
-        ser::deserialize(stream, payload);
+        deserializeMessage(msg.payload.data(), msg.payload.size(), payload);
       }
 
       (owner_->*sync_cb_)(msg, payload);
@@ -174,11 +484,21 @@ private:
     }
   }
 
+  // Seconds to wait for a requested snapshot before asking again
+  const double SNAPSHOT_RETRY_PERIOD = 1.0;
+
   std::string name_;
   std::string sync_topic_;
   OwnerCbType sync_cb_;
   Owner* owner_;
 
+  const uint32_t session_;
+  mutable uint64_t sequence_;  ///< sequence number of the last local change
+  mutable std::map<std::string, temoto_2::ConfigSyncEntry> local_entries_;  ///< by entry key
+  std::map<std::string, RemoteState> remote_states_;  ///< by temoto namespace
+  bool remote_configs_requested_;
+  mutable std::mutex sync_mutex_;
+
   ros::NodeHandle nh_;
   ros::Publisher sync_pub_;
   ros::Subscriber sync_sub_;
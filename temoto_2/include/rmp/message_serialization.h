@@ -0,0 +1,58 @@
+#ifndef MESSAGE_SERIALIZATION_H
+#define MESSAGE_SERIALIZATION_H
+
+#include <ros/serialization.h>
+#include <cstdint>
+#include <vector>
+
+namespace rmp
+{
+/**
+ * @brief Serializes a ROS message into the given byte array, so that a message carried inside
+ * another message can be written straight into the buffer of the outer message.
+ */
+template <class MsgType>
+void serializeMessage(const MsgType& msg, std::vector<uint8_t>& buffer)
+{
+  uint32_t size = ros::serialization::serializationLength(msg);
+  buffer.resize(size);
+  ros::serialization::OStream stream(buffer.data(), size);
+  ros::serialization::serialize(stream, msg);
+}
+
+/**
+ * @brief Serializes a ROS message into a byte array, so that messages of any type can be carried
+ * inside another message.
+ */
+template <class MsgType>
+std::vector<uint8_t> serializeMessage(const MsgType& msg)
+{
+  std::vector<uint8_t> buffer;
+  serializeMessage(msg, buffer);
+  return buffer;
+}
+
+/**
+ * @brief Deserializes a ROS message straight from a serialized byte range. Throws
+ * ros::serialization::StreamOverrunException if the range is too short for the message.
+ */
+template <class MsgType>
+void deserializeMessage(const uint8_t* data, uint32_t size, MsgType& msg)
+{
+  // The stream only reads from the data, it just is not const-qualified
+  ros::serialization::IStream stream(const_cast<uint8_t*>(data), size);
+  ros::serialization::deserialize(stream, msg);
+}
+
+/**
+ * @brief Deserializes a ROS message from a byte array created by serializeMessage. Throws
+ * ros::serialization::StreamOverrunException if the array is too short for the message.
+ */
+template <class MsgType>
+void deserializeMessage(const std::vector<uint8_t>& buffer, MsgType& msg)
+{
+  deserializeMessage(buffer.data(), buffer.size(), msg);
+}
+}  // namespace rmp
+
+#endif
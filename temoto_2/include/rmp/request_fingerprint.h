@@ -0,0 +1,60 @@
+#ifndef REQUEST_FINGERPRINT_H
+#define REQUEST_FINGERPRINT_H
+
+#include <cstddef>
+#include <functional>
+
+namespace rmp
+{
+typedef std::size_t Fingerprint;
+
+template <class T>
+inline void hashCombine(Fingerprint& seed, const T& value)
+{
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * @brief Combines a list of diagnostic_msgs/KeyValue pairs regardless of their order, the same way
+ * the operator== of the requests compare topic lists.
+ */
+template <class KeyValueArray>
+inline void hashCombineUnordered(Fingerprint& seed, const KeyValueArray& key_values)
+{
+  Fingerprint sum = 0;
+  for (const auto& key_value : key_values)
+  {
+    Fingerprint element = 0;
+    hashCombine(element, key_value.key);
+    hashCombine(element, key_value.value);
+    sum += element;
+  }
+  hashCombine(seed, sum);
+}
+
+/**
+ * @brief Hash of a resource request. Resource servers and clients use it for indexing their
+ * queries, so that an equal request can be found without comparing it against every stored
+ * request. A specialization has to agree with the operator== of the request (equal requests give
+ * equal fingerprints) and a matching fingerprint is always confirmed with operator==.
+ *
+ * The default puts every request into the same bucket, which is correct but falls back to a
+ * linear search. The services used over RMP specialize it next to their operator==.
+ */
+template <class RequestType>
+struct RequestFingerprint
+{
+  Fingerprint operator()(const RequestType&) const
+  {
+    return 0;
+  }
+};
+
+template <class RequestType>
+inline Fingerprint fingerprint(const RequestType& req)
+{
+  return RequestFingerprint<RequestType>()(req);
+}
+}
+
+#endif
@@ -4,8 +4,14 @@
 #include "common/temoto_id.h"
 #include "rmp/base_resource_client.h"
 #include "rmp/client_query.h"
+#include "rmp/message_serialization.h"
 #include <string>
 #include <map>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
 
 namespace rmp
 {
@@ -16,6 +22,8 @@ template <class ServiceType, class Owner>
 class ResourceClient : public BaseResourceClient<Owner>
 {
 public:
+  typedef std::unordered_map<temoto_id::ID, ClientQuery<ServiceType, Owner>> QueryMap;
+
   ResourceClient(std::string ext_temoto_namespace, std::string ext_resource_manager_name,
                  std::string ext_server_name, Owner* owner,
                  ResourceManager<Owner>& resource_manager)
@@ -29,12 +37,14 @@ public:
 
     // Set client name where it is connecting to.
     name_ = '/' + ext_temoto_namespace + '/' + ext_resource_manager_name + "/" + ext_server_name;
-    std::string load_srv_name = name_;
-    std::string unload_name = '/' + ext_temoto_namespace + '/' + ext_resource_manager_name + "/unload";
-
-    // Setup ROS service clients for loading and unloading the resource
-    service_client_ = nh_.serviceClient<ServiceType>(load_srv_name);
-    service_client_unload_ = nh_.serviceClient<temoto_2::UnloadResource>(unload_name);
+    std::string rm_srv_prefix = '/' + ext_temoto_namespace + '/' + ext_resource_manager_name;
+
+    // Services for loading and unloading the resource, the connections to them are pooled by the
+    // resource manager
+    load_srv_name_ = name_;
+    unload_srv_name_ = rm_srv_prefix + "/unload";
+    load_batch_srv_name_ = rm_srv_prefix + "/load_batch";
+    unload_batch_srv_name_ = rm_srv_prefix + "/unload_batch";
     TEMOTO_DEBUG("Created ResourceClient %s", name_.c_str());
   }
 
@@ -43,7 +53,13 @@ public:
     TEMOTO_DEBUG("Destroyed ResourceClient %s", name_.c_str());
   }
 
-  bool call(ServiceType& msg, FailureBehavior failure_behavior)
+  /**
+   * @brief Loads the resource, or shares an existing query with an equal request. The caller holds
+   * the lock of the client registry of the resource manager, which is released for the duration of
+   * the service call, so that calls to other servers are not blocked by this one.
+   */
+  bool call(ServiceType& msg, FailureBehavior failure_behavior,
+            std::unique_lock<std::shared_timed_mutex>& registry_lock)
   {
     // store the internal id that is generated by resource manager
     // this client's internal id is automatically added to corresponding server query, when the 
@@ -51,10 +67,7 @@ public:
     temoto_id::ID internal_resource_id = msg.response.rmp.resource_id;
 
     // search for given service request from previous queries
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.getMsg().request == msg.request && !q.failed_;
-                             });
+    auto q_it = findQueryByRequest(msg.request);
     if (q_it == queries_.end())
     {
       // New request
@@ -64,22 +77,30 @@ public:
       msg.request.rmp.status_topic = topic;
       msg.request.rmp.temoto_namespace = temoto_namespace;
 
-      TEMOTO_DEBUG("New query, performing external call to %s", service_client_.getService().c_str());
+      TEMOTO_DEBUG("New query, performing external call to %s", load_srv_name_.c_str());
 
-      if (service_client_.call(msg))
+      registry_lock.unlock();
+      bool call_succeeded = this->resource_manager_.getConnectionPool().call(load_srv_name_, msg);
+      registry_lock.lock();
+
+      // An equal request may have been registered in the meantime, the server shares the same
+      // resource between both queries.
+      if (call_succeeded)
       {
         if (msg.response.rmp.code == status_codes::FAILED)
         {
           throw FORWARD_ERROR(msg.response.rmp.error_stack);
         }
         TEMOTO_DEBUG("Service call was sucessful. ext id: %ld", msg.response.rmp.resource_id);
-        queries_.emplace_back(msg, owner_);
-        q_it = std::prev(queries_.end());  // set iterator to the added query
+        temoto_id::ID ext_resource_id = msg.response.rmp.resource_id;
+        q_it = queries_.emplace(std::piecewise_construct, std::forward_as_tuple(ext_resource_id),
+                                std::forward_as_tuple(msg, owner_)).first;
+        request_index_.emplace(q_it->second.getFingerprint(), ext_resource_id);
       }
       else
       {
         throw CREATE_ERROR(error::Code::RMP_FAIL, "Service call to %s returned false.",
-                           service_client_.getService().c_str());
+                           load_srv_name_.c_str());
       }
     }
     else
@@ -88,30 +109,169 @@ public:
       TEMOTO_DEBUG("Existing request, using stored response");
 
       // Fill the response part with the already existing one from previous call.
-      msg.response = q_it->getMsg().response;
+      msg.response = q_it->second.getMsg().response;
     }
 
     // Update id in response part
     msg.response.rmp.resource_id = internal_resource_id;
 
-    q_it->addInternalResource(internal_resource_id, failure_behavior);
+    q_it->second.addInternalResource(internal_resource_id, failure_behavior);
+    internal_index_[internal_resource_id] = q_it->first;
 
     return true;
   }
 
+  /**
+   * @brief Loads several resources with a single request to the server. The requests which are
+   * equal to an existing query are served from the query, the rest are sent in one batch. If any
+   * of the sent requests fails, none of them is loaded and the rmp part of each response tells
+   * which of them failed.
+   */
+  void callBatch(std::vector<ServiceType>& msgs, FailureBehavior failure_behavior,
+                 std::unique_lock<std::shared_timed_mutex>& registry_lock)
+  {
+    std::string temoto_namespace = common::getTemotoNamespace();
+    std::string topic = '/' + temoto_namespace + '/' + this->resource_manager_.getName() + "/status";
+
+    // store the internal ids that are generated by resource manager and collect the new requests.
+    // Equal requests within the batch are sent only once.
+    std::vector<temoto_id::ID> internal_resource_ids;
+    std::vector<size_t> sent_msgs;
+    std::vector<temoto_id::ID> created_queries;
+    temoto_2::LoadBatch batch_msg;
+    batch_msg.request.server_name = ext_server_name_;
+    for (size_t i = 0; i < msgs.size(); i++)
+    {
+      internal_resource_ids.push_back(msgs[i].response.rmp.resource_id);
+      msgs[i].request.rmp.status_topic = topic;
+      msgs[i].request.rmp.temoto_namespace = temoto_namespace;
+
+      bool is_sent = std::any_of(sent_msgs.begin(), sent_msgs.end(),
+                                 [&](size_t j) { return msgs[j].request == msgs[i].request; });
+      if (is_sent || findQueryByRequest(msgs[i].request) != queries_.end())
+      {
+        continue;
+      }
+
+      temoto_2::RMPBatchItem item;
+      item.payload = serializeMessage(msgs[i].request);
+      batch_msg.request.requests.push_back(item);
+      sent_msgs.push_back(i);
+    }
+
+    if (!sent_msgs.empty())
+    {
+      TEMOTO_DEBUG("New queries, performing a batch call of %lu requests to %s", sent_msgs.size(),
+                   load_batch_srv_name_.c_str());
+
+      registry_lock.unlock();
+      bool call_succeeded =
+          this->resource_manager_.getConnectionPool().call(load_batch_srv_name_, batch_msg);
+      registry_lock.lock();
+
+      if (!call_succeeded)
+      {
+        throw CREATE_ERROR(error::Code::RMP_FAIL, "Service call to %s returned false.",
+                           load_batch_srv_name_.c_str());
+      }
+
+      const auto& results = batch_msg.response.results;
+      for (size_t k = 0; k < sent_msgs.size() && k < results.size(); k++)
+      {
+        msgs[sent_msgs[k]].response.rmp = results[k];
+      }
+
+      if (batch_msg.response.code == status_codes::FAILED)
+      {
+        throw FORWARD_ERROR(batch_msg.response.error_stack);
+      }
+
+      try
+      {
+        for (size_t k = 0; k < sent_msgs.size(); k++)
+        {
+          deserializeMessage(batch_msg.response.responses.at(k).payload, msgs[sent_msgs[k]].response);
+        }
+      }
+      catch (std::exception& e)
+      {
+        // the server has loaded everything, give the resources back
+        for (const auto& result : results)
+        {
+          sendUnloadRequest(result.resource_id);
+        }
+        throw CREATE_ERROR(error::Code::RMP_FAIL, "Unable to deserialize the batch responses: %s",
+                           e.what());
+      }
+
+      for (size_t k = 0; k < sent_msgs.size(); k++)
+      {
+        const ServiceType& msg = msgs[sent_msgs[k]];
+        temoto_id::ID ext_resource_id = msg.response.rmp.resource_id;
+        auto emplaced = queries_.emplace(std::piecewise_construct, std::forward_as_tuple(ext_resource_id),
+                                         std::forward_as_tuple(msg, owner_));
+        if (emplaced.second)
+        {
+          request_index_.emplace(emplaced.first->second.getFingerprint(), ext_resource_id);
+          created_queries.push_back(ext_resource_id);
+        }
+      }
+      TEMOTO_DEBUG("Batch call was sucessful.");
+    }
+
+    // The registry was unlocked during the call, hence a query found before it might have been
+    // unloaded meanwhile. If any request is left without a query, fail it and give back the
+    // resources this batch has loaded.
+    std::vector<typename QueryMap::iterator> q_its;
+    bool is_query_missing = false;
+    for (size_t i = 0; i < msgs.size(); i++)
+    {
+      q_its.push_back(findQueryByRequest(msgs[i].request));
+      if (q_its.back() == queries_.end())
+      {
+        msgs[i].response.rmp.code = status_codes::FAILED;
+        msgs[i].response.rmp.message = "The query was unloaded during the batch call.";
+        is_query_missing = true;
+      }
+    }
+
+    if (is_query_missing)
+    {
+      for (temoto_id::ID ext_resource_id : created_queries)
+      {
+        auto q_it = queries_.find(ext_resource_id);
+        if (q_it != queries_.end() && q_it->second.getInternalResources().empty())
+        {
+          sendUnloadRequest(ext_resource_id);
+          eraseQuery(q_it);
+        }
+      }
+      throw CREATE_ERROR(error::Code::RMP_FAIL, "A query of the batch to %s was unloaded during "
+                         "the call.", load_batch_srv_name_.c_str());
+    }
+
+    // Every request has now a query, fill the responses from there and update the ids
+    for (size_t i = 0; i < msgs.size(); i++)
+    {
+      auto q_it = q_its[i];
+      msgs[i].response = q_it->second.getMsg().response;
+      msgs[i].response.rmp.resource_id = internal_resource_ids[i];
+      q_it->second.addInternalResource(internal_resource_ids[i], failure_behavior);
+      internal_index_[internal_resource_ids[i]] = q_it->first;
+    }
+  }
+
   void removeResource(temoto_id::ID resource_id)
   {
     // search for given resource id to unload
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.internalResourceExists(resource_id);
-                             });
+    auto q_it = findQueryByInternalId(resource_id);
     if (q_it != queries_.end())
     {
-      size_t caller_cnt = q_it->removeInternalResource(resource_id);
-      if (caller_cnt <= 0)
+      q_it->second.removeInternalResource(resource_id);
+      internal_index_.erase(resource_id);
+      if (q_it->second.getInternalResources().size() <= 0)
       {
-        queries_.erase(q_it);
+        eraseQuery(q_it);
       }
     }
   }
@@ -122,9 +282,58 @@ public:
     TEMOTO_DEBUG("ResourceClient %s is unloading %lu queries.", name_.c_str(), queries_.size());
     for (auto& q : queries_)
     {
-      sendUnloadRequest(q.getExternalId());
+      sendUnloadRequest(q.second.getExternalId());
     }
     queries_.clear();
+    request_index_.clear();
+    internal_index_.clear();
+  }
+
+  /// Unload several resources by their internal ids. The queries which are left without internal
+  /// resources are unloaded from the server with a single request.
+  void unloadResources(const std::vector<temoto_id::ID>& resource_ids)
+  {
+    error::ErrorStack error_stack;
+    temoto_2::UnloadBatch unload_msg;
+    unload_msg.request.server_name = ext_server_name_;
+    for (temoto_id::ID resource_id : resource_ids)
+    {
+      auto q_it = findQueryByInternalId(resource_id);
+      if (q_it == queries_.end())
+      {
+        error_stack += CREATE_ERROR(error::Code::RMP_FAIL,
+                                    "Unable to unload. Resource '%ld' not found.", resource_id);
+        continue;
+      }
+
+      q_it->second.removeInternalResource(resource_id);
+      internal_index_.erase(resource_id);
+      if (q_it->second.getInternalResources().size() <= 0)
+      {
+        unload_msg.request.resource_ids.push_back(q_it->second.getExternalId());
+        eraseQuery(q_it);
+      }
+    }
+
+    if (!unload_msg.request.resource_ids.empty())
+    {
+      TEMOTO_DEBUG("Sending unload of %lu resources to %s", unload_msg.request.resource_ids.size(),
+                   unload_batch_srv_name_.c_str());
+      if (!this->resource_manager_.getConnectionPool().call(unload_batch_srv_name_, unload_msg, true))
+      {
+        error_stack += CREATE_ERROR(error::Code::RMP_FAIL, "Call to %s failed.",
+                                    unload_batch_srv_name_.c_str());
+      }
+      else if (unload_msg.response.code == status_codes::FAILED)
+      {
+        error_stack += unload_msg.response.error_stack;
+      }
+    }
+
+    if (!error_stack.empty())
+    {
+      throw FORWARD_ERROR(error_stack);
+    }
   }
 
   // unload by internal resource_id
@@ -133,10 +342,7 @@ public:
     TEMOTO_DEBUG("Unloading resource with id:%d", resource_id);
 
     // search for given resource id to unload
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.internalResourceExists(resource_id);
-                             });
+    auto q_it = findQueryByInternalId(resource_id);
     if (q_it == queries_.end())
     {
       throw CREATE_ERROR(error::Code::RMP_FAIL, "Unable to unload. Resource '%ld' not found.",
@@ -146,13 +352,14 @@ public:
     try
     {
       // Remove the found query
-      q_it->removeInternalResource(resource_id); 
+      q_it->second.removeInternalResource(resource_id);
+      internal_index_.erase(resource_id);
 
       // Send out unload request, when the last resource in this query was removed.
-      if (q_it->getInternalResources().size() <= 0)
+      if (q_it->second.getInternalResources().size() <= 0)
       {
-        sendUnloadRequest(q_it->getExternalId());
-        queries_.erase(q_it);
+        sendUnloadRequest(q_it->second.getExternalId());
+        eraseQuery(q_it);
       }
     }
     catch (error::ErrorStack& error_stack)
@@ -164,25 +371,21 @@ public:
   //TODO: Consider creating additional states to a resource
   void setFailedFlag(temoto_id::ID external_resource_id)
   {
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.getExternalId() == external_resource_id;
-                             });
-    if (q_it != queries_.end())
+    auto q_it = queries_.find(external_resource_id);
+    if (q_it != queries_.end() && !q_it->second.failed_)
     {
-      q_it->failed_ = true;
+      // failed queries are not reused, so drop it from the request index
+      q_it->second.failed_ = true;
+      unindexRequest(q_it);
     }
   }
 
   bool hasFailed(temoto_id::ID internal_resource_id)
   {
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.internalResourceExists(internal_resource_id);
-                             });
+    auto q_it = findQueryByInternalId(internal_resource_id);
     if (q_it != queries_.end())
     {
-      return q_it->failed_;
+      return q_it->second.failed_;
     }
     // Return false if resource was not found from this client
     return false; 
@@ -195,10 +398,10 @@ public:
     unload_msg.request.server_name = ext_server_name_;
     unload_msg.request.resource_id = ext_resource_id;
     TEMOTO_DEBUG("Sending unload to %s",
-             service_client_unload_.getService().c_str());
-    if (!service_client_unload_.call(unload_msg))
+             unload_srv_name_.c_str());
+    if (!this->resource_manager_.getConnectionPool().call(unload_srv_name_, unload_msg, true))
     {
-      throw CREATE_ERROR(error::Code::RMP_FAIL, "Call to %s failed.", service_client_unload_.getService().c_str());
+      throw CREATE_ERROR(error::Code::RMP_FAIL, "Call to %s failed.", unload_srv_name_.c_str());
     }
   }
 
@@ -208,7 +411,7 @@ public:
     std::map<temoto_id::ID, FailureBehavior> ret;
     for (auto& q : queries_)
     {
-      std::map<temoto_id::ID, FailureBehavior> r = q.getInternalResources();
+      std::map<temoto_id::ID, FailureBehavior> r = q.second.getInternalResources();
       ret.insert(r.begin(), r.end());
     }
     return ret;
@@ -220,13 +423,10 @@ public:
   getInternalResources(temoto_id::ID ext_resource_id)
   {
     std::map<temoto_id::ID, FailureBehavior> internal_resources;
-    const auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                                   [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                                     return q.getMsg().response.rmp.resource_id == ext_resource_id;
-                                   });
+    const auto q_it = queries_.find(ext_resource_id);
     if (q_it != queries_.end())
     {
-      internal_resources = q_it->getInternalResources();
+      internal_resources = q_it->second.getInternalResources();
     }
     else
     {
@@ -239,11 +439,7 @@ public:
 
   bool internalResourceExists(temoto_id::ID resource_id)
   {
-    auto q_it = std::find_if(queries_.begin(), queries_.end(),
-                             [&](const ClientQuery<ServiceType, Owner>& q) -> bool {
-                               return q.internalResourceExists(resource_id);
-                             });
-    return q_it != queries_.end();
+    return internal_index_.find(resource_id) != internal_index_.end();
   }
 
   size_t getQueryCount() const
@@ -269,24 +465,78 @@ public:
     ret += " Ext manager name: " + ext_resource_manager_name_ + "\n";
     for(auto& q : queries_)
     {
-      ret += q.toString() + "\n";
+      ret += q.second.toString() + "\n";
     }
     return ret;
   }
 
 private:
+  // Find a query that is not failed and has equal request. Fingerprint narrows the search down to
+  // (usually) a single candidate, which is then confirmed with operator==.
+  typename QueryMap::iterator findQueryByRequest(const typename ServiceType::Request& req)
+  {
+    auto range = request_index_.equal_range(rmp::fingerprint(req));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      auto q_it = queries_.find(it->second);
+      if (q_it != queries_.end() && !q_it->second.failed_ && q_it->second.getMsg().request == req)
+      {
+        return q_it;
+      }
+    }
+    return queries_.end();
+  }
+
+  typename QueryMap::iterator findQueryByInternalId(temoto_id::ID internal_resource_id)
+  {
+    auto int_it = internal_index_.find(internal_resource_id);
+    if (int_it == internal_index_.end())
+    {
+      return queries_.end();
+    }
+    return queries_.find(int_it->second);
+  }
+
+  void unindexRequest(typename QueryMap::iterator q_it)
+  {
+    auto range = request_index_.equal_range(q_it->second.getFingerprint());
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second == q_it->first)
+      {
+        request_index_.erase(it);
+        return;
+      }
+    }
+  }
+
+  // Remove the query together with all the index entries pointing to it.
+  void eraseQuery(typename QueryMap::iterator q_it)
+  {
+    unindexRequest(q_it);
+    for (const auto& int_resource : q_it->second.getInternalResources())
+    {
+      internal_index_.erase(int_resource.first);
+    }
+    queries_.erase(q_it);
+  }
+
   std::string name_;                       ///< The unique name of a resource client.
   std::string ext_server_name_;            ///< The name of the server client calls.
   std::string ext_resource_manager_name_;  ///< Name of resource manager where the server is located
   std::string ext_temoto_namespace_;       ///< Name of the destination temoto namespace.
-  std::vector<ClientQuery<ServiceType, Owner>> queries_;  ///< All the resource queries called from
-                                                          /// this resource manager are stored here.
+  QueryMap queries_;  ///< All the resource queries called from this resource manager are stored
+                     /// here, by their external resource id.
+
+  std::unordered_multimap<Fingerprint, temoto_id::ID> request_index_;  ///< request hash -> query
+  std::unordered_map<temoto_id::ID, temoto_id::ID> internal_index_;    ///< internal id -> query
 
   Owner* owner_;
 
-  ros::ServiceClient service_client_;
-  ros::ServiceClient service_client_unload_;
-  ros::NodeHandle nh_;
+  std::string load_srv_name_;
+  std::string unload_srv_name_;
+  std::string load_batch_srv_name_;
+  std::string unload_batch_srv_name_;
 };
 }
 
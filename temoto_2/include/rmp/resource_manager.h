@@ -5,10 +5,14 @@
 #include "rmp/resource_server.h"
 #include "rmp/resource_client.h"
 #include "rmp/resource_manager_services.h"
+#include "rmp/service_connection_pool.h"
 #include "ros/callback_queue.h"
 #include <string>
 #include <memory>  // dynamic_pointer_cast
+#include <future>
+#include <map>
 #include <mutex>
+#include <shared_mutex>
 
 // Resource Management Protocol (RMP) for temoto 2
 
@@ -17,8 +21,6 @@ namespace rmp
 template <class Owner>
 class ResourceManager : public BaseSubsystem
 {
-  friend class BaseResourceServer<Owner>;
-
 public:
   ResourceManager(std::string name, Owner* owner)
     : BaseSubsystem(*owner)
@@ -27,6 +29,7 @@ public:
     , status_callback_(NULL)
     , status_spinner_(1, &status_cb_queue_)
     , unload_spinner_(1, &unload_cb_queue_)
+    , load_batch_spinner_(1, &load_batch_cb_queue_)
   {
     subsystem_name_ = name;
     this->class_name_ = __func__;
@@ -48,14 +51,34 @@ public:
             ros::VoidPtr(), &this->unload_cb_queue_);
     unload_server_ = nh_.advertiseService(unload_service_opts);
 
+    // batched unloads share the queue of single unloads, so that unloading stays sequential
+    std::string unload_batch_srv_name = name_ + "/unload_batch";
+    ros::AdvertiseServiceOptions unload_batch_service_opts =
+        ros::AdvertiseServiceOptions::create<temoto_2::UnloadBatch>(
+            unload_batch_srv_name,
+            boost::bind(&ResourceManager<Owner>::unloadBatchCallback, this, _1, _2), ros::VoidPtr(),
+            &this->unload_cb_queue_);
+    unload_batch_server_ = nh_.advertiseService(unload_batch_service_opts);
+
+    // set up batch load callback with separately threaded queue
+    std::string load_batch_srv_name = name_ + "/load_batch";
+    ros::AdvertiseServiceOptions load_batch_service_opts =
+        ros::AdvertiseServiceOptions::create<temoto_2::LoadBatch>(
+            load_batch_srv_name,
+            boost::bind(&ResourceManager<Owner>::loadBatchCallback, this, _1, _2), ros::VoidPtr(),
+            &this->load_batch_cb_queue_);
+    load_batch_server_ = nh_.advertiseService(load_batch_service_opts);
+
     // start separate threaded spinners for our callback queues
     status_spinner_.start();
     unload_spinner_.start();
+    load_batch_spinner_.start();
   }
 
   ~ResourceManager()
   {
     unloadClients();
+    load_batch_spinner_.stop();
     unload_spinner_.stop();
     status_spinner_.stop();
   }
@@ -65,16 +88,18 @@ public:
                  void (Owner::*load_cb)(typename ServiceType::Request&,
                                         typename ServiceType::Response&),
                  void (Owner::*unload_cb)(typename ServiceType::Request&,
-                                          typename ServiceType::Response&))
+                                          typename ServiceType::Response&),
+                 unsigned int load_thread_count = DEFAULT_LOAD_THREAD_COUNT)
   {
-    if (serverExists(server_name))
+    std::lock_guard<std::shared_timed_mutex> lock(servers_mutex_);
+    if (findServer(server_name))
     {
       return false;
     }
 
     typedef std::shared_ptr<BaseResourceServer<Owner>> BaseResPtr;
     BaseResPtr res_srv = std::make_shared<ResourceServer<ServiceType, Owner>>(
-        server_name, load_cb, unload_cb, owner_, *this);
+        server_name, load_cb, unload_cb, owner_, *this, load_thread_count);
 
     servers_.push_back(res_srv);
 
@@ -88,14 +113,8 @@ public:
 
   bool serverExists(const std::string server_name)
   {
-    for (auto& server : servers_)
-    {
-      if (server->getName() == server_name)
-      {
-        return true;
-      }
-    }
-    return false;
+    std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
+    return findServer(server_name) != nullptr;
   }
 
   const std::string& getName()
@@ -103,69 +122,211 @@ public:
     return name_;
   }
 
+  /**
+   * @brief Persistent connections to the services of other resource managers, shared by the
+   * clients and the status forwarding of this manager. Also usable by the owner for its own
+   * service calls.
+   */
+  ServiceConnectionPool& getConnectionPool()
+  {
+    return connection_pool_;
+  }
+
   template <class ServiceType>
   void call(std::string resource_manager_name, std::string server_name, ServiceType& msg,
             rmp::FailureBehavior failure_behavior = rmp::FailureBehavior::NONE,
             std::string temoto_namespace = ::common::getTemotoNamespace())
   {
-    using ClientType = ResourceClient<ServiceType, Owner>;
-    using ClientPtr = std::shared_ptr<ClientType>;
-    using BaseClientPtr = BaseResourceClientPtr<Owner>;
+    callClient(resource_manager_name, server_name, msg, failure_behavior, temoto_namespace,
+               BaseResourceServer<Owner>::getLoadContext());
+  }
+
+  /**
+   * @brief Same as call, but the call is made in a separate thread. The returned future holds the
+   * message with the filled response, or the error stack of a failed call. Calls to different
+   * servers run in parallel, hence independent resources can be loaded at the same time.
+   */
+  template <class ServiceType>
+  std::future<ServiceType> callAsync(std::string resource_manager_name, std::string server_name,
+                                     ServiceType msg,
+                                     rmp::FailureBehavior failure_behavior = rmp::FailureBehavior::NONE,
+                                     std::string temoto_namespace = ::common::getTemotoNamespace())
+  {
+    // The load context belongs to the calling thread, carry it over to the thread of the call so
+    // that the resource is still linked to the query of the calling load callback.
+    LoadContext<Owner> load_context = BaseResourceServer<Owner>::getLoadContext();
+    return std::async(std::launch::async, [=]() mutable {
+      callClient(resource_manager_name, server_name, msg, failure_behavior, temoto_namespace,
+                 load_context);
+      return msg;
+    });
+  }
+
+  /**
+   * @brief Loads several resources from one server with a single round-trip. The server loads the
+   * requests concurrently, hence they must not depend on each other. Either all of the requests
+   * are loaded or, when any of them fails, none of them. The rmp part of each response tells which
+   * of the requests failed.
+   */
+  template <class ServiceType>
+  void callBatch(std::string resource_manager_name, std::string server_name,
+                 std::vector<ServiceType>& msgs,
+                 rmp::FailureBehavior failure_behavior = rmp::FailureBehavior::NONE,
+                 std::string temoto_namespace = ::common::getTemotoNamespace())
+  {
+    if (msgs.empty())
+    {
+      return;
+    }
 
-    ClientPtr client_ptr = NULL;
+    std::unique_lock<std::shared_timed_mutex> lock(clients_mutex_);
+    auto client_ptr = getClient<ServiceType>(temoto_namespace, resource_manager_name, server_name);
 
-    waitForLock(clients_mutex_);
+    // generate new ids for owner as the call was not initiated from any servers callback
+    for (auto& msg : msgs)
+    {
+      msg.response.rmp.resource_id = generateID();
+    }
 
-    // check if this client already exists
-    std::string client_name = '/'+temoto_namespace + "/" + resource_manager_name + "/" + server_name;
-    typename std::vector<BaseClientPtr>::iterator client_it =
-        std::find_if(clients_.begin(), clients_.end(),
-                     [&](const BaseClientPtr& c) -> bool { return c->getName() == client_name; });
-    if (client_it == clients_.end())
+    client_ptr->beginCall();
+    try
     {
-      TEMOTO_DEBUG("Creating new resource client '%s'.", client_name.c_str());
+      client_ptr->callBatch(msgs, failure_behavior, lock);
+      client_ptr->endCall();
 
-      client_ptr = std::make_shared<ClientType>(temoto_namespace, resource_manager_name,
-                                                server_name, owner_, *this);
-      // Push to clients and convert to BaseResourceClient type
-      clients_.push_back(client_ptr);
-      client_it = std::prev(clients_.end());  // set iterator to the client pointer we just added
+      // link the clients to the query of the load callback the call was initiated from
+      const LoadContext<Owner>& load_context = BaseResourceServer<Owner>::getLoadContext();
+      if (load_context.resource_manager == this)
+      {
+        TEMOTO_DEBUG("Linking %lu internal clients.", msgs.size());
+        for (const auto& msg : msgs)
+        {
+          load_context.server->linkInternalResource(load_context.query_id,
+                                                    msg.response.rmp.resource_id);
+        }
+      }
     }
-    else
+    catch (error::ErrorStack& error_stack)
+    {
+      client_ptr->endCall();
+      if (client_ptr->isIdle())
+      {
+        eraseClient(client_ptr);
+      }
+      throw FORWARD_ERROR(error_stack);
+    }
+  }
+
+  bool loadBatchCallback(temoto_2::LoadBatch::Request& req, temoto_2::LoadBatch::Response& res)
+  {
+    TEMOTO_DEBUG("Batch of %lu load requests to server: '%s'.", req.requests.size(),
+                 req.server_name.c_str());
+    std::shared_ptr<BaseResourceServer<Owner>> server;
     {
-      client_ptr = std::dynamic_pointer_cast<ClientType>(*client_it);
-      if (!client_ptr)
+      std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
+      server = findServer(req.server_name);
+    }
+
+    if (!server)
+    {
+      res.code = status_codes::FAILED;
+      res.error_stack =
+          CREATE_ERROR(error::Code::RMP_FAIL, "Server '%s' not found.", req.server_name.c_str());
+      return true;
+    }
+
+    // The requests of a batch do not depend on each other, so all of them are queued to the load
+    // threads of the server at once. Equal requests are loaded only once, as the server shares the
+    // query between them.
+    res.results.resize(req.requests.size());
+    res.responses.resize(req.requests.size());
+    std::vector<std::future<temoto_2::RMPResponse>> loads;
+    for (size_t i = 0; i < req.requests.size(); i++)
+    {
+      loads.push_back(server->loadSerialized(req.requests[i].payload, res.responses[i].payload));
+    }
+
+    error::ErrorStack error_stack;
+    std::vector<temoto_id::ID> loaded_resources;
+    for (size_t i = 0; i < loads.size(); i++)
+    {
+      try
+      {
+        res.results[i] = loads[i].get();
+      }
+      catch (std::exception& e)
+      {
+        res.results[i].code = status_codes::FAILED;
+        res.results[i].error_stack =
+            CREATE_ERROR(error::Code::RMP_FAIL, "Batch item %lu failed: %s", i, e.what());
+      }
+
+      if (res.results[i].code == status_codes::FAILED)
+      {
+        error_stack += res.results[i].error_stack;
+      }
+      else
       {
-        // cast failed
-        clients_mutex_.unlock();
-        throw CREATE_ERROR(error::Code::RMP_FAIL, "Dynamic Cast failed, last time the same service was called using different type?");
+        loaded_resources.push_back(res.results[i].resource_id);
       }
     }
 
-    // generate new id for owner as the call was not initiated from any servers callback
-    msg.response.rmp.resource_id = generateID();
-    
-    try
+    if (error_stack.empty())
     {
-      // make the call
-      client_ptr->call(msg, failure_behavior);
+      res.code = status_codes::OK;
+      return true;
+    }
 
-      if (active_server_)
+    // All or nothing, unload the resources which were loaded successfully
+    TEMOTO_DEBUG("Batch failed, unloading %lu loaded resources.", loaded_resources.size());
+    for (temoto_id::ID resource_id : loaded_resources)
+    {
+      temoto_2::UnloadResource unload_msg;
+      unload_msg.request.server_name = req.server_name;
+      unload_msg.request.resource_id = resource_id;
+      server->unloadResource(unload_msg.request, unload_msg.response);
+      if (unload_msg.response.code == status_codes::FAILED)
       {
-        // if call was sucessful and the call was initiated from server callback,
-        // link the client to the server
-        TEMOTO_DEBUG("Linking internal client.");
-        active_server_->linkInternalResource(msg.response.rmp.resource_id);
+        error_stack += unload_msg.response.error_stack;
       }
     }
-    catch (error::ErrorStack& error_stack)
+
+    res.code = status_codes::FAILED;
+    res.message = "Batch load failed, none of the requests were loaded.";
+    res.error_stack = FORWARD_ERROR(error_stack);
+    return true;
+  }
+
+  bool unloadBatchCallback(temoto_2::UnloadBatch::Request& req,
+                           temoto_2::UnloadBatch::Response& res)
+  {
+    TEMOTO_DEBUG("Batch of %lu unload requests to server: '%s'.", req.resource_ids.size(),
+                 req.server_name.c_str());
+    std::shared_ptr<BaseResourceServer<Owner>> server;
     {
-      clients_.erase(client_it);
-      clients_mutex_.unlock();
-      throw FORWARD_ERROR(error_stack);
+      std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
+      server = findServer(req.server_name);
+    }
+
+    if (!server)
+    {
+      return true;
     }
 
-    clients_mutex_.unlock();
+    for (temoto_id::ID resource_id : req.resource_ids)
+    {
+      temoto_2::UnloadResource unload_msg;
+      unload_msg.request.server_name = req.server_name;
+      unload_msg.request.resource_id = resource_id;
+      server->unloadResource(unload_msg.request, unload_msg.response);
+      if (unload_msg.response.code == status_codes::FAILED)
+      {
+        res.code = status_codes::FAILED;
+        res.error_stack += unload_msg.response.error_stack;
+      }
+    }
+
+    return true;
   }
 
   bool unloadCallback(temoto_2::UnloadResource::Request& req,
@@ -173,24 +334,24 @@ public:
   {
     TEMOTO_DEBUG("Unload request to server: '%s', ext id: %ld.", req.server_name.c_str(), req.resource_id);
     // Find server with requested name
-    waitForLock(servers_mutex_);
-    for (auto& server : servers_)
+    std::shared_ptr<BaseResourceServer<Owner>> server;
     {
-      if (server->getName() == req.server_name)
-      {
-        server->unloadResource(req, res);
-        TEMOTO_DEBUG("Resource %ld unloaded.", req.resource_id);
-        break;
-      }
+      std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
+      server = findServer(req.server_name);
+    }
+
+    if (server)
+    {
+      server->unloadResource(req, res);
+      TEMOTO_DEBUG("Resource %ld unloaded.", req.resource_id);
     }
-    servers_mutex_.unlock();
 
     return true;
   }
 
   void unloadClients()
   {
-    waitForLock(clients_mutex_);
+    std::lock_guard<std::shared_timed_mutex> lock(clients_mutex_);
     TEMOTO_DEBUG("Number of clients:%lu", clients_.size());
     for (auto client : clients_)
     {
@@ -199,13 +360,12 @@ public:
       // TODO: remove all connections in servers
     }
     clients_.clear();
-    clients_mutex_.unlock();
   }
 
   // Wrapper for unloading resource clients
   void unloadClientResource(temoto_id::ID resource_id)
   {
-    waitForLock(clients_mutex_);
+    std::lock_guard<std::shared_timed_mutex> lock(clients_mutex_);
     TEMOTO_DEBUG("Unloading resource with id:'%d'.", resource_id);
     // Go through clients and search for given client by name
     auto client_it =
@@ -222,7 +382,7 @@ public:
    //   unlinkResource(resource_id);
 
       // when all resources for this client are removed, destroy this client
-      if ((*client_it)->getQueryCount() <= 0)
+      if ((*client_it)->isIdle())
       {
         TEMOTO_DEBUG("Destroying resource client '%s'", (*client_it)->getName().c_str());
         clients_.erase(client_it);
@@ -232,7 +392,59 @@ public:
     {
       TEMOTO_WARN("Internal id '%d' not found. Already removed?", resource_id);
     }
-    clients_mutex_.unlock();
+  }
+
+  // Wrapper for unloading several resource clients, each client unloads its resources with a single
+  // request to the server.
+  void unloadClientResources(const std::vector<temoto_id::ID>& resource_ids)
+  {
+    std::lock_guard<std::shared_timed_mutex> lock(clients_mutex_);
+
+    // Group the resources by their clients
+    std::map<BaseResourceClientPtr<Owner>, std::vector<temoto_id::ID>> client_resources;
+    for (temoto_id::ID resource_id : resource_ids)
+    {
+      auto client_it =
+          std::find_if(clients_.begin(), clients_.end(),
+                       [&](const BaseResourceClientPtr<Owner>& client_ptr) -> bool {
+                         return client_ptr->internalResourceExists(resource_id);
+                       });
+      if (client_it != clients_.end())
+      {
+        client_resources[*client_it].push_back(resource_id);
+      }
+      else
+      {
+        TEMOTO_WARN("Internal id '%d' not found. Already removed?", resource_id);
+      }
+    }
+
+    error::ErrorStack error_stack;
+    for (auto& client_resource : client_resources)
+    {
+      TEMOTO_DEBUG("Unloading %lu resources of client '%s'.", client_resource.second.size(),
+                   client_resource.first->getName().c_str());
+      try
+      {
+        client_resource.first->unloadResources(client_resource.second);
+      }
+      catch (error::ErrorStack& es)
+      {
+        error_stack += es;
+      }
+
+      // when all resources for this client are removed, destroy this client
+      if (client_resource.first->isIdle())
+      {
+        TEMOTO_DEBUG("Destroying resource client '%s'", client_resource.first->getName().c_str());
+        eraseClient(client_resource.first);
+      }
+    }
+
+    if (!error_stack.empty())
+    {
+      throw FORWARD_ERROR(error_stack);
+    }
   }
 
   // This method sends error/info message to any client connected to this resource.
@@ -248,8 +460,7 @@ public:
     };
     std::vector<ResourceInfo> infos;
 
-    waitForLock(servers_mutex_);
-    for (const auto& server : servers_)
+    for (const auto& server : getServers())
     {
       if (!server->hasInternalResource(srv.request.resource_id))
       {
@@ -262,12 +473,12 @@ public:
         server->setFailedFlag(srv.request.resource_id, srv.request.error_stack);
       }
 
-      // Don't send status when it is adressed to server currently active and still in the middle of
+      // Don't send status when it is adressed to a query which is still in the middle of
       // processing the loadCallback. Instead, the above will store the error message in server
       // query response stack, which is returned when the load callback is processed.
-      if (server == active_server_)
+      if (server->isLoading(srv.request.resource_id))
       {
-        TEMOTO_WARN("Skipping active server.");
+        TEMOTO_WARN("Skipping the query that is being loaded.");
         continue;
       }
       
@@ -288,16 +499,13 @@ public:
         infos.push_back(info);
       }
     }
-    servers_mutex_.unlock();
 
     // forward status info to whoever is related with the given resource
     error::ErrorStack error_stack;
     for (auto& info : infos)
     {
-      ros::ServiceClient service_client =
-          nh_.serviceClient<temoto_2::ResourceStatus>(info.status_topic);
       TEMOTO_DEBUG("Sending ResourceStatus to %s.", info.status_topic.c_str());
-      if (service_client.call(info.srv))
+      if (connection_pool_.call(info.status_topic, info.srv))
       {
         TEMOTO_DEBUG("ResourceStatus sucessfully sent to %s.", info.status_topic.c_str());
       }
@@ -324,17 +532,16 @@ public:
 // This method returns true when statusCallback() has set the FAILED flag to the given resource
   bool hasFailed(temoto_id::ID resource_id)
   {
-    waitForLock(clients_mutex_);
+    std::shared_lock<std::shared_timed_mutex> lock(clients_mutex_);
     auto client_it =
         std::find_if(clients_.begin(), clients_.end(),
                      [&](const BaseResourceClientPtr<Owner>& client_ptr) -> bool {
                        return client_ptr->hasFailed(resource_id);
                      });
-    bool has_failed =  client_it != clients_.end();
-    clients_mutex_.unlock();
-    return has_failed;
+    return client_it != clients_.end();
   }
 
+  // Expects the clients_mutex_ to be locked by the caller.
   BaseResourceClientPtr<Owner> getClientByName(const std::string& client_name)
   {
     auto it = std::find_if(clients_.begin(), clients_.end(),
@@ -350,7 +557,7 @@ public:
 
   void unlinkResource(temoto_id::ID resource_id)
   {
-    for (auto server:servers_)
+    for (auto server : getServers())
     {
       if(server->isLinkedTo(resource_id))
       {
@@ -396,12 +603,14 @@ public:
 
       try
       {
-        waitForLock(clients_mutex_);
-        BaseResourceClientPtr<Owner> client_ptr = getClientByName(client_name);
-        client_ptr->setFailedFlag(req.resource_id);
-        // get internal ids which are related to the incoming external id from client side
-        const auto int_resources = client_ptr->getInternalResources(req.resource_id);
-        clients_mutex_.unlock();
+        std::map<temoto_id::ID, FailureBehavior> int_resources;
+        {
+          std::lock_guard<std::shared_timed_mutex> lock(clients_mutex_);
+          BaseResourceClientPtr<Owner> client_ptr = getClientByName(client_name);
+          client_ptr->setFailedFlag(req.resource_id);
+          // get internal ids which are related to the incoming external id from client side
+          int_resources = client_ptr->getInternalResources(req.resource_id);
+        }
 
         temoto_2::ResourceStatus srv;
         srv.request = req;
@@ -453,7 +662,6 @@ public:
       }
       catch (error::ErrorStack& error_stack)
       {
-        clients_mutex_.unlock();
         TEMOTO_ERROR("An extreme badness was captured...");
         res.error_stack += error_stack;
         return true;
@@ -466,7 +674,7 @@ public:
 //  std::vector<std::pair<temoto_id::ID, std::string>>
 //  getServerExtResources(temoto_id::ID internal_resource_id, const std::string& server_name)
 //  {
-//    waitForLock(servers_mutex_);
+//    std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
 //    std::vector<std::pair<temoto_id::ID, std::string>> ext_resources;
 //    auto s_it = find_if(servers_.begin(), servers_.end(),
 //                        [&](const std::shared_ptr<BaseResourceServer<Owner>>& server_ptr) -> bool {
@@ -480,11 +688,9 @@ public:
 //      }
 //      catch(error::ErrorStack& error_stack)
 //      {
-//        servers_mutex_.unlock();
 //        throw FORWARD_ERROR(error_stack);
 //      }
 //    }
-//    servers_mutex_.unlock();
 //    return ext_resources;
 //  }
 //
@@ -494,44 +700,108 @@ public:
     return id_manager_.generateID();
   }
 
-  const std::string getActiveServerName() const
+private:
+  // Finds the client of the given server or creates a new one.
+  // Expects the clients_mutex_ to be locked by the caller.
+  template <class ServiceType>
+  std::shared_ptr<ResourceClient<ServiceType, Owner>> getClient(const std::string& temoto_namespace,
+                                                                const std::string& resource_manager_name,
+                                                                const std::string& server_name)
   {
-    if (active_server_)
+    using ClientType = ResourceClient<ServiceType, Owner>;
+
+    // check if this client already exists
+    std::string client_name = '/'+temoto_namespace + "/" + resource_manager_name + "/" + server_name;
+    auto client_it =
+        std::find_if(clients_.begin(), clients_.end(), [&](const BaseResourceClientPtr<Owner>& c) -> bool {
+          return c->getName() == client_name;
+        });
+    if (client_it == clients_.end())
     {
-      return active_server_->getName();
+      TEMOTO_DEBUG("Creating new resource client '%s'.", client_name.c_str());
+
+      auto client_ptr = std::make_shared<ClientType>(temoto_namespace, resource_manager_name,
+                                                     server_name, owner_, *this);
+      // Push to clients and convert to BaseResourceClient type
+      clients_.push_back(client_ptr);
+      return client_ptr;
+    }
+
+    auto client_ptr = std::dynamic_pointer_cast<ClientType>(*client_it);
+    if (!client_ptr)
+    {
+      // cast failed
+      throw CREATE_ERROR(error::Code::RMP_FAIL, "Dynamic Cast failed, last time the same service was called using different type?");
     }
-    return std::string("");
+    return client_ptr;
   }
 
-private:
-  void setActiveServer(BaseResourceServer<Owner>* active_server)
+  // Makes the call on behalf of the given load context. The clients are locked only for the
+  // bookkeeping, not while waiting for the server.
+  template <class ServiceType>
+  void callClient(const std::string& resource_manager_name, const std::string& server_name,
+                  ServiceType& msg, rmp::FailureBehavior failure_behavior,
+                  const std::string& temoto_namespace, const LoadContext<Owner>& load_context)
   {
-    // inactivate server;
-    if (!active_server)
+    std::unique_lock<std::shared_timed_mutex> lock(clients_mutex_);
+    auto client_ptr = getClient<ServiceType>(temoto_namespace, resource_manager_name, server_name);
+
+    // generate new id for owner as the call was not initiated from any servers callback
+    msg.response.rmp.resource_id = generateID();
+
+    client_ptr->beginCall();
+    try
     {
-      active_server_ = NULL;
-      return;
-    }
+      // make the call
+      client_ptr->call(msg, failure_behavior, lock);
+      client_ptr->endCall();
 
-    std::lock_guard<std::mutex> lock(active_server_mutex_);
-    for (auto& server_shared_ptr : servers_)
+      // if call was sucessful and the call was initiated from a load callback of our server,
+      // link the client to the query of that callback
+      if (load_context.resource_manager == this)
+      {
+        TEMOTO_DEBUG("Linking internal client.");
+        load_context.server->linkInternalResource(load_context.query_id,
+                                                  msg.response.rmp.resource_id);
+      }
+    }
+    catch (error::ErrorStack& error_stack)
     {
-      if (server_shared_ptr.get() == active_server)
+      // keep the client when it still serves other queries or calls
+      client_ptr->endCall();
+      if (client_ptr->isIdle())
       {
-        active_server_ = server_shared_ptr;
-        return;
+        eraseClient(client_ptr);
       }
+      throw FORWARD_ERROR(error_stack);
     }
-    CREATE_ERROR(error::Code::RMP_FAIL, "Resource server '%s' not found.", active_server->getName());
   }
 
-  void waitForLock(std::mutex& m)
+  // Expects the clients_mutex_ to be locked by the caller.
+  void eraseClient(const BaseResourceClientPtr<Owner>& client_ptr)
   {
-    while (!m.try_lock())
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), client_ptr), clients_.end());
+  }
+
+  // Expects the servers_mutex_ to be locked by the caller.
+  std::shared_ptr<BaseResourceServer<Owner>> findServer(const std::string& server_name) const
+  {
+    for (auto& server : servers_)
     {
-      TEMOTO_DEBUG("Waiting for lock()"); 
-      ros::Duration(0.2).sleep();  // sleep for few ms
+      if (server->getName() == server_name)
+      {
+        return server;
+      }
     }
+    return nullptr;
+  }
+
+  // Servers are never removed, so the callers can work on a snapshot of the list without holding
+  // the servers_mutex_ while the servers lock their own queries.
+  std::vector<std::shared_ptr<BaseResourceServer<Owner>>> getServers() const
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(servers_mutex_);
+    return servers_;
   }
 
   std::vector<std::shared_ptr<BaseResourceServer<Owner>>> servers_;
@@ -539,22 +809,25 @@ private:
   std::string name_;
   Owner* owner_;
   temoto_id::IDManager id_manager_;
-  std::shared_ptr<BaseResourceServer<Owner>> active_server_;
   void (Owner::*status_callback_)(temoto_2::ResourceStatus&);
 
   ros::AsyncSpinner status_spinner_;
   ros::AsyncSpinner unload_spinner_;
+  ros::AsyncSpinner load_batch_spinner_;
   ros::CallbackQueue status_cb_queue_;
   ros::CallbackQueue unload_cb_queue_;
+  ros::CallbackQueue load_batch_cb_queue_;
   ros::NodeHandle nh_;
+  ServiceConnectionPool connection_pool_;
   ros::ServiceServer unload_server_;
   ros::ServiceServer status_server_;
+  ros::ServiceServer unload_batch_server_;
+  ros::ServiceServer load_batch_server_;
 
-  // thread safe locks;
+  // thread safe locks, read-only paths take a shared lock
   std::mutex id_manager_mutex_;
-  std::mutex servers_mutex_;
-  std::mutex clients_mutex_;
-  std::mutex active_server_mutex_;
+  mutable std::shared_timed_mutex servers_mutex_;
+  std::shared_timed_mutex clients_mutex_;
 };
 
 }  // namespace rmp
@@ -3,7 +3,10 @@
 
 #include "temoto_2/UnloadResource.h"
 #include "temoto_2/ResourceStatus.h"
+#include "temoto_2/LoadBatch.h"
+#include "temoto_2/UnloadBatch.h"
 #include "common/tools.h"
+#include "rmp/request_fingerprint.h"
 
 namespace rmp
 {
@@ -5,11 +5,26 @@
 #include "common/tools.h"
 #include "rmp/base_resource_server.h"
 #include "rmp/server_query.h"
+#include "rmp/message_serialization.h"
 #include "ros/callback_queue.h"
+#include <boost/make_shared.hpp>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace rmp
 {
+// Number of threads serving the load requests of a server, unless specified otherwise. The load
+// callbacks of an owner run one at a time unless the owner asks for more threads.
+const unsigned int DEFAULT_LOAD_THREAD_COUNT = 1;
+
+// Number of load threads for the owners whose load and unload callbacks are thread-safe
+const unsigned int PARALLEL_LOAD_THREAD_COUNT = 2;
+
 template <class ServiceType, class Owner>
 class ResourceServer : public BaseResourceServer<Owner>
 {
@@ -18,14 +33,21 @@ public:
                                         typename ServiceType::Response&);
   typedef void (Owner::*UnloadCbFuncType)(typename ServiceType::Request&,
                                           typename ServiceType::Response&);
+  typedef std::unordered_map<temoto_id::ID, ServerQuery<ServiceType>> QueryMap;
 
+  /**
+   * @brief Load requests are served by load_thread_count threads. With more than one thread the
+   * owner's load and unload callbacks may be executed concurrently for different requests, so the
+   * owner has to guard the state they touch.
+   */
   ResourceServer(std::string name, LoadCbFuncType load_cb, UnloadCbFuncType unload_cb, Owner* owner,
-                 ResourceManager<Owner>& resource_manager)
+                 ResourceManager<Owner>& resource_manager,
+                 unsigned int load_thread_count = DEFAULT_LOAD_THREAD_COUNT)
     : BaseResourceServer<Owner>(name, resource_manager)
     , load_callback_(load_cb)
     , unload_callback_(unload_cb)
     , owner_(owner)
-    , load_spinner_(2, &load_cb_queue_)
+    , load_spinner_(load_thread_count, &load_cb_queue_)
 
   {
     this->class_name_ = __func__;
@@ -50,32 +72,33 @@ public:
     TEMOTO_DEBUG("ResourceServer destroyed.");
   }
 
-  void linkInternalResource(temoto_id::ID internal_resource_id)
+  void linkInternalResource(temoto_id::ID query_id, temoto_id::ID internal_resource_id)
   {
-    TEMOTO_DEBUG("Trying to register client side id in resource query %d.", internal_resource_id);
-    if (!queries_.size())
+    TEMOTO_DEBUG("Trying to register client side id %d in resource query %d.", internal_resource_id,
+                 query_id);
+    std::lock_guard<std::shared_timed_mutex> lock(queries_mutex_);
+    auto q_it = queries_.find(query_id);
+    if (q_it == queries_.end())
     {
-      TEMOTO_ERROR("Failed because queries_ is empty.");
+      TEMOTO_ERROR("Failed because query %d does not exist.", query_id);
       return;
     }
-    queries_.back().linkResource(internal_resource_id);
+    q_it->second.linkResource(internal_resource_id);
+    linked_index_[internal_resource_id] = q_it->first;
   }
 
   
   void unlinkInternalResource(temoto_id::ID internal_resource_id)
   {
     TEMOTO_DEBUG("Trying to unlink resource '%d'.", internal_resource_id);
+    std::lock_guard<std::shared_timed_mutex> lock(queries_mutex_);
     try
     {
-      const auto found_query_it =
-          std::find_if(queries_.begin(), queries_.end(),
-                       [internal_resource_id](const ServerQuery<ServiceType>& query) -> bool {
-                         return query.isLinkedTo(internal_resource_id);
-                       });
-      if (found_query_it != queries_.end())
+      const auto link_it = linked_index_.find(internal_resource_id);
+      if (link_it != linked_index_.end())
       {
-        found_query_it->unlinkResource(internal_resource_id);
-        //if(found_query_it->getInternalResources().size()==0)
+        queries_.at(link_it->second).unlinkResource(internal_resource_id);
+        linked_index_.erase(link_it);
       }
       else
       {
@@ -107,203 +130,172 @@ public:
     TEMOTO_DEBUG("Generated external id: '%d'.", ext_resource_id);
 
     // lock the queries
-    waitForLock(queries_mutex_);
-
-    // New or existing query? Check it out with this hi-tec lambda function :)
-    auto found_query = std::find_if(queries_.begin(), queries_.end(),
-                                    [&req](const ServerQuery<ServiceType>& query) -> bool {
-                                      return query.getMsg().request == req && !query.failed_;
-                                    });
+    std::unique_lock<std::shared_timed_mutex> queries_lock(queries_mutex_);
 
-    if (found_query == queries_.end())
+    // New or existing query? Check it out from the request index. When an equal request is still
+    // in the middle of owner's load callback, wait for its outcome before sharing the response.
+    auto found_query = findQueryByRequest(req);
+    while (found_query != queries_.end() &&
+           loading_queries_.find(found_query->first) != loading_queries_.end())
     {
-      // generate new internal id, and give it to owners callback.
-      // with this id, owner can send status messages later when necessary
-      temoto_id::ID int_resource_id = this->resource_manager_.generateID();
-      res.rmp.resource_id = int_resource_id;
-      TEMOTO_DEBUG("New query, server generated new internal id: '%d'.", int_resource_id);
+      load_finished_cv_.wait(queries_lock);
+      found_query = findQueryByRequest(req);
+    }
 
-      // equal message not found from queries_, add new query
+    if (found_query != queries_.end())
+    {
       try
       {
-        queries_.emplace_back(req, int_resource_id, *owner_);
-        queries_.back().addExternalResource(ext_resource_id, req.rmp.status_topic);
+        // found equal request, simply reqister this in the query
+        // and respond with previous data and a unique resoure_id.
+        TEMOTO_DEBUG("Existing query, linking to the found query.");
+        found_query->second.addExternalResource(ext_resource_id, req.rmp.status_topic);
+        external_index_[ext_resource_id] = found_query->first;
+        res = found_query->second.getMsg().response;
+        res.rmp.resource_id = ext_resource_id;
+        //res.rmp.code = status_codes::OK;
+        //res.rmp.message = "Sucessfully sharing existing resource.";
       }
       catch(error::ErrorStack& error_stack)
       {
-        queries_.pop_back(); //remove the failed query
-        queries_mutex_.unlock();
         res.rmp.code = status_codes::FAILED;
         res.rmp.error_stack = FORWARD_ERROR(error_stack);
-        return true;
       }
+      return true;
+    }
 
-      // set this server active in resource manager
-      // when a client call is made from callback, the binding between active server
-      // and the new loaded resources can be made automatically
-      waitForLock(active_server_mutex_);
-      try
-      {
-        this->activateServer();
-      }
-      catch(error::ErrorStack& error_stack)
-      {
-        queries_.pop_back(); //remove the failed query
-        queries_mutex_.unlock();
-        active_server_mutex_.unlock();
-        res.rmp.code = status_codes::FAILED;
-        res.rmp.error_stack = FORWARD_ERROR(error_stack);
-        return true;
-      }
-      queries_mutex_.unlock();
+    // generate new internal id, and give it to owners callback.
+    // with this id, owner can send status messages later when necessary
+    temoto_id::ID int_resource_id = this->resource_manager_.generateID();
+    res.rmp.resource_id = int_resource_id;
+    TEMOTO_DEBUG("New query, server generated new internal id: '%d'.", int_resource_id);
 
-      // call owner's registered callback and release the lock during the callback so that owner is
-      // able to use rmp inside the callback
-      try
-      {
-        (owner_->*load_callback_)(req, res);
-      }
-      catch(error::ErrorStack& error_stack)
-      {
-        // callback threw an exeption, try to clean up and return.
-        try
-        {
-          waitForLock(queries_mutex_);
-          auto q_it = getQueryByExternalId(ext_resource_id);
-          if(q_it->failed_)
-          {
-            res.rmp.error_stack += q_it->getMsg().response.rmp.error_stack;
-          }
-          queries_.erase(q_it);
-          queries_mutex_.unlock();
-        }
-        catch(error::ErrorStack& query_error)
-        {
-          // just send the error when trying to  and continue
-          queries_mutex_.unlock();
-          SEND_ERROR(FORWARD_ERROR(query_error));
-        }
+    // equal message not found from queries_, add new query
+    try
+    {
+      auto q_it = queries_.emplace(std::piecewise_construct, std::forward_as_tuple(int_resource_id),
+                                   std::forward_as_tuple(req, int_resource_id, *owner_)).first;
+      request_index_.emplace(q_it->second.getFingerprint(), int_resource_id);
+      q_it->second.addExternalResource(ext_resource_id, req.rmp.status_topic);
+      external_index_[ext_resource_id] = int_resource_id;
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      eraseQuery(queries_.find(int_resource_id)); //remove the failed query
+      res.rmp.code = status_codes::FAILED;
+      res.rmp.error_stack = FORWARD_ERROR(error_stack);
+      return true;
+    }
 
-        this->deactivateServer();
-        active_server_mutex_.unlock();
-        res.rmp.code = status_codes::FAILED;
-        res.rmp.error_stack = FORWARD_ERROR(error_stack);
-        return true;
-      }
-      catch(...)
-      {
-        // callback threw an unknown exeption, prevent this for reaching ros callback.
-        // try to clean up and report.
-        try
-        {
-          waitForLock(queries_mutex_);
-          auto q_it = getQueryByExternalId(ext_resource_id);
-          if(q_it->failed_)
-          {
-            res.rmp.error_stack += q_it->getMsg().response.rmp.error_stack;
-          }
-          queries_.erase(q_it);
-          queries_mutex_.unlock();
-        }
-        catch(error::ErrorStack& query_error)
-        {
-          // just send the error when trying to  and continue
-          queries_mutex_.unlock();
-          SEND_ERROR(FORWARD_ERROR(query_error));
-        }
-        this->deactivateServer();
-        active_server_mutex_.unlock();
-        res.rmp.code = status_codes::FAILED;
-        res.rmp.error_stack =
-            CREATE_ERROR(error::Code::RMP_FAIL, "Unexpected error was thrown from "
-                                                           "owner's load callback.");
-        return true;
-      }
+    // The queries are not locked during the callback so that owner is able to use rmp inside the
+    // callback and other load requests can be served in parallel.
+    loading_queries_.insert(int_resource_id);
+    queries_lock.unlock();
+
+    // call owner's registered callback within the load context of the new query. When a client
+    // call is made from the callback, the binding between this query and the new loaded resources
+    // is made automatically
+    bool callback_failed = false;
+    try
+    {
+      typename BaseResourceServer<Owner>::LoadContextGuard context_guard(this, int_resource_id);
+      (owner_->*load_callback_)(req, res);
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      // callback threw an exeption, clean up below and return.
+      callback_failed = true;
+      res.rmp.error_stack = FORWARD_ERROR(error_stack);
+    }
+    catch(...)
+    {
+      // callback threw an unknown exeption, prevent this for reaching ros callback.
+      callback_failed = true;
+      res.rmp.error_stack =
+          CREATE_ERROR(error::Code::RMP_FAIL, "Unexpected error was thrown from "
+                                                         "owner's load callback.");
+    }
 
-      // restore active server to NULL in resource manager
-      this->deactivateServer();
-      active_server_mutex_.unlock();
+    queries_lock.lock();
+    loading_queries_.erase(int_resource_id);
+    load_finished_cv_.notify_all();
 
-      waitForLock(queries_mutex_);
+    if (callback_failed)
+    {
       try
       {
-        // verify that our query is still on the list
-        auto q_it = std::find_if(queries_.begin(), queries_.end(),
-            [&](const ServerQuery<ServiceType>& q) -> bool {
-            return q.hasExternalResource(ext_resource_id);
-            });
-        if (q_it != queries_.end())
-        {
-          // First, make sure the internal_resource_id for that query is not changed.
-          res.rmp.resource_id = int_resource_id;
-
-          // check if the query has not been marked as failed while we were dealing with the owner's callback
-          // if it failed, remove the query. 
-          if(q_it->failed_)
-          {
-            // TODO Potentially some resources were sucessfully loaded, SEND UNLOAD REQUEST TO ALL
-            // LINKED CLIENTS
-            res.rmp.error_stack += q_it->getMsg().response.rmp.error_stack;
-            queries_.erase(q_it);
-            queries_mutex_.unlock();
-            res.rmp.code = status_codes::FAILED;
-            return true;
-          }
-
-          // update the query with the response message filled in the callback
-          q_it->setMsgResponse(res);
-
-          // prepare the response for the client
-          res.rmp.resource_id = ext_resource_id;
-
-          //res.rmp.code = status_codes::OK;
-          //res.rmp.message = "New resource sucessfully loaded.";
-        }
-        else
+        auto q_it = getQueryByExternalId(ext_resource_id);
+        if(q_it->second.failed_)
         {
-          queries_mutex_.unlock();
-          res.rmp.code = status_codes::FAILED;
-          res.rmp.error_stack = CREATE_ERROR(error::Code::RMP_FAIL, "Query got missing during owners callback, oh well...");
-          return true;
+          res.rmp.error_stack += q_it->second.getMsg().response.rmp.error_stack;
         }
+        eraseQuery(q_it);
       }
-      catch(error::ErrorStack& error_stack)
+      catch(error::ErrorStack& query_error)
       {
-        queries_mutex_.unlock();
-        res.rmp.code = status_codes::FAILED;
-        res.rmp.error_stack = FORWARD_ERROR(error_stack);
-        return true;
+        // just send the error and continue
+        SEND_ERROR(FORWARD_ERROR(query_error));
       }
-
+      res.rmp.code = status_codes::FAILED;
+      return true;
     }
-    else
+
+    try
     {
-      try
+      // verify that our query is still on the list
+      auto q_it = findQueryByExternalId(ext_resource_id);
+      if (q_it == queries_.end())
       {
-        // found equal request, simply reqister this in the query
-        // and respond with previous data and a unique resoure_id.
-        TEMOTO_DEBUG("Existing query, linking to the found query.");
-        queries_.back().addExternalResource(ext_resource_id, req.rmp.status_topic);
-        res = found_query->getMsg().response;
-        res.rmp.resource_id = ext_resource_id;
-        //res.rmp.code = status_codes::OK;
-        //res.rmp.message = "Sucessfully sharing existing resource.";
+        res.rmp.code = status_codes::FAILED;
+        res.rmp.error_stack = CREATE_ERROR(error::Code::RMP_FAIL, "Query got missing during owners callback, oh well...");
+        return true;
       }
-      catch(error::ErrorStack& error_stack)
+
+      // First, make sure the internal_resource_id for that query is not changed.
+      res.rmp.resource_id = int_resource_id;
+
+      // check if the query has not been marked as failed while we were dealing with the owner's callback
+      // if it failed, remove the query.
+      if(q_it->second.failed_)
       {
-        queries_mutex_.unlock();
+        // TODO Potentially some resources were sucessfully loaded, SEND UNLOAD REQUEST TO ALL
+        // LINKED CLIENTS
+        res.rmp.error_stack += q_it->second.getMsg().response.rmp.error_stack;
+        eraseQuery(q_it);
         res.rmp.code = status_codes::FAILED;
-        res.rmp.error_stack = FORWARD_ERROR(error_stack);
         return true;
       }
-    }
 
-    // release the queries lock
-    queries_mutex_.unlock();
+      // update the query with the response message filled in the callback
+      q_it->second.setMsgResponse(res);
+
+      // prepare the response for the client
+      res.rmp.resource_id = ext_resource_id;
+
+      //res.rmp.code = status_codes::OK;
+      //res.rmp.message = "New resource sucessfully loaded.";
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      res.rmp.code = status_codes::FAILED;
+      res.rmp.error_stack = FORWARD_ERROR(error_stack);
+    }
 
     return true;
   }
 
+  std::future<temoto_2::RMPResponse> loadSerialized(const std::vector<uint8_t>& serialized_req,
+                                                    std::vector<uint8_t>& serialized_res)
+  {
+    auto load = std::make_shared<std::packaged_task<temoto_2::RMPResponse()>>(
+        [this, &serialized_req, &serialized_res] {
+          return loadSerializedNow(serialized_req, serialized_res);
+        });
+    std::future<temoto_2::RMPResponse> result = load->get_future();
+    load_cb_queue_.addCallback(boost::make_shared<QueuedLoad>(load));
+    return result;
+  }
+
   // This function is called from resource manager when /unload request arrives
   // (e.g. when some external client is being destroyed)
   // We look up the query that contains given external resource id and send unload to all internal
@@ -314,110 +306,107 @@ public:
   {
     // find first query that contains resource that should be unloaded
     const temoto_id::ID ext_rid = req.resource_id;
-    waitForLock(queries_mutex_);
-    const auto found_query_it =
-        std::find_if(queries_.begin(), queries_.end(),
-                     [ext_rid](const ServerQuery<ServiceType>& query) -> bool {
-                       return query.hasExternalResource(ext_rid);
-                     });
-    if (found_query_it != queries_.end())
+    std::unique_lock<std::shared_timed_mutex> queries_lock(queries_mutex_);
+    const auto found_query_it = findQueryByExternalId(ext_rid);
+    if (found_query_it == queries_.end())
     {
+      return;
+    }
 
-      TEMOTO_DEBUG("Query with ext id %d was found", ext_rid);
-      TEMOTO_DEBUG("internal resource count: %lu", found_query_it->getLinkedResources().size());
+    TEMOTO_DEBUG("Query with ext id %d was found", ext_rid);
+    TEMOTO_DEBUG("internal resource count: %lu",
+                 found_query_it->second.getLinkedResources().size());
 
-      // Query found, try to remove external client from it.
-      size_t resources_left = found_query_it->removeExternalResource(ext_rid);
-      if (resources_left == 0)
-      {
-        // last resource removed, execute owner's unload callback and remove the query from our list
-        typename ServiceType::Request orig_req = found_query_it->getMsg().request;
-        typename ServiceType::Response orig_res = found_query_it->getMsg().response;
-        error::ErrorStack unload_errs; // buffer for all unload-related errors
-        try
-        {
-          (owner_->*unload_callback_)(orig_req, orig_res);
-        }
-        catch(error::ErrorStack& error_stack)
-        {
-          unload_errs += error_stack;
-        }
-
-        // Send unload command to all linked internal clients...
-        for (auto& set_el : found_query_it->getLinkedResources())
-        {
-          try
-          {
-            this->resource_manager_.unloadClientResource(set_el);
-          }
-          catch (error::ErrorStack& es)
-          {
-            unload_errs += es; //append error to the unload error stack
-          }
-        }
+    // Query found, try to remove external client from it.
+    size_t resources_left = found_query_it->second.removeExternalResource(ext_rid);
+    external_index_.erase(ext_rid);
+    if (resources_left != 0)
+    {
+      return;
+    }
 
-        // forward the stack if any error occured
-        if (unload_errs.size())
-        {
-            res.code = status_codes::FAILED;
-            res.error_stack += FORWARD_ERROR(unload_errs);
-        }
+    // last resource removed, remove the query from our list, even when some of the unload calls
+    // below fail. The owner's callback and the unloading of linked clients are executed without
+    // holding the queries, as these lock the clients of the resource manager.
+    // \TODO: This potentially causes zombie resources. How to manage these?
+    typename ServiceType::Request orig_req = found_query_it->second.getMsg().request;
+    typename ServiceType::Response orig_res = found_query_it->second.getMsg().response;
+    const std::set<temoto_id::ID> linked_resources = found_query_it->second.getLinkedResources();
+    eraseQuery(found_query_it);
+    queries_lock.unlock();
+
+    error::ErrorStack unload_errs; // buffer for all unload-related errors
+    try
+    {
+      (owner_->*unload_callback_)(orig_req, orig_res);
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      unload_errs += error_stack;
+    }
 
-        // Finally, remove the found query, even when some of the unload calls failed.
-        // \TODO: The next line potentially causes zombie resources. How to manage these?
-        queries_.erase(found_query_it);
+    // Send unload command to all linked internal clients...
+    for (auto& set_el : linked_resources)
+    {
+      try
+      {
+        this->resource_manager_.unloadClientResource(set_el);
       }
+      catch (error::ErrorStack& es)
+      {
+        unload_errs += es; //append error to the unload error stack
+      }
+    }
+
+    // forward the stack if any error occured
+    if (unload_errs.size())
+    {
+        res.code = status_codes::FAILED;
+        res.error_stack += FORWARD_ERROR(unload_errs);
     }
-    queries_mutex_.unlock();
   }
 
-  // go over queries_ and look for the linked resource_id
+  // look for the resource_id from the queries and from the linked resources
   bool hasInternalResource(temoto_id::ID resource_id) const
   {
-    auto found_q = find_if(queries_.begin(), queries_.end(),
-                           [&](const ServerQuery<ServiceType>& q) -> bool {
-                             return q.hasInternalResource(resource_id);
-                           });
-    return found_q != queries_.end();
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
+    return queries_.find(resource_id) != queries_.end() ||
+           linked_index_.find(resource_id) != linked_index_.end();
   }
 
   bool isLinkedTo(temoto_id::ID resource_id) const
   {
-    auto found_q = find_if(queries_.begin(), queries_.end(),
-                           [&](const ServerQuery<ServiceType>& q) -> bool {
-                             return q.isLinkedTo(resource_id);
-                           });
-    return found_q != queries_.end();
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
+    return linked_index_.find(resource_id) != linked_index_.end();
   }
 
   bool hasExternalResource(temoto_id::ID external_resource_id) const
   {
-    auto found_q = find_if(queries_.begin(), queries_.end(),
-                           [&](const ServerQuery<ServiceType>& q) -> bool {
-                             return q.hasExternalResource(external_resource_id);
-                           });
-    return found_q != queries_.end();
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
+    return external_index_.find(external_resource_id) != external_index_.end();
+  }
+
+  // check if the query of given internal resource is still in the middle of owner's load callback
+  bool isLoading(temoto_id::ID internal_resource_id) const
+  {
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
+    const auto q_it = findQueryByInternalId(internal_resource_id);
+    return q_it != queries_.end() && loading_queries_.find(q_it->first) != loading_queries_.end();
   }
 
   // concatenate pairs of <external_resource_id, status_topic> of the query where internal id is found.
   std::vector<std::pair<temoto_id::ID, std::string>>
   getExternalResourcesByInternalId(temoto_id::ID internal_resource_id)
   {
-    waitForLock(queries_mutex_);
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
 
     std::vector<std::pair<temoto_id::ID, std::string>> ext_resources;
-    for (const auto& q : queries_)
+    const auto q_it = findQueryByInternalId(internal_resource_id);
+    if (q_it != queries_.end())
     {
-      if (q.hasInternalResource(internal_resource_id))
-      {
-        for (auto resource : q.getExternalResources())
-        {
-          ext_resources.push_back(resource);
-        }
-        break; // no need to look any further
-      }
+      const auto& resources = q_it->second.getExternalResources();
+      ext_resources.assign(resources.begin(), resources.end());
     }
-    queries_mutex_.unlock();
     return ext_resources;
   }
   
@@ -425,29 +414,22 @@ public:
   std::vector<std::pair<temoto_id::ID, std::string>>
   getExternalResourcesByExternalId(temoto_id::ID external_resource_id)
   {
-    waitForLock(queries_mutex_);
+    std::shared_lock<std::shared_timed_mutex> lock(queries_mutex_);
 
     std::vector<std::pair<temoto_id::ID, std::string>> ext_resources;
-    for (const auto& q : queries_)
+    const auto q_it = findQueryByExternalId(external_resource_id);
+    if (q_it != queries_.end())
     {
-      if (q.hasExternalResource(external_resource_id))
-      {
-        for (auto resource : q.getExternalResources())
-        {
-          ext_resources.push_back(resource);
-        }
-        break;  // no need to look any further
-      }
+      const auto& resources = q_it->second.getExternalResources();
+      ext_resources.assign(resources.begin(), resources.end());
     }
-    queries_mutex_.unlock();
     return ext_resources;
   }
 
-  typename std::vector<ServerQuery<ServiceType>>::iterator getQueryByExternalId(temoto_id::ID ext_id)
+  // Expects the queries_mutex_ to be locked by the caller.
+  typename QueryMap::iterator getQueryByExternalId(temoto_id::ID ext_id)
   {
-    auto q_it =std::find_if(queries_.begin(), queries_.end(), [&](const ServerQuery<ServiceType>& q) -> bool {
-      return q.hasExternalResource(ext_id);
-    });
+    auto q_it = findQueryByExternalId(ext_id);
     if (q_it == queries_.end())
     {
       throw CREATE_ERROR(error::Code::RMP_FAIL, "External id not found from any queries.");
@@ -455,32 +437,134 @@ public:
     return q_it;
   }
 
-  void waitForLock(std::mutex& m)
+  void setFailedFlag(temoto_id::ID internal_resource_id, error::ErrorStack& error_stack)
   {
-    while (!m.try_lock())
+    std::lock_guard<std::shared_timed_mutex> lock(queries_mutex_);
+    const auto found_query_it = findQueryByInternalId(internal_resource_id);
+    if (found_query_it != queries_.end())
     {
-      TEMOTO_DEBUG("Waiting for lock()");
-      ros::Duration(0.01).sleep();  // sleep for few ms
+      // Query found, mark query as failed and append why did it fail. Failed queries are not
+      // shared with new requests, hence the query is also dropped from the request index.
+      found_query_it->second.setFailed(error_stack);
+      unindexRequest(found_query_it);
     }
   }
 
-  void setFailedFlag(temoto_id::ID internal_resource_id, error::ErrorStack& error_stack)
+private:
+  /**
+   * @brief Runs a load of loadSerialized() when the load queue gets to it
+   */
+  class QueuedLoad : public ros::CallbackInterface
   {
-    waitForLock(queries_mutex_);
-    const auto found_query_it =
-        std::find_if(queries_.begin(), queries_.end(),
-                     [internal_resource_id](const ServerQuery<ServiceType>& query) -> bool {
-                       return query.hasInternalResource(internal_resource_id);
-                     });
-    if (found_query_it != queries_.end())
+  public:
+    QueuedLoad(std::shared_ptr<std::packaged_task<temoto_2::RMPResponse()>> load) : load_(load)
+    {
+    }
+
+    CallResult call()
+    {
+      (*load_)();
+      return Success;
+    }
+
+  private:
+    std::shared_ptr<std::packaged_task<temoto_2::RMPResponse()>> load_;
+  };
+
+  temoto_2::RMPResponse loadSerializedNow(const std::vector<uint8_t>& serialized_req,
+                                          std::vector<uint8_t>& serialized_res)
+  {
+    typename ServiceType::Request req;
+    typename ServiceType::Response res;
+    try
     {
-      // Query found, mark query as failed and append why did it fail.
-      found_query_it->setFailed(error_stack);
+      deserializeMessage(serialized_req, req);
     }
-    queries_mutex_.unlock();
+    catch (std::exception& e)
+    {
+      res.rmp.code = status_codes::FAILED;
+      res.rmp.error_stack =
+          CREATE_ERROR(error::Code::RMP_FAIL, "Unable to deserialize the request: %s", e.what());
+      return res.rmp;
+    }
+
+    wrappedLoadCallback(req, res);
+    serialized_res = serializeMessage(res);
+    return res.rmp;
+  }
+
+  // Find a query that is not failed and has equal request. Fingerprint narrows the search down to
+  // (usually) a single candidate, which is then confirmed with operator==.
+  typename QueryMap::iterator findQueryByRequest(const typename ServiceType::Request& req)
+  {
+    auto range = request_index_.equal_range(rmp::fingerprint(req));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      auto q_it = queries_.find(it->second);
+      if (q_it != queries_.end() && !q_it->second.failed_ && q_it->second.getMsg().request == req)
+      {
+        return q_it;
+      }
+    }
+    return queries_.end();
+  }
+
+  typename QueryMap::iterator findQueryByExternalId(temoto_id::ID ext_id)
+  {
+    auto ext_it = external_index_.find(ext_id);
+    if (ext_it == external_index_.end())
+    {
+      return queries_.end();
+    }
+    return queries_.find(ext_it->second);
+  }
+
+  // Internal id is either the id of the query itself or one of its linked resources.
+  typename QueryMap::iterator findQueryByInternalId(temoto_id::ID int_id)
+  {
+    auto link_it = linked_index_.find(int_id);
+    return queries_.find(link_it == linked_index_.end() ? int_id : link_it->second);
+  }
+
+  typename QueryMap::const_iterator findQueryByInternalId(temoto_id::ID int_id) const
+  {
+    auto link_it = linked_index_.find(int_id);
+    return queries_.find(link_it == linked_index_.end() ? int_id : link_it->second);
+  }
+
+  void unindexRequest(typename QueryMap::iterator q_it)
+  {
+    auto range = request_index_.equal_range(q_it->second.getFingerprint());
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second == q_it->first)
+      {
+        request_index_.erase(it);
+        return;
+      }
+    }
+  }
+
+  // Remove the query together with all the index entries pointing to it.
+  void eraseQuery(typename QueryMap::iterator q_it)
+  {
+    if (q_it == queries_.end())
+    {
+      return;
+    }
+    unindexRequest(q_it);
+    for (const auto& ext_resource : q_it->second.getExternalResources())
+    {
+      external_index_.erase(ext_resource.first);
+    }
+    for (const auto& linked_id : q_it->second.getLinkedResources())
+    {
+      linked_index_.erase(linked_id);
+    }
+    loading_queries_.erase(q_it->first);
+    queries_.erase(q_it);
   }
 
-private:
   Owner* owner_;
   LoadCbFuncType load_callback_;
   UnloadCbFuncType unload_callback_;
@@ -490,11 +574,18 @@ private:
   ros::CallbackQueue load_cb_queue_;
   ros::AsyncSpinner load_spinner_;
 
-  std::vector<ServerQuery<ServiceType>> queries_;
+  QueryMap queries_;  ///< Queries by their internal resource id
+
+  // Indexes for the queries_, these are kept consistent by the load, unload and failure handlers.
+  std::unordered_multimap<Fingerprint, temoto_id::ID> request_index_;  ///< request hash -> query
+  std::unordered_map<temoto_id::ID, temoto_id::ID> external_index_;    ///< external id -> query
+  std::unordered_map<temoto_id::ID, temoto_id::ID> linked_index_;      ///< linked id -> query
+
+  std::unordered_set<temoto_id::ID> loading_queries_;  ///< queries in owner's load callback
 
-  // mutexes
-  std::mutex queries_mutex_;
-  std::mutex active_server_mutex_;
+  // mutexes, readers of the queries take a shared lock
+  mutable std::shared_timed_mutex queries_mutex_;
+  std::condition_variable_any load_finished_cv_;  ///< notified when a query leaves loading_queries_
 };
 }
 
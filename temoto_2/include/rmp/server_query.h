@@ -9,6 +9,7 @@
 #include "common/temoto_id.h"
 #include "common/base_subsystem.h"
 #include "temoto_error/temoto_error.h"
+#include "rmp/request_fingerprint.h"
 
 namespace rmp
 {
@@ -19,7 +20,7 @@ class ServerQuery : public BaseSubsystem
 public:
   // special constructor for resource server
   ServerQuery(const typename ServiceMsgType::Request& req, temoto_id::ID internal_id, const BaseSubsystem& b)
-    : BaseSubsystem(b), failed_(false)
+    : BaseSubsystem(b), failed_(false), fingerprint_(rmp::fingerprint(req))
   {
     class_name_ = __func__;
 
@@ -85,6 +86,11 @@ public:
     return msg_;
   }
 
+  Fingerprint getFingerprint() const
+  {
+    return fingerprint_;
+  }
+
   temoto_id::ID getInternalId() const
   {
     return msg_.response.rmp.resource_id;
@@ -128,6 +134,8 @@ private:
   ServiceMsgType msg_;  /// Store request and response, note that RMP specific fields (resource_id,
                         /// topic, ...) are related to first query and are not intended to be used
                         /// herein.
+
+  Fingerprint fingerprint_;  /// Hash of the request part, used by the server for indexing.
 };
 }
 
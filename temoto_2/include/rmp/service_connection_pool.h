@@ -0,0 +1,193 @@
+#ifndef SERVICE_CONNECTION_POOL_H
+#define SERVICE_CONNECTION_POOL_H
+
+#include "ros/ros.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace rmp
+{
+/**
+ * @brief Keeps persistent connections to services, so that repeated calls skip the master lookup
+ * and the connection setup. A connection serves one call at a time, concurrent calls to the same
+ * service get connections of their own. Broken connections are replaced on the next call and
+ * connections which have not been used for a while are closed.
+ */
+class ServiceConnectionPool
+{
+public:
+  ServiceConnectionPool(std::chrono::seconds idle_timeout = std::chrono::seconds(60))
+    : idle_timeout_(idle_timeout), hits_(0), misses_(0)
+  {
+  }
+
+  ~ServiceConnectionPool()
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    for (auto& idle_connections : idle_connections_)
+    {
+      for (auto& connection : idle_connections.second)
+      {
+        connection.client.shutdown();
+      }
+    }
+  }
+
+  /**
+   * @brief Calls the service over a pooled connection. A failed call over a reused connection may
+   * have reached the server before the connection broke, hence it is retried over a new connection
+   * only when the call is idempotent. Otherwise the idle connections of the service are dropped,
+   * as the server may have been restarted, and the failure is returned to the caller.
+   * @param idempotent True if executing the call twice has the same effect as executing it once.
+   * @return False if the service call failed.
+   */
+  template <class ServiceType>
+  bool call(const std::string& service_name, ServiceType& msg, bool idempotent = false)
+  {
+    Key key(service_name, typeid(ServiceType).name());
+    bool reused = false;
+    ros::ServiceClient client = acquire<ServiceType>(key, reused);
+    if (client.call(msg))
+    {
+      release(key, client);
+      return true;
+    }
+    client.shutdown();
+
+    if (!reused)
+    {
+      return false;
+    }
+
+    if (!idempotent)
+    {
+      dropIdle(key);
+      return false;
+    }
+
+    misses_++;
+    client = nh_.serviceClient<ServiceType>(service_name, true);
+    if (client.call(msg))
+    {
+      release(key, client);
+      return true;
+    }
+    client.shutdown();
+    return false;
+  }
+
+  /// Number of calls which were served over an existing connection
+  uint64_t getHits() const
+  {
+    return hits_;
+  }
+
+  /// Number of calls which had to set up a new connection
+  uint64_t getMisses() const
+  {
+    return misses_;
+  }
+
+private:
+  struct Connection
+  {
+    ros::ServiceClient client;
+    std::chrono::steady_clock::time_point last_used;
+  };
+
+  // Connections are kept by the service name and type
+  typedef std::pair<std::string, std::string> Key;
+
+  template <class ServiceType>
+  ros::ServiceClient acquire(const Key& key, bool& reused)
+  {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      evictIdle();
+      auto idle_it = idle_connections_.find(key);
+      while (idle_it != idle_connections_.end() && !idle_it->second.empty())
+      {
+        ros::ServiceClient client = idle_it->second.back().client;
+        idle_it->second.pop_back();
+        if (client.isValid())
+        {
+          hits_++;
+          reused = true;
+          return client;
+        }
+        client.shutdown();
+      }
+    }
+
+    misses_++;
+    reused = false;
+    return nh_.serviceClient<ServiceType>(key.first, true);
+  }
+
+  void release(const Key& key, const ros::ServiceClient& client)
+  {
+    Connection connection;
+    connection.client = client;
+    connection.last_used = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    idle_connections_[key].push_back(connection);
+  }
+
+  void dropIdle(const Key& key)
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    auto idle_it = idle_connections_.find(key);
+    if (idle_it == idle_connections_.end())
+    {
+      return;
+    }
+    for (auto& connection : idle_it->second)
+    {
+      connection.client.shutdown();
+    }
+    idle_connections_.erase(idle_it);
+  }
+
+  // Expects the pool_mutex_ to be locked by the caller.
+  void evictIdle()
+  {
+    auto now = std::chrono::steady_clock::now();
+    for (auto key_it = idle_connections_.begin(); key_it != idle_connections_.end();)
+    {
+      auto& connections = key_it->second;
+      for (auto c_it = connections.begin(); c_it != connections.end();)
+      {
+        if (now - c_it->last_used > idle_timeout_)
+        {
+          c_it->client.shutdown();
+          c_it = connections.erase(c_it);
+        }
+        else
+        {
+          ++c_it;
+        }
+      }
+      key_it = connections.empty() ? idle_connections_.erase(key_it) : std::next(key_it);
+    }
+  }
+
+  std::chrono::seconds idle_timeout_;
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+
+  std::map<Key, std::vector<Connection>> idle_connections_;
+  std::mutex pool_mutex_;
+  ros::NodeHandle nh_;
+};
+
+}  // namespace rmp
+
+#endif
@@ -54,17 +54,26 @@ private:
   void waitForHardware();
   void loadUrdf();
   void loadManipulation();
-  void loadManipulationDriver();
   void loadNavigation();
-  void loadNavigationDriver();
 
-  temoto_id::ID rosExecute(const std::string& package_name, const std::string& executable,
-                  const std::string& args = "");
+  /**
+   * @brief Loads the requested drivers which are not loaded yet, with a single request to the
+   * process manager.
+   */
+  void loadDrivers(bool manipulation_driver, bool navigation_driver);
 
-  void waitForParam(const std::string& param, temoto_id::ID interrupt_res_id);
-  void waitForTopic(const std::string& topic, temoto_id::ID interrupt_res_id);
+  /**
+   * @brief Executes the program with the readiness conditions of the given request. Returns once
+   * the process manager considers the program ready.
+   */
+  temoto_id::ID rosExecute(const std::string& package_name, const std::string& executable,
+                           const std::string& args, temoto_2::LoadProcess& load_proc_srvc);
 
-  bool isTopicAvailable(const std::string& topic);
+  /**
+   * @brief Executes several programs in the robot namespace with a single request. The programs
+   * are started concurrently, if any of them fails, none of them is left running.
+   */
+  void rosExecute(std::vector<temoto_2::LoadProcess>& load_proc_srvcs);
 
   // General
   //  std::string log_class_, log_subsys_, log_group_;
@@ -93,6 +93,8 @@ private:
 
   void advertiseConfigs(RobotConfigs configs);
 
+  static PayloadType getSyncPayload(RobotConfigPtr config);
+
   RobotConfigs parseRobotConfigs(const YAML::Node& config);
 
   RobotConfigPtr findRobot(const std::string& robot_name, const RobotConfigs& robot_infos);
@@ -111,6 +113,11 @@ private:
   typedef std::map<temoto_id::ID, RobotPtr> Robots;
   RobotPtr active_robot_;
   Robots loaded_robots_;
+
+  // Guards active_robot_ and loaded_robots_, the robots are loaded and unloaded in parallel
+  std::mutex robots_mutex_;
+
+  RobotPtr getActiveRobot();
   RobotConfigs local_configs_;
   RobotConfigs remote_configs_;
 
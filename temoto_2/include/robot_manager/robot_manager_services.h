@@ -2,6 +2,7 @@
 #define ROBOT_MANAGER_SERVICES_H
 
 #include <string>
+#include "rmp/request_fingerprint.h"
 #include "temoto_2/RobotLoad.h"
 #include "temoto_2/RobotPlan.h"
 #include "temoto_2/RobotExecute.h"
@@ -37,4 +38,19 @@ static bool operator==(const temoto_2::RobotLoad::Request& r1,
 {
   return (r1.robot_name == r2.robot_name);
 }
+
+// Hash of the fields compared by the operator== above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::RobotLoad::Request>
+{
+  Fingerprint operator()(const temoto_2::RobotLoad::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.robot_name);
+    return seed;
+  }
+};
+}
 #endif
@@ -1,18 +1,17 @@
 #ifndef SENSOR_INFO_REGISTRY_H
 #define SENSOR_INFO_REGISTRY_H
 
+#include "common/info_registry.h"
 #include "sensor_manager/sensor_info.h"
 #include "temoto_2/LoadSensor.h"
 
-#include <mutex>
-
 namespace sensor_manager
 {
 
 /**
  * @brief Class that maintains and handles the sensor info objects
  */
-class SensorInfoRegistry
+class SensorInfoRegistry : public common::InfoRegistry<SensorInfo>
 {
 public:
 
@@ -43,34 +42,15 @@ public:
 
   bool updateRemoteSensor(const SensorInfo& si, bool advertised = false);
 
-  const std::vector<SensorInfo>& getLocalSensors() const;
-
-  const std::vector<SensorInfo>& getRemoteSensors() const;
-
-private:
-
   /**
-   * @brief findSensor
-   * @param req
-   * @param sensors
-   * @return
+   * @brief Returns a copy of the local sensors, so that it can be used without holding the lock.
    */
-  bool findSensor( temoto_2::LoadSensor::Request& req
-                 , const std::vector<SensorInfo>& sensors
-                 , SensorInfo& si_ret ) const;
-
-  bool findSensor( const SensorInfo& si
-                 , const std::vector<SensorInfo>& sensors
-                 , SensorInfo& si_ret ) const;
+  std::vector<SensorInfo> getLocalSensors() const;
 
-  /// List of all locally defined sensors.
-  std::vector<SensorInfo> local_sensors_;
-
-  /// List of all sensors in remote managers.
-  std::vector<SensorInfo> remote_sensors_;
-
-  /// Mutex for protecting sensor info vectors from data races
-  mutable std::mutex read_write_mutex;
+  /**
+   * @brief Returns a copy of the remote sensors, so that it can be used without holding the lock.
+   */
+  std::vector<SensorInfo> getRemoteSensors() const;
 };
 
 } // sensor_manager namespace
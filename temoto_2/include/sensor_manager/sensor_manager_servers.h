@@ -10,6 +10,8 @@
 #include "std_msgs/String.h"
 #include "common/temoto_id.h"
 
+#include <mutex>
+
 namespace sensor_manager
 {
 
@@ -91,6 +93,9 @@ private:
   /// List of allocated sensors.
   std::map<temoto_id::ID, SensorInfo> allocated_sensors_;
 
+  /// Guards allocated_sensors_, the load callbacks of the sensors are executed in parallel.
+  std::mutex allocated_sensors_mutex_;
+
 }; // SensorManagerServers
 
 } // sensor_manager namespace
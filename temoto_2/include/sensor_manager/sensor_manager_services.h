@@ -65,4 +65,22 @@ static bool operator==(const temoto_2::LoadSensor::Request& r1,
   // The sensor infos are equal
   return true;
 }
+
+// Hash of the fields compared by the operator== above.
+namespace rmp
+{
+template <>
+struct RequestFingerprint<temoto_2::LoadSensor::Request>
+{
+  Fingerprint operator()(const temoto_2::LoadSensor::Request& r) const
+  {
+    Fingerprint seed = 0;
+    hashCombine(seed, r.sensor_type);
+    hashCombine(seed, r.package_name);
+    hashCombine(seed, r.executable);
+    hashCombineUnordered(seed, r.output_topics);
+    return seed;
+  }
+};
+}
 #endif
@@ -37,7 +37,7 @@ public:
    * @brief Advertises a sensor to other sensor snoopers.
    * @param si Sensor to advertise.
    */
-  void advertiseSensor(SensorInfo& si) const;
+  void advertiseSensor(const SensorInfo& si) const;
 
   /**
    * @brief Advertises all sensors in the local system.
@@ -62,6 +62,16 @@ public:
 
 private:
 
+  /**
+   * @brief Returns the key which identifies the sensor in the synchronized configuration.
+   */
+  static std::string getSyncKey(const SensorInfo& si);
+
+  /**
+   * @brief Returns the synchronized configuration of a single sensor.
+   */
+  static PayloadType getSyncPayload(const SensorInfo& si);
+
   /**
    * @brief A callback function that is called when other instance of temoto has advertised
    * its sensors.
@@ -70,14 +80,7 @@ private:
    */
   void syncCb(const temoto_2::ConfigSync& msg, const PayloadType& payload);
 
-  /**
-   * @brief A timer event callback function which checks if local sensor info entries have been
-   * updated and if so, then advertises local sensors via #advertiseSensor.
-   * @param e
-   */
-  void updateMonitoringTimerCb(const ros::TimerEvent &e);
-
-  /// NodeHandle for the timer
+  /// NodeHandle for the synchronizer
   ros::NodeHandle nh_;
 
   /// Object that handles sensor info syncronization.
@@ -89,13 +92,6 @@ private:
   /// Used for managing snooper agents.
   TTP::TaskManager action_engine_;
 
-  /**
-   * @brief Timer for checking local sensor info updates (timer event will trigger the #updateMonitoringTimerCb).
-   * The local sensor info objects are asynchronously updated/created by snooper agents and this timer
-   * is responsible for checking if the updates are advertised to other instances of temoto.
-   */
-  ros::Timer update_monitoring_timer_;
-
 };
 
 } // sensor_manager namespace
@@ -110,6 +110,16 @@ enum class Code : int
   NO_TRACKERS_FOUND,
   UNKNOWN_OBJECT,
 
+  // The codes are sent as integers to other temoto instances, hence new codes are appended here,
+  // so that the values of the codes above do not change
+
+  // Process manager
+  PROCESS_NOT_READY,  // Process did not meet its readiness conditions
+
+  // TTP
+  SFT_QUEUE_FULL,     // Too many semantic frame trees are waiting for execution
+  TASK_STOP_TIMEOUT,  // Task did not stop within the deadline
+
   UNHANDLED_EXCEPTION  // Unhandled exception
 };
 
@@ -52,7 +52,7 @@ void Subject::addData(std::string datatype, float data)
                        "'.");
   }
 
-  data_.emplace_back(datatype, boost::any_cast<float>(data));
+  data_.emplace_back(std::move(datatype), data);
 }
 
 /*
@@ -75,15 +75,15 @@ void Subject::addData(std::string datatype, std::string data)
     throw std::string("A string is not a numerical datatype.");
   }
 
-  data_.emplace_back(datatype, boost::any_cast<std::string>(data));
+  data_.emplace_back(std::move(datatype), std::move(data));
 }
 
 /*
  * Add data - any type
  */
-void Subject::addData(std::string datatype, boost::any data)
+void Subject::addData(std::string datatype, DataValue data)
 {
-  data_.emplace_back(datatype, data);
+  data_.emplace_back(std::move(datatype), std::move(data));
 }
 
 /*
@@ -95,10 +95,11 @@ Subject getSubjectByType(const std::string& type, Subjects& subjects)
   {
     if(sub_it->type_ == type)
     {
-      Subject ret_subject = *sub_it;
+      // The subjects behind it are moved in place, nothing is copied
+      Subject ret_subject = std::move(*sub_it);
       subjects.erase(sub_it);
 
-      return std::move(ret_subject);
+      return ret_subject;
     }
   }
   throw std::string("Subject of type '" + type + "' was not found.");
@@ -109,30 +110,35 @@ Subject getSubjectByType(const std::string& type, Subjects& subjects)
  */
 bool operator==(const std::vector<Subject>& subs_1, const std::vector<Subject>& subs_2)
 {
-  // create a copy of subs_2
-  std::vector<Subject> subs_2_c = subs_2;
+  // Each subject of subs_2 can match only once
+  std::vector<bool> subs_2_used(subs_2.size(), false);
 
   for (auto& sub_1 : subs_1)
   {
     bool subject_match = false;
-    for (unsigned int i=0; i<subs_2_c.size(); i++)
+    for (unsigned int i=0; i<subs_2.size(); i++)
     {
+      if (subs_2_used[i])
+      {
+        continue;
+      }
+
       // Check for type match
-      if (sub_1.type_ != subs_2_c[i].type_)
+      if (sub_1.type_ != subs_2[i].type_)
       {
         //std::cout << "    subject types do not match\n";
         continue;
       }
 
       // Check data size
-      if (sub_1.data_.size() != subs_2_c[i].data_.size())
+      if (sub_1.data_.size() != subs_2[i].data_.size())
       {
         //std::cout << "    data size does not match\n";
         continue;
       }
 
       // Check data
-      if (sub_1.data_ != subs_2_c[i].data_)
+      if (sub_1.data_ != subs_2[i].data_)
       {
         //std::cout << "    data does not match\n";
         continue;
@@ -140,7 +146,7 @@ bool operator==(const std::vector<Subject>& subs_1, const std::vector<Subject>&
 
       //std::cout << "    we got a winner\n";
       subject_match = true;
-      subs_2_c.erase(subs_2_c.begin() + i);
+      subs_2_used[i] = true;
       break;
     }
     if (subject_match != true)
@@ -246,8 +252,8 @@ bool operator==(const Data& d1, const Data& d2)
 // Data vector comparison operator
 bool operator==(const std::vector<Data>& dv1, const std::vector<Data>& dv2)
 {
-  // Create a copy of dv2
-  std::vector<Data> dv2_c = dv2;
+  // Each data of dv2 can match only once
+  std::vector<bool> dv2_used(dv2.size(), false);
 
   //std::cout << "DDDDD 0 " << std::endl;
 
@@ -260,11 +266,11 @@ bool operator==(const std::vector<Data>& dv1, const std::vector<Data>& dv2)
     for (unsigned int i=0; i<dv2.size(); i++)
     {
       //std::cout << "DDDDD 2 " << std::endl;
-      if (d1 == dv2_c[i])
+      if (!dv2_used[i] && d1 == dv2[i])
       {
         //std::cout << "DDDDD 3 " << std::endl;
         d_match = true;
-        dv2_c.erase(dv2_c.begin() + i);
+        dv2_used[i] = true;
         break;
       }
     }
@@ -294,28 +300,24 @@ std::ostream& operator<<( std::ostream& stream, const Data& data)
             if (data.type == "string")
             {
                 //std::cout << "DDDDDD 3 " << std::endl;
-                stream << " : " << boost::any_cast<std::string>(data.value);
+                stream << " : " << data.value.get<std::string>();
             }
 
             if (data.type == "topic")
             {
                 //std::cout << "DDDDDD 4 " << std::endl;
-                //std::cout << "DDDDDD 4.2 " << data.value.type().name() << std::endl;
-                std::string test = boost::any_cast<std::string>(data.value);
-                //std::cout << "DDDDDD 4.5 " << std::endl;
-
-                stream << " : " << boost::any_cast<std::string>(data.value);
+                stream << " : " << data.value.get<std::string>();
             }
 
             if (data.type == "number")
             {
                 //std::cout << "DDDDDD 5 " << std::endl;
-                stream << " : " << boost::any_cast<float>(data.value);
+                stream << " : " << data.value.get<double>();
             }
 
             //std::cout << "DDDDDD 6 " << std::endl;
         }
-        catch (boost::bad_any_cast& e)
+        catch (boost::bad_get& e)
         {
             stream << " : " << e.what();
         }
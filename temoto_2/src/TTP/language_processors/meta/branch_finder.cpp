@@ -8,7 +8,6 @@
 #include "meta/parser/trees/visitors/leaf_node_finder.h"
 #include "meta/analyzers/filters/porter2_stemmer.h"
 #include "meta/util/shim.h"
-#include <boost/any.hpp>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -25,8 +24,7 @@ namespace meta
 namespace parser
 {
 
-branch_finder::branch_finder(std::shared_ptr<TTP::nummap> num_str_map)
-: num_str_map_(num_str_map)
+branch_finder::branch_finder()
 {}
 
 // TODO DESC
@@ -141,13 +139,15 @@ TTP::Subject branch_finder::parseToNumericSubject(parser::parse_tree& tree)
         num_float = std::stof(*leaf->word());
       }
 
-      // check if the number is in letter format
+      // check if the number is in letter format, unknown words count as zero
       catch(std::invalid_argument e)
       {
-        num_float = (*num_str_map_)[*leaf->word()];
+        unsigned int num_int = 0;
+        TTP::strtoint(*leaf->word(), num_int);
+        num_float = num_int;
       }
 
-      data.value = boost::any_cast<float>(num_float);
+      data.value = num_float;
       data.type = "number";
       continue;
     }
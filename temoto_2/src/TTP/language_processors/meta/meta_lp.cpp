@@ -9,6 +9,8 @@
 #include "meta/parser/trees/internal_node.h"
 #include "meta/parser/trees/leaf_node.h"
 
+#include "tbb/parallel_for.h"
+
 namespace TTP
 {
 
@@ -27,14 +29,9 @@ MetaLP::MetaLP(std::string language_models_dir, BaseSubsystem& b) : BaseSubsyste
   std::cout << prefix << " Loading parser model ... " << std::flush;
   parser_ = meta::parser::sr_parser(language_models_dir + "parser");
   std::cout << "done\n";
-
-  // loading number lookup table / Generating numbers up to 999999
-  std::cout << prefix << " Loading the 'string-to-integer' lookup table ... " << std::flush;
-  str_int_map_ = std::make_shared<nummap>(generateStrToNrMap(999999));
-  std::cout << "done\n";
 }
 
-TaskTree MetaLP::processText(std::string input_text)
+std::vector<TaskTree> MetaLP::processText(std::string input_text)
 {
   // Name of the method, used for making debugging a bit simpler
   std::string prefix = common::generateLogPrefix("", class_name_, __func__);
@@ -46,6 +43,8 @@ TaskTree MetaLP::processText(std::string input_text)
       throw CREATE_ERROR(error::Code::NLP_INV_ARG, "Received an empty string");
   }
 
+  // Tokenize the text once and split it into sentences
+  std::vector<meta::sequence::sequence> sentences;
   meta::sequence::sequence seq;
 
   std::unique_ptr<meta::analyzers::token_stream> stream =
@@ -61,47 +60,72 @@ TaskTree MetaLP::processText(std::string input_text)
     }
     else if (token == "</s>")
     {
-      tagger_.tag(seq);
-      meta::parser::parse_tree p_tree = parser_.parse(seq);
+        sentences.push_back(std::move(seq));
+    }
+    else
+    {
+        seq.add_symbol(meta::sequence::symbol_t{token});
+    }
+  }
 
-      // Create a parse tree branch finder visitor
-      meta::parser::branch_finder bf(str_int_map_);
+  /*
+   * Tag and parse the sentences in parallel. The models are only read while tagging and
+   * parsing, so they are shared by the threads. Each sentence gets its own sequence,
+   * parse tree and branch finder.
+   */
+  std::vector<std::vector<TTP::TaskDescriptor>> sentence_task_descs(sentences.size());
+  std::vector<std::string> addressables(sentences.size());
 
-      /*
-       * Extract the potential tasks from the parse tree. Tasks are
-       * returned as a vector of task descriptors
-       */
-      p_tree.visit(bf);
-      std::vector<TTP::TaskDescriptor> task_descs = bf.getTaskDescs();
+  tbb::parallel_for(size_t(0), sentences.size(), [&](size_t i)
+  {
+    tagger_.tag(sentences[i]);
+    meta::parser::parse_tree p_tree = parser_.parse(sentences[i]);
+
+    // Create a parse tree branch finder visitor
+    meta::parser::branch_finder bf;
+
+    /*
+     * Extract the potential tasks from the parse tree. Tasks are
+     * returned as a vector of task descriptors
+     */
+    p_tree.visit(bf);
+    sentence_task_descs[i] = bf.getTaskDescs();
+    addressables[i] = bf.getAddressable();
+  });
+
+  // Build a task tree for each sentence that contains tasks, in the order of the sentences
+  std::vector<TaskTree> task_trees;
+  for (size_t i = 0; i < sentences.size(); i++)
+  {
+    std::vector<TTP::TaskDescriptor>& task_descs = sentence_task_descs[i];
 
-      // If potential tasks were found then ...
-      if (task_descs.size() > 0)
-      {
-        std::cout << "Found " << task_descs.size() << " potential tasks addressed to: " << bf.getAddressable() << std::endl;
+    // If potential tasks were found then ...
+    if (task_descs.size() > 0)
+    {
+      std::cout << "Found " << task_descs.size() << " potential tasks addressed to: " << addressables[i] << std::endl;
 
-        // Build a task tree
-        task_tree_ = SFTBuilder::build(task_descs);
+      // Build a task tree
+      task_trees.push_back(SFTBuilder::build(task_descs));
 
-        // Print out the tasks after being parsed
-        for( auto& task_descriptor : task_descs )
-        {
-            std::cout << task_descriptor << std::endl;
-        }
-      }
-      else
+      // Print out the tasks after being parsed
+      for( auto& task_descriptor : task_descs )
       {
-        std::cout << prefix << "No tasks were found\n";
-        // Throw error
-        throw CREATE_ERROR(error::Code::NLP_BAD_INPUT, "Could not make any sense of input text.");
+          std::cout << task_descriptor << std::endl;
       }
     }
     else
     {
-        seq.add_symbol(meta::sequence::symbol_t{token});
+      std::cout << prefix << "No tasks were found in sentence " << i + 1 << "\n";
     }
   }
 
-  return std::move(task_tree_);
+  if (task_trees.empty())
+  {
+    // Throw error
+    throw CREATE_ERROR(error::Code::NLP_BAD_INPUT, "Could not make any sense of input text.");
+  }
+
+  return task_trees;
 }
 
 }// END of TTP namespace
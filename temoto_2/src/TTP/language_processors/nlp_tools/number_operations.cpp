@@ -39,17 +39,191 @@ std::string inttostr( const unsigned int number )
   throw std::out_of_range("inttostr() value too large");
 }
 
-nummap generateStrToNrMap(int max_nr)
+/*
+ * The parser below follows the grammar of inttostr:
+ *
+ *   number   = "zero" | thousands | thousands "thousand" [thousands]
+ *   thousands = tens | unit "hundred" [tens]
+ *   tens      = first14[1..14] | prefix "teen" | prefix "ty" [unit]
+ *   unit      = first14[1..9]
+ *
+ * The words are compared in place, so nothing is allocated.
+ */
+namespace
 {
-  nummap str_int_map;
 
-  // Fill the map
-  for (int i=0; i<=max_nr; i++)
+struct Word
+{
+  const char* begin;
+  size_t size;
+};
+
+// inttostr never produces more words than "nine hundred ninety nine thousand nine hundred ninety nine"
+const size_t MAX_WORDS = 10;
+
+bool equals(const Word& word, const std::string& str)
+{
+  return word.size == str.size() && str.compare(0, str.size(), word.begin, word.size) == 0;
+}
+
+bool equals(const Word& word, const std::string& prefix, const std::string& suffix)
+{
+  return word.size == prefix.size() + suffix.size() &&
+         prefix.compare(0, prefix.size(), word.begin, prefix.size()) == 0 &&
+         suffix.compare(0, suffix.size(), word.begin + prefix.size(), suffix.size()) == 0;
+}
+
+/*
+ * Finds the index of the word in first14, looking only at the entries from first to last
+ */
+bool parseFirst14(const Word& word, unsigned int first, unsigned int last, unsigned int& number)
+{
+  for (unsigned int i = first; i <= last; i++)
+  {
+    if (equals(word, first14[i]))
+    {
+      number = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parseTens(const Word* words, size_t word_count, size_t& pos, unsigned int& number)
+{
+  if (pos >= word_count)
+  {
+    return false;
+  }
+
+  const Word& word = words[pos];
+  if (parseFirst14(word, 1, 14, number))
+  {
+    pos++;
+    return true;
+  }
+
+  for (unsigned int i = 15; i < 20; i++)
+  {
+    if (equals(word, prefixes[i - 12], "teen"))
+    {
+      number = i;
+      pos++;
+      return true;
+    }
+  }
+
+  for (unsigned int i = 2; i < 10; i++)
+  {
+    if (equals(word, prefixes[i - 2], "ty"))
+    {
+      number = i * 10;
+      pos++;
+
+      unsigned int unit;
+      if (pos < word_count && parseFirst14(words[pos], 1, 9, unit))
+      {
+        number += unit;
+        pos++;
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool parseThousands(const Word* words, size_t word_count, size_t& pos, unsigned int& number)
+{
+  unsigned int hundreds;
+  if (pos + 1 < word_count && equals(words[pos + 1], "hundred") &&
+      parseFirst14(words[pos], 1, 9, hundreds))
+  {
+    number = hundreds * 100;
+    pos += 2;
+
+    // The tens are optional, but a word other than "thousand" has to be the tens
+    unsigned int tens;
+    if (pos < word_count && !equals(words[pos], "thousand"))
+    {
+      if (!parseTens(words, word_count, pos, tens))
+      {
+        return false;
+      }
+      number += tens;
+    }
+    return true;
+  }
+
+  return parseTens(words, word_count, pos, number);
+}
+
+} // anonymous namespace
+
+bool strtoint( const std::string& str, unsigned int& number )
+{
+  // Split the string into words which are separated by single spaces
+  Word words[MAX_WORDS];
+  size_t word_count = 0;
+  size_t word_begin = 0;
+  while (true)
+  {
+    size_t word_end = str.find(' ', word_begin);
+    if (word_end == std::string::npos)
+    {
+      word_end = str.size();
+    }
+
+    if (word_end == word_begin || word_count == MAX_WORDS)
+    {
+      return false;
+    }
+    words[word_count++] = Word{ str.data() + word_begin, word_end - word_begin };
+
+    if (word_end == str.size())
+    {
+      break;
+    }
+    word_begin = word_end + 1;
+  }
+
+  if (word_count == 1 && equals(words[0], first14[0]))
+  {
+    number = 0;
+    return true;
+  }
+
+  size_t pos = 0;
+  unsigned int parsed_number;
+  if (!parseThousands(words, word_count, pos, parsed_number))
+  {
+    return false;
+  }
+
+  if (pos < word_count && equals(words[pos], "thousand"))
+  {
+    parsed_number *= 1000;
+    pos++;
+
+    unsigned int remainder;
+    if (pos < word_count)
+    {
+      if (!parseThousands(words, word_count, pos, remainder))
+      {
+        return false;
+      }
+      parsed_number += remainder;
+    }
+  }
+
+  // Trailing words are not part of the number
+  if (pos != word_count)
   {
-    str_int_map[inttostr(i)] = i;
+    return false;
   }
 
-  return str_int_map;
+  number = parsed_number;
+  return true;
 }
 
 }
@@ -0,0 +1,143 @@
+#include "TTP/sft_executor.h"
+
+#include <algorithm>
+
+namespace TTP
+{
+
+/* * * * * * * * *
+ *  CONSTRUCTOR
+ * * * * * * * * */
+
+SFTExecutor::SFTExecutor(size_t thread_count, size_t queue_size, size_t concurrency)
+  : queue_size_(queue_size)
+  // Each executor thread joins the arena through a slot reserved for it
+  , arena_(std::max<size_t>(thread_count, 1) + concurrency, std::max<size_t>(thread_count, 1))
+{
+  running_threads_ = std::max<size_t>(thread_count, 1);
+  for (size_t i = 0; i < running_threads_; i++)
+  {
+    threads_.emplace_back(&SFTExecutor::executorThread, this);
+  }
+}
+
+/* * * * * * * * *
+ *  DESTRUCTOR
+ * * * * * * * * */
+
+SFTExecutor::~SFTExecutor()
+{
+  join();
+}
+
+/* * * * * * * * *
+ *  JOIN
+ * * * * * * * * */
+
+void SFTExecutor::join()
+{
+  shutdown();
+  for (auto& thread : threads_)
+  {
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+}
+
+/* * * * * * * * *
+ *  SUBMIT
+ * * * * * * * * */
+
+bool SFTExecutor::submit(Job job, Job done)
+{
+  std::lock_guard<std::mutex> lock(job_queue_mutex_);
+  if (!running_ || job_queue_.size() >= queue_size_)
+  {
+    return false;
+  }
+
+  job_queue_.push_back(QueuedJob{ std::move(job), std::move(done) });
+  job_queue_cv_.notify_one();
+  return true;
+}
+
+/* * * * * * * * *
+ *  SHUTDOWN
+ * * * * * * * * */
+
+void SFTExecutor::shutdown()
+{
+  std::lock_guard<std::mutex> lock(job_queue_mutex_);
+  running_ = false;
+  job_queue_.clear();
+  job_queue_cv_.notify_all();
+}
+
+/* * * * * * * * *
+ *  WAIT IDLE
+ * * * * * * * * */
+
+bool SFTExecutor::waitIdle(std::chrono::steady_clock::time_point deadline)
+{
+  shutdown();
+
+  std::unique_lock<std::mutex> lock(job_queue_mutex_);
+  return threads_done_cv_.wait_until(lock, deadline, [&]
+  {
+    return running_threads_ == 0;
+  });
+}
+
+/* * * * * * * * *
+ *  EXECUTOR THREAD
+ * * * * * * * * */
+
+void SFTExecutor::executorThread()
+{
+  std::unique_lock<std::mutex> lock(job_queue_mutex_);
+  while (true)
+  {
+    job_queue_cv_.wait(lock, [&]
+    {
+      return !job_queue_.empty() || !running_;
+    });
+
+    if (!running_)
+    {
+      running_threads_--;
+      threads_done_cv_.notify_all();
+      return;
+    }
+
+    QueuedJob queued_job = std::move(job_queue_.front());
+    job_queue_.pop_front();
+    lock.unlock();
+
+    try
+    {
+      // The flow graph of the job picks up the arena it was created in
+      arena_.execute(queued_job.job);
+    }
+    catch (...)
+    {
+      // The jobs handle their own errors, nothing may take the thread down
+    }
+
+    if (queued_job.done)
+    {
+      try
+      {
+        queued_job.done();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    lock.lock();
+  }
+}
+
+} // END of TTP namespace
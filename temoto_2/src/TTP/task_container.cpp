@@ -4,20 +4,27 @@ namespace TTP
 {
 
 // Constructor
-TaskContainer::TaskContainer(boost::shared_ptr<BaseTask> task_pointer, boost::shared_ptr<TaskDescriptor> task_descriptor)
-    : task_pointer_(task_pointer), task_descriptor_(task_descriptor)
+TaskContainer::TaskContainer(boost::shared_ptr<BaseTask> task_pointer,
+                             boost::shared_ptr<TaskDescriptor> task_descriptor,
+                             InterfaceUpdater update_interface)
+    : task_pointer_(task_pointer)
+    , task_descriptor_(task_descriptor)
+    , update_interface_(std::move(update_interface))
 {}
 
-Subjects TaskContainer::operator()(Subjects input_subjects)
+SubjectsPtr TaskContainer::operator()(const SubjectsPtr& input_subjects)
 {
-    // Create a copy of input subjects
-    std::vector<Subject> input_subjects_c = input_subjects;
+    // Each input subject can complete only one local subject
+    std::vector<bool> input_subjects_used(input_subjects->size(), false);
+
+    // The interface is completed on a local copy, the descriptor is updated only through the updater
+    TaskInterface task_interface = task_descriptor_->getFirstInterface();
 
     /*
      * Check for incomplete local subjects. Get the missing information for the
      * incomplete subjects from input subjects
      */
-    for (auto& l_sub : task_descriptor_->getFirstInputSubjects())
+    for (auto& l_sub : task_interface.input_subjects_)
     {
         if (l_sub.is_complete_)
         {
@@ -25,34 +32,40 @@ Subjects TaskContainer::operator()(Subjects input_subjects)
         }
 
         // go through the input subjects
-        for (auto i_sub_it = input_subjects_c.begin(); i_sub_it != input_subjects_c.end(); ++i_sub_it)
+        for (unsigned int i = 0; i < input_subjects->size(); i++)
         {
-            // Check type
-            if (l_sub.type_ != i_sub_it->type_)
+            const Subject& i_sub = (*input_subjects)[i];
+
+            // Skip the already used subjects and check type
+            if (input_subjects_used[i] || l_sub.type_ != i_sub.type_)
             {
                 continue;
             }
 
             // Check data
-            if (l_sub.data_ != i_sub_it->data_)
+            if (l_sub.data_ != i_sub.data_)
             {
                 continue;
             }
 
-            // At this point we have a match. Make a copy and delete the matching entry
-            l_sub = *i_sub_it;
-            input_subjects_c.erase(i_sub_it);
+            // At this point we have a match. Make a copy and mark the entry used
+            l_sub = i_sub;
+            input_subjects_used[i] = true;
             break;
         }
     }
 
+    update_interface_(*task_descriptor_, task_interface);
+
     // Start the task
     std::cout << "starting a task ...\n";
-    task_pointer_->startTaskWrapped(task_descriptor_->getFirstInterface());
+    task_pointer_->startTaskWrapped(task_interface);
 
-    // Get the output subjects, make a local copy and return them to the next task
-    task_descriptor_->setFirstOutputSubjects(task_pointer_->getSolution());
+    // Get the output subjects, make a local copy and pass them on to the next tasks
+    SubjectsPtr output_subjects = std::make_shared<const Subjects>(task_pointer_->getSolution());
+    task_interface.output_subjects_ = *output_subjects;
+    update_interface_(*task_descriptor_, task_interface);
 
-    return task_pointer_->getSolution();
+    return output_subjects;
 }
 }// END of TTP namespace
@@ -4,7 +4,6 @@
 
 #include <string>
 #include <vector>
-#include <boost/any.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <stdexcept>
 
@@ -490,18 +489,18 @@ std::vector<Data> TaskDescriptorProcessor::getData(TiXmlElement* first_data_elem
 
                 if (data.type == "string")
                 {
-                    data.value = boost::any_cast<std::string>(value_str);
+                    data.value = value_str;
                 }
 
                 if (data.type == "topic")
                 {
-                    data.value = boost::any_cast<std::string>(value_str);
+                    data.value = value_str;
                 }
 
                 if (data.type == "number")
                 {
                     double value_num = atof(value_str.c_str());
-                    data.value = boost::any_cast<double>(value_num);
+                    data.value = value_num;
                 }
             }
 
@@ -512,7 +511,7 @@ std::vector<Data> TaskDescriptorProcessor::getData(TiXmlElement* first_data_elem
     {
       FORWARD_ERROR(error_stack);
     }
-    catch (boost::bad_any_cast& e)
+    catch (boost::bad_get& e)
     {
         throw CREATE_ERROR(error::Code::BAD_ANY_CAST, std::string(e.what()) + ". in: " + desc_file_path_);
     }
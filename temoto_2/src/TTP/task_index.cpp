@@ -0,0 +1,125 @@
+#include "TTP/task_index.h"
+
+#include <algorithm>
+
+namespace TTP
+{
+
+/* * * * * * * * *
+ *  BUILD
+ * * * * * * * * */
+
+void TaskIndex::build(const std::vector<TaskDescriptor>& tasks)
+{
+  interfaces_.clear();
+  by_action_.clear();
+  by_action_stemmed_.clear();
+
+  for (const auto& task : tasks)
+  {
+    by_action_[task.action_].push_back(&task);
+
+    // The aliases contain the stemmed action as well, but the descriptors which were not created
+    // by the task descriptor processor may lack it
+    std::vector<Action> action_keys = task.aliases_stemmed_;
+    action_keys.push_back(task.action_stemmed_);
+    std::sort(action_keys.begin(), action_keys.end());
+    action_keys.erase(std::unique(action_keys.begin(), action_keys.end()), action_keys.end());
+
+    for (const auto& task_interface : task.task_interfaces_)
+    {
+      InterfaceEntry entry;
+      entry.task = &task;
+      entry.interface = &task_interface;
+      for (const auto& subject : task_interface.input_subjects_)
+      {
+        entry.input_types[subject.type_]++;
+      }
+      for (const auto& subject : task_interface.output_subjects_)
+      {
+        entry.output_types[subject.type_]++;
+      }
+
+      size_t entry_index = interfaces_.size();
+      for (const auto& action_key : action_keys)
+      {
+        ActionPostings& postings = by_action_stemmed_[action_key];
+        for (const auto& input_type : entry.input_types)
+        {
+          postings.by_input_type[input_type.first].push_back(entry_index);
+        }
+      }
+
+      interfaces_.push_back(std::move(entry));
+    }
+  }
+}
+
+/* * * * * * * * *
+ *  FIND BY ACTION
+ * * * * * * * * */
+
+std::vector<const TaskDescriptor*> TaskIndex::findByAction(const Action& action) const
+{
+  const auto action_it = by_action_.find(action);
+  if (action_it == by_action_.end())
+  {
+    return {};
+  }
+  return action_it->second;
+}
+
+/* * * * * * * * *
+ *  FIND INTERFACES
+ * * * * * * * * */
+
+std::vector<const TaskIndex::InterfaceEntry*> TaskIndex::findInterfaces(const Action& action_stemmed,
+                                                                       const std::vector<Subject>& subjects) const
+{
+  std::vector<const InterfaceEntry*> found_interfaces;
+  const auto postings_it = by_action_stemmed_.find(action_stemmed);
+  if (postings_it == by_action_stemmed_.end())
+  {
+    return found_interfaces;
+  }
+  const ActionPostings& postings = postings_it->second;
+
+  // Only the interfaces which take some of the given subject types are looked at
+  std::map<std::string, unsigned int> subject_types;
+  for (const auto& subject : subjects)
+  {
+    subject_types[subject.type_]++;
+  }
+
+  std::vector<size_t> entry_indexes;
+  for (const auto& subject_type : subject_types)
+  {
+    const auto type_it = postings.by_input_type.find(subject_type.first);
+    if (type_it != postings.by_input_type.end())
+    {
+      entry_indexes.insert(entry_indexes.end(), type_it->second.begin(), type_it->second.end());
+    }
+  }
+  std::sort(entry_indexes.begin(), entry_indexes.end());
+  entry_indexes.erase(std::unique(entry_indexes.begin(), entry_indexes.end()), entry_indexes.end());
+
+  // Each input subject of the interface needs a subject of its own
+  for (size_t entry_index : entry_indexes)
+  {
+    const InterfaceEntry& entry = interfaces_[entry_index];
+    bool subjects_suffice = std::all_of(entry.input_types.begin(), entry.input_types.end(),
+                                        [&](const std::pair<const std::string, unsigned int>& type)
+                                        {
+                                          const auto it = subject_types.find(type.first);
+                                          return it != subject_types.end() && it->second >= type.second;
+                                        });
+    if (subjects_suffice)
+    {
+      found_interfaces.push_back(&entry);
+    }
+  }
+
+  return found_interfaces;
+}
+
+} // END of TTP namespace
@@ -0,0 +1,384 @@
+#include "TTP/task_index_cache.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace TTP
+{
+
+/* * * * * * * * *
+ *  YAML CONVERSIONS
+ * * * * * * * * */
+
+namespace
+{
+
+// Increased when the layout of the cache file changes, older files are ignored
+const int CACHE_FORMAT_VERSION = 1;
+
+YAML::Node encodeFileStamp(const TaskIndexCache::FileStamp& stamp)
+{
+  YAML::Node node;
+  node.SetStyle(YAML::EmitterStyle::Flow);
+  node.push_back(stamp.mtime_sec);
+  node.push_back(stamp.mtime_nsec);
+  node.push_back(stamp.size);
+  return node;
+}
+
+TaskIndexCache::FileStamp decodeFileStamp(const YAML::Node& node)
+{
+  TaskIndexCache::FileStamp stamp;
+  stamp.mtime_sec = node[0].as<int64_t>();
+  stamp.mtime_nsec = node[1].as<int64_t>();
+  stamp.size = node[2].as<int64_t>();
+  return stamp;
+}
+
+/*
+ * The task descriptor processor sets a value only for the "number", "string" and "topic"
+ * datatypes, so only these have to be stored.
+ */
+YAML::Node encodeSubjects(const std::vector<Subject>& subjects)
+{
+  YAML::Node subjects_node(YAML::NodeType::Sequence);
+  for (const auto& subject : subjects)
+  {
+    YAML::Node subject_node;
+    subject_node["type"] = subject.type_;
+    subject_node["pos_tag"] = subject.pos_tag_;
+    subject_node["words"] = subject.words_;
+
+    YAML::Node datas_node(YAML::NodeType::Sequence);
+    for (const auto& data : subject.data_)
+    {
+      YAML::Node data_node;
+      data_node["type"] = data.type;
+      if (!data.value.empty())
+      {
+        if (data.type == "number")
+        {
+          data_node["value"] = data.value.get<double>();
+        }
+        else
+        {
+          data_node["value"] = data.value.get<std::string>();
+        }
+      }
+      datas_node.push_back(data_node);
+    }
+    subject_node["data"] = datas_node;
+
+    subjects_node.push_back(subject_node);
+  }
+  return subjects_node;
+}
+
+std::vector<Subject> decodeSubjects(const YAML::Node& subjects_node)
+{
+  std::vector<Subject> subjects;
+  for (const auto& subject_node : subjects_node)
+  {
+    Subject subject;
+    subject.type_ = subject_node["type"].as<std::string>();
+    subject.pos_tag_ = subject_node["pos_tag"].as<std::string>();
+    subject.words_ = subject_node["words"].as<std::vector<std::string>>();
+
+    for (const auto& data_node : subject_node["data"])
+    {
+      Data data;
+      data.type = data_node["type"].as<std::string>();
+      if (data_node["value"])
+      {
+        if (data.type == "number")
+        {
+          data.value = data_node["value"].as<double>();
+        }
+        else
+        {
+          data.value = data_node["value"].as<std::string>();
+        }
+      }
+      subject.data_.push_back(data);
+    }
+
+    subjects.push_back(subject);
+  }
+  return subjects;
+}
+
+} // anonymous namespace
+
+YAML::Node TaskIndexCache::encodeDescriptor(const TaskDescriptor& descriptor)
+{
+  YAML::Node node;
+  node["action"] = descriptor.action_;
+  node["action_stemmed"] = descriptor.action_stemmed_;
+  node["aliases"] = descriptor.aliases_;
+  node["aliases_stemmed"] = descriptor.aliases_stemmed_;
+  node["class_name"] = descriptor.task_class_name_;
+  node["package_name"] = descriptor.task_package_name_;
+  node["lib_path"] = descriptor.task_lib_path_;
+
+  YAML::Node interfaces_node(YAML::NodeType::Sequence);
+  for (const auto& task_interface : descriptor.task_interfaces_)
+  {
+    YAML::Node interface_node;
+    interface_node["id"] = task_interface.id_;
+    interface_node["type"] = task_interface.type_;
+    interface_node["alias"] = task_interface.alias_;
+    interface_node["in"] = encodeSubjects(task_interface.input_subjects_);
+    interface_node["out"] = encodeSubjects(task_interface.output_subjects_);
+    interfaces_node.push_back(interface_node);
+  }
+  node["interfaces"] = interfaces_node;
+
+  return node;
+}
+
+TaskDescriptor TaskIndexCache::decodeDescriptor(const YAML::Node& node)
+{
+  TaskDescriptor descriptor;
+  descriptor.action_ = node["action"].as<std::string>();
+  descriptor.action_stemmed_ = node["action_stemmed"].as<std::string>();
+  descriptor.aliases_ = node["aliases"].as<std::vector<Action>>();
+  descriptor.aliases_stemmed_ = node["aliases_stemmed"].as<std::vector<Action>>();
+  descriptor.task_class_name_ = node["class_name"].as<std::string>();
+  descriptor.task_package_name_ = node["package_name"].as<std::string>();
+  descriptor.task_lib_path_ = node["lib_path"].as<std::string>();
+
+  for (const auto& interface_node : node["interfaces"])
+  {
+    TaskInterface task_interface;
+    task_interface.id_ = interface_node["id"].as<unsigned int>();
+    task_interface.type_ = interface_node["type"].as<std::string>();
+    task_interface.alias_ = interface_node["alias"].as<std::string>();
+    task_interface.input_subjects_ = decodeSubjects(interface_node["in"]);
+    task_interface.output_subjects_ = decodeSubjects(interface_node["out"]);
+    descriptor.task_interfaces_.push_back(task_interface);
+  }
+
+  return descriptor;
+}
+
+/* * * * * * * * *
+ *  GET FILE STAMP
+ * * * * * * * * */
+
+bool TaskIndexCache::getFileStamp(const std::string& path, FileStamp& stamp)
+{
+  struct stat file_stat;
+  if (stat(path.c_str(), &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+  {
+    return false;
+  }
+
+  stamp.mtime_sec = file_stat.st_mtim.tv_sec;
+  stamp.mtime_nsec = file_stat.st_mtim.tv_nsec;
+  stamp.size = file_stat.st_size;
+  return true;
+}
+
+/* * * * * * * * *
+ *  GET TASK STAMP
+ * * * * * * * * */
+
+bool TaskIndexCache::getTaskStamp(const std::string& task_dir, TaskStamp& stamp)
+{
+  return getFileStamp(task_dir + "/descriptor.xml", stamp.descriptor) &&
+         getFileStamp(task_dir + "/package.xml", stamp.package);
+}
+
+/* * * * * * * * *
+ *  GET CACHE FILE PATH
+ * * * * * * * * */
+
+std::string TaskIndexCache::getCacheFilePath(const std::string& actions_dir)
+{
+  std::string ros_home;
+  if (const char* ros_home_env = getenv("ROS_HOME"))
+  {
+    ros_home = ros_home_env;
+  }
+  else if (const char* home_env = getenv("HOME"))
+  {
+    ros_home = std::string(home_env) + "/.ros";
+  }
+  else
+  {
+    ros_home = "/tmp";
+  }
+
+  // Each actions directory gets a file of its own
+  std::stringstream file_name;
+  file_name << "temoto_task_index_" << std::hex << std::hash<std::string>()(actions_dir) << ".yaml";
+  return ros_home + "/" + file_name.str();
+}
+
+/* * * * * * * * *
+ *  OPEN
+ * * * * * * * * */
+
+bool TaskIndexCache::open(const std::string& cache_file_path)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  if (cache_file_path == cache_file_path_)
+  {
+    return true;
+  }
+
+  cache_file_path_ = cache_file_path;
+  entries_.clear();
+  modified_ = false;
+
+  std::ifstream cache_file(cache_file_path_);
+  if (!cache_file.is_open())
+  {
+    // Nothing has been cached yet
+    return true;
+  }
+
+  try
+  {
+    YAML::Node cache_node = YAML::Load(cache_file);
+    if (!cache_node["version"] || cache_node["version"].as<int>() != CACHE_FORMAT_VERSION)
+    {
+      modified_ = true;
+      return true;
+    }
+
+    for (const auto& task_node : cache_node["tasks"])
+    {
+      Entry entry;
+      entry.stamp.descriptor = decodeFileStamp(task_node["descriptor_stamp"]);
+      entry.stamp.package = decodeFileStamp(task_node["package_stamp"]);
+      entry.descriptor = decodeDescriptor(task_node["descriptor"]);
+      entries_[task_node["path"].as<std::string>()] = entry;
+    }
+  }
+  catch (YAML::Exception& e)
+  {
+    // Start from scratch, the file is rewritten on the next save
+    entries_.clear();
+    modified_ = true;
+    return false;
+  }
+
+  return true;
+}
+
+/* * * * * * * * *
+ *  SAVE
+ * * * * * * * * */
+
+bool TaskIndexCache::save()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  if (!modified_ || cache_file_path_.empty())
+  {
+    return true;
+  }
+
+  YAML::Node cache_node;
+  cache_node["version"] = CACHE_FORMAT_VERSION;
+  YAML::Node tasks_node(YAML::NodeType::Sequence);
+  for (const auto& entry : entries_)
+  {
+    YAML::Node task_node;
+    task_node["path"] = entry.first;
+    task_node["descriptor_stamp"] = encodeFileStamp(entry.second.stamp.descriptor);
+    task_node["package_stamp"] = encodeFileStamp(entry.second.stamp.package);
+    task_node["descriptor"] = encodeDescriptor(entry.second.descriptor);
+    tasks_node.push_back(task_node);
+  }
+  cache_node["tasks"] = tasks_node;
+
+  // Write to a temporary file first, so that the readers never see a partially written cache
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(boost::filesystem::path(cache_file_path_).parent_path(), ec);
+
+  std::string tmp_file_path = cache_file_path_ + ".tmp";
+  {
+    std::ofstream cache_file(tmp_file_path);
+    cache_file << cache_node << std::endl;
+    if (!cache_file.good())
+    {
+      std::remove(tmp_file_path.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmp_file_path.c_str(), cache_file_path_.c_str()) != 0)
+  {
+    std::remove(tmp_file_path.c_str());
+    return false;
+  }
+
+  modified_ = false;
+  return true;
+}
+
+/* * * * * * * * *
+ *  FIND
+ * * * * * * * * */
+
+bool TaskIndexCache::find( const std::string& task_dir
+                         , const TaskStamp& stamp
+                         , TaskDescriptor& descriptor)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto entry_it = entries_.find(task_dir);
+  if (entry_it == entries_.end() || !(entry_it->second.stamp == stamp))
+  {
+    return false;
+  }
+
+  entry_it->second.used = true;
+  descriptor = entry_it->second.descriptor;
+  return true;
+}
+
+/* * * * * * * * *
+ *  SET
+ * * * * * * * * */
+
+void TaskIndexCache::set( const std::string& task_dir
+                        , const TaskStamp& stamp
+                        , const TaskDescriptor& descriptor)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  Entry& entry = entries_[task_dir];
+  entry.stamp = stamp;
+  entry.descriptor = descriptor;
+  entry.used = true;
+  modified_ = true;
+}
+
+/* * * * * * * * *
+ *  DROP UNUSED
+ * * * * * * * * */
+
+void TaskIndexCache::dropUnused()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  for (auto entry_it = entries_.begin(); entry_it != entries_.end();)
+  {
+    if (entry_it->second.used)
+    {
+      entry_it->second.used = false;
+      ++entry_it;
+    }
+    else
+    {
+      entry_it = entries_.erase(entry_it);
+      modified_ = true;
+    }
+  }
+}
+
+} // END of TTP namespace
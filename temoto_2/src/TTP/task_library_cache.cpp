@@ -0,0 +1,243 @@
+#include "TTP/task_library_cache.h"
+
+#include <boost/make_shared.hpp>
+
+namespace TTP
+{
+
+/* * * * * * * * *
+ *  CONSTRUCTOR
+ * * * * * * * * */
+
+TaskLibraryCache::TaskLibraryCache(size_t capacity, size_t pool_size)
+  : capacity_(capacity)
+  , pool_size_(pool_size)
+{}
+
+/* * * * * * * * *
+ *  LOAD
+ * * * * * * * * */
+
+std::vector<std::string> TaskLibraryCache::load(const std::string& lib_path)
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  return loadLocked(lib_path).classes;
+}
+
+/* * * * * * * * *
+ *  PIN
+ * * * * * * * * */
+
+void TaskLibraryCache::pin(const std::string& lib_path)
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  loadLocked(lib_path).pinned = true;
+}
+
+/* * * * * * * * *
+ *  CREATE INSTANCE
+ * * * * * * * * */
+
+boost::shared_ptr<BaseTask> TaskLibraryCache::createInstance( const std::string& lib_path
+                                                            , const std::string& class_name)
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  Library& library = loadLocked(lib_path);
+
+  std::vector<boost::shared_ptr<BaseTask>>& idle_instances = library.idle_instances[class_name];
+  if (!idle_instances.empty())
+  {
+    boost::shared_ptr<BaseTask> instance = idle_instances.back();
+    idle_instances.pop_back();
+    return instance;
+  }
+
+  /*
+   * The returned pointer holds the class loader along with the instance, so that the library
+   * stays loaded until the instance has been destroyed
+   */
+  boost::shared_ptr<BaseTask> instance = library.loader->createInstance<BaseTask>(class_name);
+  boost::shared_ptr<class_loader::ClassLoader> loader = library.loader;
+  return boost::shared_ptr<BaseTask>(instance.get(), [instance, loader](BaseTask*) mutable
+  {
+    instance.reset();
+    loader.reset();
+  });
+}
+
+/* * * * * * * * *
+ *  RELEASE INSTANCE
+ * * * * * * * * */
+
+void TaskLibraryCache::releaseInstance( const std::string& lib_path
+                                      , const std::string& class_name
+                                      , boost::shared_ptr<BaseTask> instance)
+{
+  if (pool_size_ == 0 || !instance || !instance->resetTaskWrapped())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  const auto lib_it = libraries_.find(lib_path);
+  if (lib_it == libraries_.end() || hasChanged(lib_path, lib_it->second))
+  {
+    return;
+  }
+
+  std::vector<boost::shared_ptr<BaseTask>>& idle_instances = lib_it->second.idle_instances[class_name];
+  if (idle_instances.size() < pool_size_)
+  {
+    idle_instances.push_back(std::move(instance));
+  }
+}
+
+/* * * * * * * * *
+ *  UNLOAD
+ * * * * * * * * */
+
+void TaskLibraryCache::unload(const std::string& lib_path)
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  const auto lib_it = libraries_.find(lib_path);
+  if (lib_it != libraries_.end() && !isInUse(lib_it->second))
+  {
+    libraries_.erase(lib_it);
+  }
+}
+
+/* * * * * * * * *
+ *  GET CHANGED
+ * * * * * * * * */
+
+std::vector<std::string> TaskLibraryCache::getChanged()
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  std::vector<std::string> changed_libs;
+  for (const auto& library : libraries_)
+  {
+    if (hasChanged(library.first, library.second))
+    {
+      changed_libs.push_back(library.first);
+    }
+  }
+  return changed_libs;
+}
+
+/* * * * * * * * *
+ *  UNLOAD CHANGED
+ * * * * * * * * */
+
+void TaskLibraryCache::unloadChanged()
+{
+  std::lock_guard<std::mutex> lock(libraries_mutex_);
+  for (auto lib_it = libraries_.begin(); lib_it != libraries_.end(); /* empty */)
+  {
+    if (hasChanged(lib_it->first, lib_it->second) && !isInUse(lib_it->second))
+    {
+      lib_it = libraries_.erase(lib_it);
+    }
+    else
+    {
+      ++lib_it;
+    }
+  }
+}
+
+/* * * * * * * * *
+ *  LOAD LOCKED
+ * * * * * * * * */
+
+TaskLibraryCache::Library& TaskLibraryCache::loadLocked(const std::string& lib_path)
+{
+  bool pinned = false;
+  auto lib_it = libraries_.find(lib_path);
+  if (lib_it != libraries_.end())
+  {
+    // A changed library can be swapped only when none of its instances are alive
+    if (!hasChanged(lib_path, lib_it->second) || isInUse(lib_it->second))
+    {
+      lib_it->second.last_used = ++use_counter_;
+      return lib_it->second;
+    }
+
+    pinned = lib_it->second.pinned;
+    libraries_.erase(lib_it);
+  }
+
+  Library& library = libraries_[lib_path];
+  try
+  {
+    TaskIndexCache::getFileStamp(lib_path, library.stamp);
+    library.loader = boost::make_shared<class_loader::ClassLoader>(lib_path, false);
+    library.classes = library.loader->getAvailableClasses<BaseTask>();
+  }
+  catch(...)
+  {
+    libraries_.erase(lib_path);
+    throw;
+  }
+  library.pinned = pinned;
+  library.last_used = ++use_counter_;
+
+  evictLocked();
+  return library;
+}
+
+/* * * * * * * * *
+ *  IS IN USE
+ * * * * * * * * */
+
+bool TaskLibraryCache::isInUse(const Library& library) const
+{
+  // Besides the cache itself, each pooled instance holds a reference to the class loader
+  long idle_count = 0;
+  for (const auto& idle_instances : library.idle_instances)
+  {
+    idle_count += idle_instances.second.size();
+  }
+  return library.loader.use_count() > 1 + idle_count;
+}
+
+/* * * * * * * * *
+ *  HAS CHANGED
+ * * * * * * * * */
+
+bool TaskLibraryCache::hasChanged(const std::string& lib_path, const Library& library) const
+{
+  TaskIndexCache::FileStamp stamp;
+  return !TaskIndexCache::getFileStamp(lib_path, stamp) || !(stamp == library.stamp);
+}
+
+/* * * * * * * * *
+ *  EVICT LOCKED
+ * * * * * * * * */
+
+void TaskLibraryCache::evictLocked()
+{
+  while (libraries_.size() > capacity_)
+  {
+    // The library which was just used is never evicted
+    auto lru_it = libraries_.end();
+    for (auto lib_it = libraries_.begin(); lib_it != libraries_.end(); ++lib_it)
+    {
+      const Library& library = lib_it->second;
+      if (library.pinned || library.last_used == use_counter_ || isInUse(library))
+      {
+        continue;
+      }
+      if (lru_it == libraries_.end() || library.last_used < lru_it->second.last_used)
+      {
+        lru_it = lib_it;
+      }
+    }
+
+    if (lru_it == libraries_.end())
+    {
+      return;
+    }
+    libraries_.erase(lru_it);
+  }
+}
+
+} // END of TTP namespace
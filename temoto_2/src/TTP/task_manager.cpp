@@ -16,21 +16,28 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
 
 namespace TTP
 {
 
+/*
+ * The candidates refer to the indexed tasks, which stay in place while the task tree is connected
+ */
 struct CandidateInterface
 {
-  CandidateInterface(TaskInterface inf, unsigned int score):inf_(inf), score_(score){}
-  TaskInterface inf_;
+  CandidateInterface(const TaskInterface& inf, unsigned int score):inf_(&inf), score_(score){}
+  const TaskInterface* inf_;
   int score_;
 };
 
 struct CandidateTask
 {
-  CandidateTask(TaskDescriptor td, CandidateInterface ci):td_(td), ci_(ci){}
-  TaskDescriptor td_;
+  CandidateTask(const TaskDescriptor& td, CandidateInterface ci):td_(&td), ci_(ci){}
+  const TaskDescriptor* td_;
   CandidateInterface ci_;
 };
 
@@ -45,6 +52,8 @@ TaskManager::TaskManager( std::string subsystem_name
                         , std::string ai_libs_path
                         , std::string chatter_topic)
   : nlp_enabled_(nlp_enabled)
+  , task_library_cache_(MAX_LOADED_TASK_LIBS, TASK_INSTANCE_POOL_SIZE)
+  , sft_executor_(SFT_EXECUTOR_THREADS, SFT_QUEUE_SIZE, SFT_FLOW_GRAPH_CONCURRENCY)
 {
   try
   {
@@ -77,6 +86,8 @@ TaskManager::TaskManager( BaseSubsystem *b
                         , std::string chatter_topic)
   : BaseSubsystem(*b)
   , nlp_enabled_(nlp_enabled)
+  , task_library_cache_(MAX_LOADED_TASK_LIBS, TASK_INSTANCE_POOL_SIZE)
+  , sft_executor_(SFT_EXECUTOR_THREADS, SFT_QUEUE_SIZE, SFT_FLOW_GRAPH_CONCURRENCY)
 {
   try
   {
@@ -99,6 +110,16 @@ void TaskManager::initCore(std::string ai_libs_path, std::string chatter_topic)
   // Construct the classloader
   class_loader_ = new class_loader::MultiLibraryClassLoader(true);
 
+  // Each node using a task manager can configure it through its private parameters
+  ros::NodeHandle private_nh("~");
+  double task_stop_timeout = DEFAULT_TASK_STOP_TIMEOUT;
+  private_nh.getParam("task_stop_timeout", task_stop_timeout);
+  task_stop_timeout_ = std::chrono::milliseconds(static_cast<long>(task_stop_timeout * 1000));
+  private_nh.getParam("preload_tasks", preloaded_task_packages_);
+
+  // The state transitions of the tasks are handled as soon as they are published
+  task_event_thread_ = std::thread(&TaskManager::taskEventThread, this);
+
   // Create a base path for getting stuff like nlp model files and tasks
   std::string temoto_path = ros::package::getPath(ROS_PACKAGE_NAME);
 
@@ -110,9 +131,14 @@ void TaskManager::initCore(std::string ai_libs_path, std::string chatter_topic)
   {
     language_processor_ = new MetaLP(temoto_path + "/language_processors/meta/models/", *this);
 
-    // Subscribe to human chatter topic. This triggers the callback that processes text
-    // messages and trys to find and execute tasks based on the text
-    human_chatter_subscriber_ = nh_.subscribe(chatter_topic, 1, &TaskManager::humanChatterCb, this);
+    // The instructions are processed by a thread of their own, so that the callback never
+    // blocks the spinner
+    instruction_thread_running_ = true;
+    instruction_thread_ = std::thread(&TaskManager::instructionThread, this);
+
+    // Subscribe to human chatter topic. This triggers the callback that queues the text
+    // messages, the tasks are found and executed based on the text by the instruction thread
+    human_chatter_subscriber_ = nh_.subscribe(chatter_topic, INSTRUCTION_QUEUE_SIZE, &TaskManager::humanChatterCb, this);
   }
 
   /*
@@ -142,9 +168,6 @@ void TaskManager::initCore(std::string ai_libs_path, std::string chatter_topic)
 
   // Task indexing subscriber
   index_tasks_subscriber_ = nh_.subscribe("index_tasks", 1, &TaskManager::indexTasksCallback, this);
-
-  // Thread joining timer
-  thread_joining_timer_ = nh_.createTimer(ros::Duration(1), &TaskManager::threadJoiningTimerCallback, this);
 }
 
 /* * * * * * * * *
@@ -153,17 +176,55 @@ void TaskManager::initCore(std::string ai_libs_path, std::string chatter_topic)
 
 void TaskManager::humanChatterCb (std_msgs::String chat)
 {
-  try
+  std::lock_guard<std::mutex> lock(instruction_queue_mutex_);
+
+  // Drop the instruction rather than block the spinner when a burst has filled the queue
+  if (instruction_queue_.size() >= INSTRUCTION_QUEUE_SIZE)
   {
-    std::cout << BOLDWHITE << "Received: " << chat.data << RESET << std::endl << std::endl;
-    executeVerbalInstruction (chat.data);
+    TEMOTO_WARN_STREAM("The instruction queue is full, ignoring: " << chat.data);
+    return;
   }
-  catch (error::ErrorStack& error_stack)
+
+  instruction_queue_.push_back(std::move(chat.data));
+  instruction_queue_cv_.notify_one();
+}
+
+/* * * * * * * * *
+ *  INSTRUCTION THREAD
+ * * * * * * * * */
+
+void TaskManager::instructionThread()
+{
+  std::unique_lock<std::mutex> lock(instruction_queue_mutex_);
+  while (true)
   {
-    FORWARD_ERROR(error_stack);
-  }
+    instruction_queue_cv_.wait(lock, [&]
+    {
+      return !instruction_queue_.empty() || !instruction_thread_running_;
+    });
+
+    if (!instruction_thread_running_)
+    {
+      return;
+    }
+
+    std::string instruction = std::move(instruction_queue_.front());
+    instruction_queue_.pop_front();
+    lock.unlock();
 
-  std::cout << "* * * * * * * * * * * * * * * * * * * * * * * * * * * * \n\n";
+    try
+    {
+      std::cout << BOLDWHITE << "Received: " << instruction << RESET << std::endl << std::endl;
+      executeVerbalInstruction (instruction);
+    }
+    catch (error::ErrorStack& error_stack)
+    {
+      FORWARD_ERROR(error_stack);
+    }
+
+    std::cout << "* * * * * * * * * * * * * * * * * * * * * * * * * * * * \n\n";
+    lock.lock();
+  }
 }
 
 
@@ -181,11 +242,29 @@ void TaskManager::executeVerbalInstruction (std::string& verbal_instruction)
       throw CREATE_ERROR(error::Code::NLP_DISABLED, "NLP cannot be used if its disabled.");
     }
 
-    // Convert the verbal instruction into a incomplete semantic frame tree
-    TaskTree sft = language_processor_->processText(std::move(verbal_instruction));
+    // Convert the verbal instruction into incomplete semantic frame trees, one per sentence
+    std::vector<TaskTree> sfts = language_processor_->processText(std::move(verbal_instruction));
+
+    // Execute the SFTs. A tree which is rejected does not keep the rest of the sentences from
+    // being executed, the rejected ones are reported together
+    error::ErrorStack rejected_sfts;
+    for (size_t i = 0; i < sfts.size(); i++)
+    {
+      try
+      {
+        executeSFTThreaded(std::move(sfts[i]));
+      }
+      catch(error::ErrorStack& error_stack)
+      {
+        TEMOTO_ERROR("Sentence %lu of %lu was not executed.", i + 1, sfts.size());
+        rejected_sfts += error_stack;
+      }
+    }
 
-    // Execute the SFT
-    executeSFTThreaded(std::move(sft));
+    if (!rejected_sfts.empty())
+    {
+      throw FORWARD_ERROR(rejected_sfts);
+    }
 
   }
   catch(error::ErrorStack& error_stack)
@@ -202,7 +281,29 @@ void TaskManager::executeVerbalInstruction (std::string& verbal_instruction)
  * * * * * * * * */
 void TaskManager::executeSFTThreaded(TaskTree sft)
 {
-  flow_graph_futures_.push_back(std::async(std::launch::async, &TaskManager::executeSFT, this, std::move(sft)));
+  // The job has to be copyable, hence the tree is shared with it
+  std::shared_ptr<TaskTree> sft_ptr = std::make_shared<TaskTree>(std::move(sft));
+
+  bool admitted = sft_executor_.submit([this, sft_ptr]
+  {
+    try
+    {
+      executeSFT(std::move(*sft_ptr));
+    }
+    catch(error::ErrorStack& error_stack)
+    {
+      FORWARD_ERROR(error_stack);
+    }
+  },
+  [this]
+  {
+    TEMOTO_INFO_STREAM("An action thread has finished");
+  });
+
+  if (!admitted)
+  {
+    throw CREATE_ERROR(error::Code::SFT_QUEUE_FULL, "Too many task trees are waiting for execution, ignoring the tree.");
+  }
 }
 
 /* * * * * * * * *
@@ -211,8 +312,10 @@ void TaskManager::executeSFTThreaded(TaskTree sft)
 
 void TaskManager::executeSFT(TaskTree sft)
 {
-  // Let others know that action execution engine is busy
-  action_executioner_busy_ = true;
+  // Everything the tree needs to know about its own execution, so that trees can run side by side
+  std::shared_ptr<SFTContext> context = std::make_shared<SFTContext>();
+  context->start_time = std::chrono::steady_clock::now();
+  bool registered = false;
 
   try
   {
@@ -222,17 +325,26 @@ void TaskManager::executeSFT(TaskTree sft)
     // Print out the semantic frame tree
     std::cout << "SFTree: " << sft_new;
 
-    // Find connecting semantic frames
+    // Find connecting semantic frames. The index cannot be swapped while the tree is being connected
     TEMOTO_DEBUG_STREAM("Connecting the task tree");
-    std::vector<TTP::Subject> empty_subs; // stupid hack
-    connectTaskTree(root_node, empty_subs);
+    {
+      std::shared_lock<std::shared_timed_mutex> index_lock(task_index_mutex_);
+      std::vector<TTP::Subject> empty_subs; // stupid hack
+      connectTaskTree(root_node, empty_subs);
+    }
+    getLibPaths(root_node, context->lib_paths);
 
     // Print task tree task descriptors
     sft_new.printTaskDescriptors(root_node);
 
+    // The libraries of the tree stay as they are until the tree has finished
+    registerSFT(context);
+    registered = true;
+
     // Load and initialize the tasks
-    TEMOTO_DEBUG_STREAM("Loadng and initializing the tree");
+    TEMOTO_DEBUG_STREAM("Loadng and initializing the tree " << context->id);
     loadAndInitializeTaskTree(root_node);
+    getTaskIds(root_node, context->task_ids);
 
     // Create a tbb flow graph
     TEMOTO_DEBUG_STREAM("Creating an empty flow graph object");
@@ -248,8 +360,7 @@ void TaskManager::executeSFT(TaskTree sft)
 
     // Start the flow graph
     TEMOTO_DEBUG_STREAM("Starting the flow graph");
-    TTP::Subjects dummy_subjects; // stupid hack
-    root_node.root_fgn_->try_put(dummy_subjects);
+    root_node.root_fgn_->try_put(std::make_shared<const Subjects>()); // stupid hack
     flow_graph.wait_for_all();
 
     TEMOTO_DEBUG_STREAM("Finished executing the flow graph");
@@ -261,12 +372,19 @@ void TaskManager::executeSFT(TaskTree sft)
   }
   catch(...)
   {
+    releaseSynchronousTasks(context->task_ids);
+    if (registered)
+    {
+      unregisterSFT(*context);
+    }
     throw CREATE_ERROR(error::Code::UNHANDLED_EXCEPTION, "Received an unhandled exception");
   }
 
-  // Let others know that action execution engine is not busy
-  // TODO: in a multithreaded case this will fail
-  action_executioner_busy_ = false;
+  releaseSynchronousTasks(context->task_ids);
+  if (registered)
+  {
+    unregisterSFT(*context);
+  }
 }
 
 
@@ -294,7 +412,13 @@ std::vector <TaskDescriptor> TaskManager::findTask(std::string task_to_find, con
 
 std::vector <TaskDescriptor> TaskManager::findTaskLocal(std::string task_to_find)
 {
-  return findTask(task_to_find, tasks_indexed_);
+  std::shared_lock<std::shared_timed_mutex> index_lock(task_index_mutex_);
+  std::vector <TaskDescriptor> tasks_found;
+  for (const TaskDescriptor* task : task_index_.findByAction(task_to_find))
+  {
+    tasks_found.push_back(*task);
+  }
+  return tasks_found;
 }
 
 /* * * * * * * * *
@@ -307,48 +431,63 @@ std::vector <TaskDescriptor> TaskManager::findTaskFilesys(std::string task_to_fi
 {
   boost::filesystem::path current_dir (base_path);
   boost::filesystem::directory_iterator end_itr;
-  std::vector <TaskDescriptor> tasks_found;
 
   try
   {
-    // Start looking the files inside current directory
+    // The entries of the current directory are walked and parsed in parallel
+    std::vector<boost::filesystem::directory_entry> entries;
     for ( boost::filesystem::directory_iterator itr( current_dir ); itr != end_itr; ++itr )
     {
+      entries.push_back(*itr);
+    }
 
-      // if its a directory and depth limit is not there yet, go inside it
-      if ( boost::filesystem::is_directory(*itr) && (search_depth > 0) )
-      {
-        std::vector<TaskDescriptor> sub_tasks_found = findTaskFilesys( task_to_find, *itr, (search_depth - 1) );
-
-        // Append the subtasks if not empty
-        if ( !sub_tasks_found.empty() )
-        {
-          tasks_found.insert(std::end(tasks_found), std::begin(sub_tasks_found), std::end(sub_tasks_found));
-        }
-      }
+    // The tasks are kept by the entries they were found from, so that the order does not depend
+    // on the scheduling of the workers
+    std::vector<std::vector<TaskDescriptor>> entry_tasks(entries.size());
+    std::atomic<size_t> next_entry(0);
+    std::exception_ptr worker_exception;
+    std::mutex worker_exception_mutex;
 
-      // if its a file and matches the desc file name, process the file
-      else if ( boost::filesystem::is_regular_file(*itr) &&
-                ((*itr).path().filename() == description_file_) )
+    auto worker = [&]
+    {
+      for (size_t i = next_entry++; i < entries.size(); i = next_entry++)
       {
         try
         {
-          /*
-           * Create a description processor object and Get TaskDescriptor
-           * I THINK THIS SHOULD NOT BE CREATED EVERY SINGLE TIME
-           */
-          boost::filesystem::path hackdir ((*itr)); //HACKATON
-          TaskDescriptorProcessor tdp(hackdir.parent_path().string(), *this);
-          tasks_found.push_back(tdp.getTaskDescriptor());
+          findTasksInEntry(entries[i], search_depth, entry_tasks[i]);
         }
-
-        catch(error::ErrorStack& error_stack)
+        catch(...)
         {
-          FORWARD_ERROR(error_stack);
+          std::lock_guard<std::mutex> lock(worker_exception_mutex);
+          worker_exception = std::current_exception();
+          next_entry = entries.size();
         }
       }
+    };
+
+    unsigned int worker_count = std::min<size_t>(std::thread::hardware_concurrency(), entries.size());
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < worker_count; i++)
+    {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+
+    if (worker_exception)
+    {
+      std::rethrow_exception(worker_exception);
+    }
+
+    std::vector <TaskDescriptor> tasks_found;
+    for (auto& tasks : entry_tasks)
+    {
+      tasks_found.insert(std::end(tasks_found), std::begin(tasks), std::end(tasks));
     }
-    return std::move(tasks_found);
+    return tasks_found;
   }
   catch (std::exception& e)
   {
@@ -363,6 +502,66 @@ std::vector <TaskDescriptor> TaskManager::findTaskFilesys(std::string task_to_fi
   }
 }
 
+/* * * * * * * * *
+ *  FIND TASKS IN DIRECTORY ENTRY
+ * * * * * * * * */
+
+void TaskManager::findTasksInEntry(const boost::filesystem::directory_entry& entry,
+                                   int search_depth,
+                                   std::vector<TaskDescriptor>& tasks_found)
+{
+  // if its a directory and depth limit is not there yet, go inside it
+  if ( boost::filesystem::is_directory(entry) && (search_depth > 0) )
+  {
+    boost::filesystem::directory_iterator end_itr;
+    for ( boost::filesystem::directory_iterator itr( entry.path() ); itr != end_itr; ++itr )
+    {
+      findTasksInEntry(*itr, search_depth - 1, tasks_found);
+    }
+  }
+
+  // if its a file and matches the desc file name, process the file
+  else if ( boost::filesystem::is_regular_file(entry) &&
+            (entry.path().filename() == description_file_) )
+  {
+    try
+    {
+      tasks_found.push_back(getTaskDescriptor(entry.path().parent_path().string()));
+    }
+
+    catch(error::ErrorStack& error_stack)
+    {
+      FORWARD_ERROR(error_stack);
+    }
+  }
+}
+
+/* * * * * * * * *
+ *  GET TASK DESCRIPTOR
+ * * * * * * * * */
+
+TaskDescriptor TaskManager::getTaskDescriptor(const std::string& task_dir)
+{
+  // Parse the descriptor only if it has changed since it was cached
+  TaskIndexCache::TaskStamp stamp;
+  bool stamped = TaskIndexCache::getTaskStamp(task_dir, stamp);
+
+  TaskDescriptor task_descriptor;
+  if (stamped && task_index_cache_.find(task_dir, stamp, task_descriptor))
+  {
+    return task_descriptor;
+  }
+
+  TaskDescriptorProcessor tdp(task_dir, *this);
+  task_descriptor = tdp.getTaskDescriptor();
+
+  if (stamped)
+  {
+    task_index_cache_.set(task_dir, stamp, task_descriptor);
+  }
+  return task_descriptor;
+}
+
 /* * * * * * * * *
  *  INDEX TASKS
  * * * * * * * * */
@@ -371,20 +570,36 @@ void TaskManager::indexTasks (boost::filesystem::directory_entry base_path, int
 {
     try
     {
+        std::lock_guard<std::mutex> indexing_lock(indexing_mutex_);
         TEMOTO_DEBUG_STREAM("Indexing the tasks");
-        tasks_indexed_ = findTaskFilesys ("", base_path, search_depth);
-        TEMOTO_DEBUG_STREAM("Found " << tasks_indexed_.size() << " tasks");
 
-        // Unload synchronous task libraries
-        TEMOTO_DEBUG_STREAM("Unloading synchronous action libraries");
+        std::string cache_file_path = TaskIndexCache::getCacheFilePath(base_path.path().string());
+        if (!task_index_cache_.open(cache_file_path))
+        {
+          TEMOTO_WARN_STREAM("The task index cache '" << cache_file_path << "' is corrupt, all tasks are parsed again");
+        }
+
+        // The running trees keep using the old index until the new one is swapped in
+        std::vector <TaskDescriptor> tasks_found = findTaskFilesys ("", base_path, search_depth);
+        {
+          std::lock_guard<std::shared_timed_mutex> index_lock(task_index_mutex_);
+          tasks_indexed_ = std::move(tasks_found);
+          task_index_.build(tasks_indexed_);
+        }
+        TEMOTO_DEBUG_STREAM("Found " << tasks_indexed_.size() << " tasks");
 
-        for (auto& task_lib : synchronous_task_libs_)
+        // Forget the tasks which have been removed and store the index for the next start
+        task_index_cache_.dropUnused();
+        if (!task_index_cache_.save())
         {
-            unloadTaskLib(task_lib);
+          TEMOTO_WARN_STREAM("Unable to write the task index cache '" << cache_file_path << "'");
         }
 
-        // Clear the synchronous task libraries set
-        synchronous_task_libs_.clear();
+        // Unload the task libraries which have been rebuilt, the rest stay loaded
+        TEMOTO_DEBUG_STREAM("Unloading changed action libraries");
+        replaceChangedLibraries();
+
+        preloadTasks();
     }
     catch(error::ErrorStack& error_stack)
     {
@@ -393,12 +608,40 @@ void TaskManager::indexTasks (boost::filesystem::directory_entry base_path, int
 }
 
 
+/* * * * * * * * *
+ *  PRELOAD TASKS
+ * * * * * * * * */
+
+void TaskManager::preloadTasks()
+{
+  for (const auto& task : tasks_indexed_)
+  {
+    if (std::find(preloaded_task_packages_.begin(), preloaded_task_packages_.end(), task.task_package_name_)
+        == preloaded_task_packages_.end())
+    {
+      continue;
+    }
+
+    try
+    {
+      TEMOTO_DEBUG_STREAM("Preloading the library of task '" << task.task_package_name_ << "'");
+      task_library_cache_.pin(task.task_lib_path_);
+    }
+    catch(class_loader::ClassLoaderException& e)
+    {
+      TEMOTO_WARN_STREAM("Unable to preload the library of task '" << task.task_package_name_ << "': " << e.what());
+    }
+  }
+}
+
+
 /* * * * * * * * *
  *  GET THE INDEX TASKS
  * * * * * * * * */
 
-std::vector <TaskDescriptor>& TaskManager::getIndexedTasks()
+std::vector <TaskDescriptor> TaskManager::getIndexedTasks()
 {
+    std::shared_lock<std::shared_timed_mutex> index_lock(task_index_mutex_);
     return tasks_indexed_;
 }
 
@@ -410,17 +653,17 @@ std::vector <TaskDescriptor>& TaskManager::getIndexedTasks()
 unsigned int findNonstrictMatch (const std::vector<Subject>& complete_subjects,
                                  const std::vector<Subject>& incomplete_subjects)
 {
-    // create a copy of complete subjects
-    std::vector<Subject> complete_subjects_c = complete_subjects;
+    // Each complete subject can be matched only once
+    std::vector<bool> complete_subject_used(complete_subjects.size(), false);
     unsigned int score = 0;
 
     for (auto& i_subject : incomplete_subjects)
     {
         bool subject_match = false;
-        for (unsigned int i=0; i<complete_subjects_c.size(); i++)
+        for (unsigned int i=0; i<complete_subjects.size(); i++)
         {
             // Check for type match
-            if (i_subject.type_ != complete_subjects_c[i].type_)
+            if (complete_subject_used[i] || i_subject.type_ != complete_subjects[i].type_)
             {
                 continue;
             }
@@ -429,8 +672,8 @@ unsigned int findNonstrictMatch (const std::vector<Subject>& complete_subjects,
             score++;
 
             // The more data the complete subject has, the bigger the score
-            score += complete_subjects_c[i].data_.size();
-            complete_subjects_c.erase(complete_subjects_c.begin() + i);
+            score += complete_subjects[i].data_.size();
+            complete_subject_used[i] = true;
             break;
         }
         if (subject_match != true)
@@ -446,21 +689,21 @@ unsigned int findNonstrictMatch (const std::vector<Subject>& complete_subjects,
  *  FIND WORD MATCH + STRICT MATCH
  * * * * * * * * */
 
-unsigned int findWordMatch (Subjects& required_subjects , Subjects& node_subjects)
+unsigned int findWordMatch (const Subjects& required_subjects, const Subjects& node_subjects)
 {
-    // create a copy of subs_2
-    Subjects node_subjects_c = node_subjects;
+    // Each node subject can be matched only once
+    std::vector<bool> node_subject_used(node_subjects.size(), false);
     unsigned int score = 0;
 
     for (auto& r_sub : required_subjects)
     {
         bool subject_match = false;
-        for (auto n_sub = node_subjects_c.begin();
-             n_sub != node_subjects_c.end();
-             ++n_sub)
+        for (unsigned int i=0; i<node_subjects.size(); i++)
         {
+            const Subject* n_sub = &node_subjects[i];
+
             // Check for type match
-            if (r_sub.type_ != n_sub->type_)
+            if (node_subject_used[i] || r_sub.type_ != n_sub->type_)
             {
                 //std::cout << "    subject types do not match\n";
                 continue;
@@ -515,7 +758,7 @@ unsigned int findWordMatch (Subjects& required_subjects , Subjects& node_subject
 
             //std::cout << "    we got a winner\n";
             subject_match = true;
-            node_subjects_c.erase(n_sub);
+            node_subject_used[i] = true;
             break;
         }
         if (subject_match != true)
@@ -632,6 +875,7 @@ void TaskManager::connectTaskTree(TaskTreeNode& node, std::vector<Subject> paren
             for (auto& n_sub : node_subjects)
             {
                 // Check each background (asynchronous) task
+                std::shared_lock<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
                 for (auto& async_task : asynchronous_tasks_)
                 {
                     // Check each output subject of the background task
@@ -720,189 +964,59 @@ void TaskManager::connectTaskTree(TaskTreeNode& node, std::vector<Subject> paren
         {
             incomplete_subject.words_.clear();
         }
-
-        // Debug
-        TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking for a suitable task");
-
-        /*
-         * Find task that matches own i-subjects + that has a matching
-         * o-subjects with dependent children incomplete i-subjects
-         */
-        for (auto& task_descriptor : tasks_indexed_)
-        {
-            // Debug
-            TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking at - " << task_descriptor.getAction());
-
-            // Look for the task with the same action type
-            if (task_descriptor.action_stemmed_ != node_action)
-            {
-                // Check the aliases, if any
-                bool alias_found = false;
-                for (auto& alias : task_descriptor.aliases_stemmed_)
-                {
-                    if (alias == node_action)
-                    {
-                        // Debug
-                        TEMOTO_DEBUG_STREAM ("T'" << node_action << "': found action based on it's alias");
-                        alias_found = true;
-                        break;
-                    }
-                }
-
-                if (!alias_found)
-                {
-                    // Debug
-                    TEMOTO_DEBUG_STREAM ("T'" << node_action << "': action does not match");
-                    continue;
-                }
-            }
-
-            std::vector<CandidateInterface> candidate_interfaces;
-
-            // Loop over the interfaces and ...
-            for (auto& interface : task_descriptor.getInterfaces())
-            {
-                TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking at interface no: " << interface.id_);
-
-                // ... look for a word match + STRICT i-subjects match
-                unsigned int word_match_score = findWordMatch (interface.input_subjects_, node_subjects);
-                if (word_match_score == 0)
-                {
-                    // Debug
-                    TEMOTO_DEBUG_STREAM ("T'" << node_action << "': input subjects do not match. "
-                                         << " and we are talking about: \n" << interface.input_subjects_
-                                         << " and\n" << node_subjects);
-                    continue;
-                }
-
-                // ... look for NONSTRICT o-subjects match
-                unsigned int output_match_score = findNonstrictMatch (interface.output_subjects_, incomplete_subjects);
-                if (output_match_score == 0)
-                {
-                    // Debug
-                    TEMOTO_DEBUG_STREAM ("T'" << node_action
-                                         << "': output subjects do not match with dep childern"
-                                         << " and we are talking about: \n" << interface.output_subjects_
-                                         << " and\n" << incomplete_subjects);
-                    continue;
-                }
-
-                // And we have a candidate
-                candidate_interfaces.emplace_back(interface, word_match_score + output_match_score);
-            }
-
-            /*
-             * If this task contains any suitable interfaces, pick the one with
-             * the best match and push the task to the candidate tasks set
-             */
-            if (!candidate_interfaces.empty())
-            {
-                // Debug
-                TEMOTO_DEBUG_STREAM ("T'" << node_action << "': IS A SUITABLE CANDIDATE");
-
-                // Sort the candidates with decreasing score and pick the first candidate
-                std::sort(candidate_interfaces.begin(),
-                          candidate_interfaces.end(),
-                          [](CandidateInterface& i1, CandidateInterface& i2)
-                          {
-                              return i1.score_ > i2.score_;
-                          });
-
-                // DEBUG - print out the scores
-                //std::cout << "SCORES ";
-                //for (auto& inf : candidate_interfaces){std::cout << inf.score_ << ",";} std::cout<<"\n";
-
-                candidate_tasks.emplace_back(task_descriptor, candidate_interfaces[0]);
-            }
-        }
     }
 
     /*
-     * If there were no incomplete subjects then ...
+     * Find the tasks that match own i-subjects. If there are any dependent children, the
+     * o-subjects of the task also have to match the incomplete i-subjects of the children.
+     * The index returns only the interfaces of the tasks with the same action type (or alias)
+     * that can take the subjects of this node.
      */
-    else
+
+    // Debug
+    TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking for a suitable task");
+
+    for (const TaskIndex::InterfaceEntry* entry : task_index_.findInterfaces(node_action, node_subjects))
     {
-        /*
-         * Find task that matches own i-subjects
-         */
+        const TaskInterface& interface = *entry->interface;
 
         // Debug
-        TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking for a suitable task");
+        TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking at - " << entry->task->getAction()
+                             << ", interface no: " << interface.id_);
 
-        for (auto& task_descriptor : tasks_indexed_)
+        // ... look for a word match + STRICT i-subjects match
+        unsigned int word_match_score = findWordMatch (interface.input_subjects_, node_subjects);
+        if (word_match_score == 0)
         {
             // Debug
-            TEMOTO_DEBUG_STREAM ("T'" << node_action << "': looking at - " << task_descriptor.getAction());
-
-            // Look for the task with the same action type
-            if (task_descriptor.action_stemmed_ != node_action)
-            {
-                // Check the aliases, if any
-                bool alias_found = false;
-                for (auto& alias : task_descriptor.aliases_stemmed_)
-                {
-                    if (alias == node_action)
-                    {
-                        // Debug
-                        TEMOTO_DEBUG_STREAM ("T'" << node_action << "': found action based on it's alias");
-                        alias_found = true;
-                        break;
-                    }
-                }
-
-                if (!alias_found)
-                {
-                    // Debug
-                    TEMOTO_DEBUG_STREAM ("T'" << node_action << "': action does not match");
-                    continue;
-                }
-            }
+            TEMOTO_DEBUG_STREAM ("T'" << node_action << "': input subjects do not match. "
+                                 << " and we are talking about: \n" << interface.input_subjects_
+                                 << " and\n" << node_subjects);
+            continue;
+        }
 
-            std::vector<CandidateInterface> candidate_interfaces;
+        // Debug
+        TEMOTO_DEBUG_STREAM ("T'" << node_action << "' strict/word match score: " << word_match_score);
 
-            // Loop over the interfaces and ...
-            for (auto& interface : task_descriptor.getInterfaces())
+        // ... look for NONSTRICT o-subjects match
+        unsigned int output_match_score = 0;
+        if (!incomplete_subjects.empty())
+        {
+            output_match_score = findNonstrictMatch (interface.output_subjects_, incomplete_subjects);
+            if (output_match_score == 0)
             {
-                // ... look for a word match + STRICT i-subjects match
-
-                unsigned int word_match_score = findWordMatch (interface.input_subjects_, node_subjects);
-                if (word_match_score == 0)
-                {
-                    // Debug
-                    TEMOTO_DEBUG_STREAM ("T'" << node_action << "': input subjects do not match. "
-                                         << " and we are talking about: " << interface.input_subjects_
-                                         << " and " << node_subjects);
-                    continue;
-                }
-
                 // Debug
-                TEMOTO_DEBUG_STREAM ("T'" << node_action << "' strict/word match score: " << word_match_score);
-
-                // And we have a candidate
-                candidate_interfaces.emplace_back(interface, word_match_score);
-            }
-
-            /*
-             * If this task contains any suitable interfaces, pick the one with
-             * the best match and push the task to the candidate tasks set
-             */
-            if (!candidate_interfaces.empty())
-            {
-                // Sort the candidates with decreasing score and pick the first candidate
-                std::sort(candidate_interfaces.begin(),
-                          candidate_interfaces.end(),
-                          [](CandidateInterface& i1, CandidateInterface& i2)
-                          {
-                              return i1.score_ > i2.score_;
-                          });
-
-                // DEBUG - print out the scores
-                //std::cout << "SCORES ";
-                //for (auto& inf : candidate_interfaces){std::cout << inf.score_ << ",";} std::cout<<"\n";
-
-                candidate_tasks.emplace_back(task_descriptor, candidate_interfaces[0]);
+                TEMOTO_DEBUG_STREAM ("T'" << node_action
+                                     << "': output subjects do not match with dep childern"
+                                     << " and we are talking about: \n" << interface.output_subjects_
+                                     << " and\n" << incomplete_subjects);
+                continue;
             }
         }
+
+        // And we have a candidate
+        candidate_tasks.emplace_back(*entry->task,
+                                     CandidateInterface(interface, word_match_score + output_match_score));
     }
 
     /*
@@ -914,26 +1028,24 @@ void TaskManager::connectTaskTree(TaskTreeNode& node, std::vector<Subject> paren
         throw CREATE_ERROR(error::Code::NLP_NO_TASK, "Couldn't find a suitable task for action: " + node_action);
     }
 
-    // Sort the candidates with decreasing order and pick the first candidate
-    std::sort(candidate_tasks.begin(),
-              candidate_tasks.end(),
-              [](CandidateTask& t1, CandidateTask& t2)
-              {
-                  return t1.ci_.score_ > t2.ci_.score_;
-              });
-
-    CandidateTask& cand_task = candidate_tasks[0];
+    // Pick the candidate with the best score
+    const CandidateTask& cand_task = *std::max_element(candidate_tasks.begin(),
+                                                       candidate_tasks.end(),
+                                                       [](const CandidateTask& t1, const CandidateTask& t2)
+                                                       {
+                                                           return t1.ci_.score_ < t2.ci_.score_;
+                                                       });
 
     /*
      * Get a bunch of information out of the prime candidate task
      */
-    node_interface.id_ = cand_task.ci_.inf_.id_;
-    node_interface.type_ = cand_task.ci_.inf_.type_;
+    node_interface.id_ = cand_task.ci_.inf_->id_;
+    node_interface.type_ = cand_task.ci_.inf_->type_;
     node_interface.alias_ = node_action; // TODO: This is a hack for Veiko
-    node_interface.output_subjects_ = cand_task.ci_.inf_.output_subjects_;
-    node_task_descriptor.task_package_name_ = cand_task.td_.task_package_name_;
-    node_task_descriptor.aliases_stemmed_ = cand_task.td_.aliases_stemmed_;
-    node_task_descriptor.task_lib_path_ = cand_task.td_.task_lib_path_;
+    node_interface.output_subjects_ = cand_task.ci_.inf_->output_subjects_;
+    node_task_descriptor.task_package_name_ = cand_task.td_->task_package_name_;
+    node_task_descriptor.aliases_stemmed_ = cand_task.td_->aliases_stemmed_;
+    node_task_descriptor.task_lib_path_ = cand_task.td_->task_lib_path_;
 
     /*
      * Process the child nodes of the tree
@@ -999,20 +1111,8 @@ void TaskManager::loadTask(TaskDescriptor& task_descriptor)
   {
     TEMOTO_DEBUG("Loading class from path: %s", path_to_lib.c_str());
 
-    if (class_loaders_.find(path_to_lib) == class_loaders_.end())
-    {
-      class_loaders_[path_to_lib] = boost::make_shared<class_loader::ClassLoader>(path_to_lib, false);
-
-      // Maintain the name of the synchronous task library, so that it could
-      // be unloaded after execution
-      if (task_descriptor.getFirstInterface().type_ == "synchronous")
-      {
-        TEMOTO_DEBUG_STREAM("This is sync task maintaining the library path in a separate set" << std::endl);
-        synchronous_task_libs_.push_back(path_to_lib);
-      }
-    }
-
-    classes = class_loaders_[path_to_lib]->getAvailableClasses<BaseTask>();
+    // The library is loaded only if it is not loaded yet or has changed on disk
+    classes = task_library_cache_.load(path_to_lib);
 
     // Done loading
     TEMOTO_DEBUG( "Loaded %lu classes from %s", classes.size(), path_to_lib.c_str() );
@@ -1076,10 +1176,14 @@ void TaskManager::instantiateTask(TaskTreeNode& node)
     // TODO: DO NOT ACCESS PRIVATE MEMBERS DIRECLY ,ie., UNFRIEND THE TASK MANAGER .. or should I?
     TEMOTO_DEBUG( "Instatiating task: %s", task_class_name.c_str());
 
-    node.task_pointer_ = class_loaders_[task_descriptor.getLibPath()]->createInstance<BaseTask>(task_class_name);
+    node.task_pointer_ = task_library_cache_.createInstance(task_descriptor.getLibPath(), task_class_name);
     node.task_pointer_->task_package_name_ = task_descriptor.getTaskPackageName();
-    node.task_pointer_->task_id_ = id_manager_.generateID();
+    {
+      std::lock_guard<std::mutex> id_lock(id_mutex_);
+      node.task_pointer_->task_id_ = id_manager_.generateID();
+    }
     node.task_pointer_->class_name_ = task_class_name;
+    node.task_pointer_->task_event_queue_ = &task_events_;
     node.task_pointer_->initializeBase(this);
 
     // TODO: This is a hack and it should not exist. But currently this is necessary
@@ -1093,6 +1197,7 @@ void TaskManager::instantiateTask(TaskTreeNode& node)
      * after being executed, since the flow graph owns the last shared pointer and flow graph object
      * is always destructed after execution (see TaskManager::executeSFT).
      */
+    std::lock_guard<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
     if (task_descriptor.getFirstInterface().type_ == "asynchronous")
     {
       TEMOTO_DEBUG_STREAM("This is an Asynchronous task, making a copy of the shared ptr\n");
@@ -1122,8 +1227,7 @@ void TaskManager::unloadTaskLib(std::string path_to_lib)
   try
   {
     TEMOTO_INFO_STREAM("Unloading library: " << path_to_lib );
-    //delete class_loaders_[path_to_lib];
-    class_loaders_.erase(path_to_lib);
+    task_library_cache_.unload(path_to_lib);
   }
   catch(class_loader::ClassLoaderException& e)
   {
@@ -1145,16 +1249,21 @@ void TaskManager::makeFlowGraph(TaskTreeNode& node, tbb::flow::graph& flow_graph
     // If its the root node, then create the start node
     if (node_task_descriptor.getAction() == "ROOT")
     {
-        node.root_fgn_ = std::make_unique<tbb::flow::broadcast_node<Subjects>>(flow_graph);
+        node.root_fgn_ = std::make_unique<tbb::flow::broadcast_node<SubjectsPtr>>(flow_graph);
     }
 
     // Create a continue node
     else
     {
-        node.task_fgn_ = std::make_unique< tbb::flow::function_node<Subjects, Subjects> >
+        node.task_fgn_ = std::make_unique< tbb::flow::function_node<SubjectsPtr, SubjectsPtr> >
                 (flow_graph
                  , tbb::flow::serial
-                 , TaskContainer(node.task_pointer_, node_task_descriptor_ptr));
+                 , TaskContainer(node.task_pointer_
+                               , node_task_descriptor_ptr
+                               , [this](TaskDescriptor& task_descriptor, const TaskInterface& task_interface)
+                                 {
+                                   updateTaskInterface(task_descriptor, task_interface);
+                                 }));
     }
 
     // Do the same with child nodes
@@ -1235,6 +1344,10 @@ void TaskManager::stopTask(std::string action, std::string what)
 {
   bool task_stopped = false;
 
+  // The tasks are looked up under the lock, but stopped after it has been released
+  std::vector<boost::shared_ptr<BaseTask>> tasks_to_stop;
+  std::unique_lock<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
+
   // Debug
   TEMOTO_DEBUG_STREAM ("No of asynchronous tasks: " << asynchronous_tasks_.size());
 
@@ -1289,7 +1402,7 @@ void TaskManager::stopTask(std::string action, std::string what)
       TEMOTO_DEBUG_STREAM ("Found the task, stopping it");
 
       // Remove the task
-      (task_it->second)->stopTask();
+      tasks_to_stop.push_back(task_it->second);
       asynchronous_tasks_.erase(task_it);
       task_stopped = true;
       break;
@@ -1330,7 +1443,7 @@ void TaskManager::stopTask(std::string action, std::string what)
       TEMOTO_DEBUG_STREAM ("Found the task, stopping it");
 
       // Remove the task
-      (task_it->second)->stopTask();
+      tasks_to_stop.push_back(task_it->second);
       asynchronous_tasks_.erase(task_it);
       task_stopped = true;
       break;
@@ -1439,8 +1552,8 @@ void TaskManager::stopTask(std::string action, std::string what)
       TEMOTO_DEBUG_STREAM ("Found task '" << lib_path << "'. Stopping it");
 
       // Remove the task, task_it is pointed to the next element
-      (task_it->second)->stopTask();
-      asynchronous_tasks_.erase(task_it);
+      tasks_to_stop.push_back(task_it->second);
+      task_it = asynchronous_tasks_.erase(task_it);
 
       //std::cout << "D0_3\n";
 
@@ -1453,11 +1566,18 @@ void TaskManager::stopTask(std::string action, std::string what)
     }
   }
 
+  tasks_lock.unlock();
+
   if (!task_stopped)
   {
     // If nothing was specified, then throw error
     throw CREATE_ERROR(error::Code::UNSPECIFIED_TASK, "Task 'action' and 'what' unspecified.");
   }
+
+  if (!stopTaskInstances(tasks_to_stop))
+  {
+    throw CREATE_ERROR(error::Code::TASK_STOP_TIMEOUT, "The task did not stop in time and was abandoned.");
+  }
 }
 
 
@@ -1470,14 +1590,6 @@ void TaskManager::indexTasksCallback(temoto_2::IndexTasks index_msg)
     TEMOTO_DEBUG( "Received a request to index tasks at '%s'", index_msg.directory.c_str());
     try
     {
-        // Wait until the action execution engine is not busy
-        while (action_executioner_busy_)
-        {
-            ros::Duration(0.05).sleep();
-            TEMOTO_DEBUG_STREAM("Waiting for action executioner ...");
-        }
-        TEMOTO_DEBUG_STREAM("Done waiting. Starting indexing process");
-
         boost::filesystem::directory_entry dir(index_msg.directory);
         indexTasks(dir, 1);
         TEMOTO_DEBUG_STREAM("Browsed and indexed the tasks successfully");
@@ -1490,112 +1602,350 @@ void TaskManager::indexTasksCallback(temoto_2::IndexTasks index_msg)
 
 
 /* * * * * * * * *
- *  THREAD JOINING TIMER CALLBACK
+ *  TASK EVENT THREAD
  * * * * * * * * */
 
-void TaskManager::threadJoiningTimerCallback(const ros::TimerEvent& e)
+void TaskManager::taskEventThread()
 {
-  //TEMOTO_INFO_STREAM(flow_graph_futures_.size() << " threads are currently running");
-
-  // Iterate through the thread vector and check if they are joinable
-  for(auto future_it = flow_graph_futures_.begin();
-      future_it != flow_graph_futures_.end();
-      /* empty */)
+  while (true)
   {
-    if(future_it->wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    TaskEvent event;
+    try
     {
-      TEMOTO_INFO_STREAM("An action thread has finished");
-      flow_graph_futures_.erase(future_it);
+      task_events_.pop(event);
     }
-    else
+    catch(tbb::user_abort&)
     {
-      future_it++;
+      // The task manager is shutting down
+      return;
     }
-  }
 
-  // Check if a synchronous task has finished
-  for (auto itr = synchronous_tasks_.begin();
-       itr != synchronous_tasks_.end();
-       /* empty */)
-  {
-    TEMOTO_INFO_STREAM("Use count of this synchronous task is: " << itr->second.use_count());
-    if (itr->second.use_count() == 1)
+    if (event.state == TaskState::STARTED)
     {
-      TEMOTO_INFO_STREAM("Destructing synchronous task");
-      synchronous_tasks_.erase(itr);
+      task_start_times_[event.task_id] = event.time;
     }
     else
     {
-      itr++;
+      auto start_it = task_start_times_.find(event.task_id);
+      if (start_it != task_start_times_.end())
+      {
+        TEMOTO_DEBUG_STREAM("Task " << event.task_id << " " << taskStateToString(event.state) << " after "
+                            << std::chrono::duration_cast<std::chrono::milliseconds>(event.time - start_it->second).count()
+                            << " ms");
+        task_start_times_.erase(start_it);
+      }
+    }
+
+    // Wake up the ones waiting for the tasks to stop
+    {
+      std::lock_guard<std::mutex> lock(task_state_mutex_);
     }
+    task_state_cv_.notify_all();
   }
 }
 
-TaskManager::~TaskManager()
+/* * * * * * * * *
+ *  WAIT FOR TASK END
+ * * * * * * * * */
+
+bool TaskManager::waitForTaskEnd(const boost::shared_ptr<BaseTask>& task,
+                                 std::chrono::steady_clock::time_point deadline)
 {
-  TEMOTO_INFO("Stopping all actions");
+  std::unique_lock<std::mutex> lock(task_state_mutex_);
+  return task_state_cv_.wait_until(lock, deadline, [&]
+  {
+    // A task which has not started yet sees the stop request before it starts
+    return task->getState() != TaskState::STARTED;
+  });
+}
+
+/* * * * * * * * *
+ *  STOP TASK INSTANCES
+ * * * * * * * * */
+
+bool TaskManager::stopTaskInstances(const std::vector<boost::shared_ptr<BaseTask>>& tasks)
+{
+  auto stop_start = std::chrono::steady_clock::now();
 
-  // Stop the synchronous actions
-  for (auto itr = synchronous_tasks_.begin();
-       itr != synchronous_tasks_.end();
-       /* empty */)
+  // Ask all the tasks to stop first, so that they wind down in parallel
+  for (auto& task : tasks)
+  {
+    task->stopTask();
+  }
+
+  std::vector<boost::shared_ptr<BaseTask>> late_tasks;
+  auto deadline = stop_start + task_stop_timeout_;
+  for (auto& task : tasks)
   {
-    TEMOTO_INFO_STREAM("Use count of this synchronous task is: " << itr->second.use_count());
-    if (itr->second.use_count() == 1)
+    if (!waitForTaskEnd(task, deadline))
     {
-      TEMOTO_INFO_STREAM("Destructing synchronous task");
-      synchronous_tasks_.erase(itr);
+      late_tasks.push_back(task);
     }
-    else if (itr->second.use_count() > 1)
-    {
-      // Tell the task to finish its business
-      itr->second->stopTask();
+  }
 
-      // Wait until the task has actually finished
-      // TODO: also add a timeout for the while loop. if the timeout is reached
-      // then somehow force the action to stop
-      while (!itr->second->taskFinished() || itr->second.use_count() > 1)
+  // Escalate with the tasks which ignored the request
+  bool all_stopped = true;
+  if (!late_tasks.empty())
+  {
+    for (auto& task : late_tasks)
+    {
+      TEMOTO_WARN_STREAM("Task '" << task->getName() << "' did not stop in " << task_stop_timeout_.count()
+                         << " ms, aborting it");
+      try
+      {
+        task->abortTask();
+      }
+      catch(...)
       {
-        TEMOTO_INFO_STREAM("Waiting the Synchronous action to finish ...");
-        ros::Duration(0.1).sleep();
+        TEMOTO_ERROR_STREAM("Task '" << task->getName() << "' threw while being aborted");
       }
+    }
 
-      // Erase the task
-      synchronous_tasks_.erase(itr);
+    deadline = std::chrono::steady_clock::now() + task_stop_timeout_;
+    for (auto& task : late_tasks)
+    {
+      if (!waitForTaskEnd(task, deadline))
+      {
+        TEMOTO_ERROR_STREAM("Task '" << task->getName() << "' did not react to abort, abandoning it");
+        all_stopped = false;
+      }
     }
   }
 
-  // Stop the asynchronous actions
-  for (auto itr = asynchronous_tasks_.begin();
-       itr != asynchronous_tasks_.end();
-       /* empty */)
+  TEMOTO_DEBUG_STREAM("Stopped " << tasks.size() << " task(s) in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stop_start).count()
+                      << " ms");
+  return all_stopped;
+}
+
+/* * * * * * * * *
+ *  GET TASK IDS
+ * * * * * * * * */
+
+void TaskManager::getTaskIds(TaskTreeNode& node, std::vector<TemotoID::ID>& task_ids)
+{
+  if (node.task_pointer_)
+  {
+    task_ids.push_back(node.task_pointer_->getID());
+  }
+
+  for (auto& child : node.getChildren())
+  {
+    getTaskIds(child, task_ids);
+  }
+}
+
+/* * * * * * * * *
+ *  RELEASE SYNCHRONOUS TASKS
+ * * * * * * * * */
+
+void TaskManager::releaseSynchronousTasks(const std::vector<TemotoID::ID>& task_ids)
+{
+  std::vector<std::pair<boost::shared_ptr<TaskDescriptor>, boost::shared_ptr<BaseTask>>> released_tasks;
   {
-    TEMOTO_INFO_STREAM("Use count of this synchronous task is: " << itr->second.use_count());
-    if (itr->second.use_count() == 1)
+    std::lock_guard<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
+    for (auto itr = synchronous_tasks_.begin();
+         itr != synchronous_tasks_.end();
+         /* empty */)
     {
-      TEMOTO_INFO_STREAM("Destructing synchronous task");
-      asynchronous_tasks_.erase(itr);
+      if (std::find(task_ids.begin(), task_ids.end(), itr->second->getID()) != task_ids.end())
+      {
+        released_tasks.push_back(std::move(*itr));
+        itr = synchronous_tasks_.erase(itr);
+      }
+      else
+      {
+        itr++;
+      }
     }
-    else if (itr->second.use_count() > 1)
+  }
+
+  // Resettable tasks are pooled for the next execution, the rest are destructed
+  for (auto& task : released_tasks)
+  {
+    TEMOTO_DEBUG_STREAM("Releasing synchronous task '" << task.second->getName() << "'");
+    task_library_cache_.releaseInstance(task.first->getLibPath(), task.first->getTaskClassName(), std::move(task.second));
+  }
+}
+
+/* * * * * * * * *
+ *  GET LIB PATHS
+ * * * * * * * * */
+
+void TaskManager::getLibPaths(TaskTreeNode& node, std::set<std::string>& lib_paths)
+{
+  const std::string& lib_path = node.getTaskDescriptor().getLibPath();
+  if (!lib_path.empty())
+  {
+    lib_paths.insert(lib_path);
+  }
+
+  for (auto& child : node.getChildren())
+  {
+    getLibPaths(child, lib_paths);
+  }
+}
+
+/* * * * * * * * *
+ *  REGISTER SFT
+ * * * * * * * * */
+
+void TaskManager::registerSFT(const std::shared_ptr<SFTContext>& context)
+{
+  std::unique_lock<std::mutex> sft_lock(sft_mutex_);
+  sft_cv_.wait(sft_lock, [&]
+  {
+    for (const std::string& lib_path : context->lib_paths)
     {
-      // Tell the task to finish its business
-      itr->second->stopTask();
+      if (replaced_task_libs_.count(lib_path))
+      {
+        return false;
+      }
+    }
+    return true;
+  });
+
+  context->id = ++sft_counter_;
+  running_sfts_[context->id] = context;
+  TEMOTO_DEBUG_STREAM("Tree " << context->id << " is running, " << running_sfts_.size() << " trees in total");
+}
+
+/* * * * * * * * *
+ *  UNREGISTER SFT
+ * * * * * * * * */
+
+void TaskManager::unregisterSFT(const SFTContext& context)
+{
+  {
+    std::lock_guard<std::mutex> sft_lock(sft_mutex_);
+    running_sfts_.erase(context.id);
+  }
+  sft_cv_.notify_all();
+
+  TEMOTO_DEBUG_STREAM("Tree " << context.id << " finished after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - context.start_time).count()
+                      << " ms");
+}
+
+/* * * * * * * * *
+ *  REPLACE CHANGED LIBRARIES
+ * * * * * * * * */
+
+void TaskManager::replaceChangedLibraries()
+{
+  std::vector<std::string> changed_libs = task_library_cache_.getChanged();
+  if (changed_libs.empty())
+  {
+    return;
+  }
 
-      // Wait until the task has actually finished
-      // TODO: also add a timeout for the while loop. if the timeout is reached
-      // then somehow force the action to stop
-      while (!itr->second->taskFinished() || itr->second.use_count() > 1)
+  // The new trees which need the changed libraries wait from here on
+  std::unique_lock<std::mutex> sft_lock(sft_mutex_);
+  replaced_task_libs_.insert(changed_libs.begin(), changed_libs.end());
+
+  // Wait only for the running trees which use any of the changed libraries
+  sft_cv_.wait(sft_lock, [&]
+  {
+    for (const auto& sft : running_sfts_)
+    {
+      for (const std::string& lib_path : changed_libs)
       {
-        TEMOTO_INFO_STREAM("Waiting the Asynchronous action to finish ...");
-        ros::Duration(0.1).sleep();
+        if (sft.second->lib_paths.count(lib_path))
+        {
+          TEMOTO_DEBUG_STREAM("Waiting for tree " << sft.first << " which uses '" << lib_path << "'");
+          return false;
+        }
       }
+    }
+    return true;
+  });
+  sft_lock.unlock();
+
+  task_library_cache_.unloadChanged();
+
+  sft_lock.lock();
+  for (const std::string& lib_path : changed_libs)
+  {
+    replaced_task_libs_.erase(lib_path);
+  }
+  sft_lock.unlock();
+  sft_cv_.notify_all();
+}
+
+/* * * * * * * * *
+ *  UPDATE TASK INTERFACE
+ * * * * * * * * */
+
+void TaskManager::updateTaskInterface(TaskDescriptor& task_descriptor, const TaskInterface& task_interface)
+{
+  std::lock_guard<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
+  task_descriptor.getFirstInterface() = task_interface;
+}
+
+TaskManager::~TaskManager()
+{
+  // Stop processing the instructions
+  human_chatter_subscriber_.shutdown();
+  sft_executor_.shutdown();
+  {
+    std::lock_guard<std::mutex> lock(instruction_queue_mutex_);
+    instruction_thread_running_ = false;
+    instruction_queue_cv_.notify_all();
+  }
+  if (instruction_thread_.joinable())
+  {
+    instruction_thread_.join();
+  }
 
-      // Erase the task
-      asynchronous_tasks_.erase(itr);
+  TEMOTO_INFO("Stopping all actions");
+  auto shutdown_start = std::chrono::steady_clock::now();
+
+  // Stop the synchronous and asynchronous actions together
+  std::vector<boost::shared_ptr<BaseTask>> tasks_to_stop;
+  {
+    std::lock_guard<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
+    for (auto& task : synchronous_tasks_)
+    {
+      tasks_to_stop.push_back(task.second);
+    }
+    for (auto& task : asynchronous_tasks_)
+    {
+      tasks_to_stop.push_back(task.second);
     }
   }
 
-  TEMOTO_INFO("All actions stopped");
+  if (!stopTaskInstances(tasks_to_stop))
+  {
+    TEMOTO_ERROR("Some of the actions did not stop and were abandoned");
+  }
+  tasks_to_stop.clear();
+
+  // The tasks are destructed as soon as their flow graphs let go of them
+  {
+    std::lock_guard<std::shared_timed_mutex> tasks_lock(tasks_mutex_);
+    synchronous_tasks_.clear();
+    asynchronous_tasks_.clear();
+  }
+
+  // The trees use the task manager until they return, hence the trees of the abandoned tasks are
+  // waited for as well, while the task events are still drained
+  if (!sft_executor_.waitIdle(std::chrono::steady_clock::now() + task_stop_timeout_))
+  {
+    TEMOTO_ERROR("Some of the task trees have not returned, waiting for the abandoned tasks to end");
+  }
+  sft_executor_.join();
+
+  // Stop draining the task events
+  task_events_.abort();
+  if (task_event_thread_.joinable())
+  {
+    task_event_thread_.join();
+  }
+
+  TEMOTO_INFO("All actions stopped in %ld ms",
+              static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - shutdown_start).count()));
 }
 
 }// END of TTP namespace
@@ -17,7 +17,8 @@ AlgorithmManagerServers::AlgorithmManagerServers(BaseSubsystem *b, AlgorithmInfo
   // Start the server
   resource_manager_.addServer<temoto_2::LoadAlgorithm>( srv_name::SERVER
                                                    , &AlgorithmManagerServers::loadAlgorithmCb
-                                                   , &AlgorithmManagerServers::unloadAlgorithmCb);
+                                                   , &AlgorithmManagerServers::unloadAlgorithmCb
+                                                   , rmp::PARALLEL_LOAD_THREAD_COUNT);
   // Register callback for status info
   resource_manager_.registerStatusCb(&AlgorithmManagerServers::statusCb);
 
@@ -38,6 +39,7 @@ void AlgorithmManagerServers::statusCb(temoto_2::ResourceStatus& srv)
   // synchronizer.
   if (srv.request.status_code == rmp::status_codes::FAILED)
   {
+    std::lock_guard<std::mutex> lock(allocated_algorithms_mutex_);
     auto it = allocated_algorithms_.find(srv.request.resource_id);
     if (it != allocated_algorithms_.end())
     {
@@ -110,7 +112,10 @@ void AlgorithmManagerServers::loadAlgorithmCb( temoto_2::LoadAlgorithm::Request&
       throw FORWARD_ERROR(error_stack);
     }
 
-    allocated_algorithms_.emplace(res.rmp.resource_id, ai);
+    {
+      std::lock_guard<std::mutex> lock(allocated_algorithms_mutex_);
+      allocated_algorithms_.emplace(res.rmp.resource_id, ai);
+    }
 
     return;
   }
@@ -147,6 +152,7 @@ void AlgorithmManagerServers::loadAlgorithmCb( temoto_2::LoadAlgorithm::Request&
 
       TEMOTO_DEBUG("Call to remote AlgorithmManagerServers was sucessful.");
       res = load_algorithm_msg.response;
+      std::lock_guard<std::mutex> lock(allocated_algorithms_mutex_);
       allocated_algorithms_.emplace(res.rmp.resource_id, ai);
     }
     catch(error::ErrorStack& error_stack)
@@ -167,6 +173,7 @@ void AlgorithmManagerServers::unloadAlgorithmCb(temoto_2::LoadAlgorithm::Request
                                  temoto_2::LoadAlgorithm::Response& res)
 {
   TEMOTO_DEBUG("received a request to stop algorithm with id '%ld'", res.rmp.resource_id);
+  std::lock_guard<std::mutex> lock(allocated_algorithms_mutex_);
   allocated_algorithms_.erase(res.rmp.resource_id);
   return;
 }
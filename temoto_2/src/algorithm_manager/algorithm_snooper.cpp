@@ -18,8 +18,8 @@ AlgorithmSnooper::AlgorithmSnooper( BaseSubsystem*b
 , action_engine_(this, false, ros::package::getPath(ROS_PACKAGE_NAME) + "/../temoto_actions/resource_snooper_actions")
 , sid_(sid)
 {
-  // Algorithm Info update monitoring timer
-  update_monitoring_timer_ = nh_.createTimer(ros::Duration(1), &AlgorithmSnooper::updateMonitoringTimerCb, this);
+  // Advertise every change of the local algorithm infos to other instances of temoto
+  sid_->setUpdateCallback([this](const AlgorithmInfo& si) { advertiseAlgorithm(si); });
 
   // Get remote algorithm_infos
   config_syncer_.requestRemoteConfigs();
@@ -46,7 +46,7 @@ void AlgorithmSnooper::startSnooping()
   sub_0.addData("string", catkin_ws);
 
   // This object will be updated inside the tracking AImp (action implementation)
-  sub_0.addData("pointer", boost::any_cast<AlgorithmInfoRegistry*>(sid_));
+  sub_0.addData("pointer", TTP::DataValue(sid_));
 
   subjects.push_back(sub_0);
 
@@ -62,36 +62,47 @@ void AlgorithmSnooper::startSnooping()
   TTP::TaskTreeNode& root_node = sft.getRootNode();
   sft.printTaskDescriptors(root_node);
 
-  // Execute the SFT
-  action_engine_.executeSFTThreaded(std::move(sft));
+  // Execute the SFT. The snooping is not started if the executor does not admit the tree.
+  try
+  {
+    action_engine_.executeSFTThreaded(std::move(sft));
+  }
+  catch (error::ErrorStack& error_stack)
+  {
+    TEMOTO_ERROR("Unable to start snooping for algorithms.");
+    FORWARD_ERROR(error_stack);
+  }
 }
 
-void AlgorithmSnooper::advertiseAlgorithm(AlgorithmInfo& si) const
+void AlgorithmSnooper::advertiseAlgorithm(const AlgorithmInfo& si) const
 {
   //TEMOTO_DEBUG("------ Advertising Algorithm \n %s", algorithm_ptr->toString().c_str());
-  YAML::Node config;
-  config["Algorithms"].push_back(si);
-  PayloadType payload;
-  payload.data = Dump(config);
-  config_syncer_.advertise(payload);
+  config_syncer_.advertiseEntry(getSyncKey(si), getSyncPayload(si));
 }
 
 void AlgorithmSnooper::advertiseLocalAlgorithms() const
 {
-  // publish all local algorithms
-  YAML::Node config;
+  // publish the local algorithms, only the ones that have changed are sent to other managers
+  std::vector<std::pair<std::string, PayloadType>> entries;
   for(const auto& s : sid_->getLocalAlgorithms())
   {
-    config["Algorithms"].push_back(s);
+    entries.emplace_back(getSyncKey(s), getSyncPayload(s));
   }
+  config_syncer_.advertiseEntries(entries);
+}
 
-  // send to other managers if there is anything to send
-  if(config.size())
-  {
-    PayloadType payload;
-    payload.data = Dump(config);
-    config_syncer_.advertise(payload);
-  }
+std::string AlgorithmSnooper::getSyncKey(const AlgorithmInfo& si)
+{
+  return si.getPackageName() + "/" + si.getExecutable() + "/" + si.getName();
+}
+
+AlgorithmSnooper::PayloadType AlgorithmSnooper::getSyncPayload(const AlgorithmInfo& si)
+{
+  YAML::Node config;
+  config["Algorithms"].push_back(si);
+  PayloadType payload;
+  payload.data = Dump(config);
+  return payload;
 }
 
 std::vector<AlgorithmInfoPtr> AlgorithmSnooper::parseAlgorithms(const YAML::Node& config)
@@ -190,19 +201,9 @@ void AlgorithmSnooper::syncCb(const temoto_2::ConfigSync& msg, const PayloadType
   }
 }
 
-void AlgorithmSnooper::updateMonitoringTimerCb(const ros::TimerEvent& e)
+AlgorithmSnooper::~AlgorithmSnooper()
 {
-
-  // Iterate through local algorithms and check if their reliability has been updated
-  for (const auto algorithm : sid_->getLocalAlgorithms())
-  {
-    if (!algorithm.getAdvertised())
-    {
-      AlgorithmInfo si = algorithm;
-      sid_->updateLocalAlgorithm(si, true);
-      advertiseAlgorithm(si);
-    }
-  }
+  sid_->setUpdateCallback(nullptr);
 }
 
 } // algorithm_manager namespace
@@ -0,0 +1,65 @@
+#ifndef BENCHMARK_TOOLS_H
+#define BENCHMARK_TOOLS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace benchmark_tools
+{
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Microseconds elapsed since the given time point
+ */
+inline double elapsedUs(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Value below which the given fraction of the samples falls. The samples are sorted in place.
+ */
+inline double percentile(std::vector<double>& samples, double fraction)
+{
+  if (samples.empty())
+  {
+    return 0.0;
+  }
+  std::sort(samples.begin(), samples.end());
+  size_t index = static_cast<size_t>(fraction * (samples.size() - 1) + 0.5);
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+/**
+ * @brief Prints the p50, p99 and max of latency samples given in microseconds
+ */
+inline void printLatencies(const std::string& name, std::vector<double> samples_us)
+{
+  printf("%-40s n=%-7zu p50=%10.1f us  p99=%10.1f us  max=%10.1f us\n",
+         name.c_str(), samples_us.size(),
+         percentile(samples_us, 0.50), percentile(samples_us, 0.99), percentile(samples_us, 1.0));
+}
+
+/**
+ * @brief Reads a positive integer argument, or returns the default if it is not given
+ */
+inline unsigned int getArgument(int argc, char** argv, int index, unsigned int default_value)
+{
+  if (index < argc)
+  {
+    int value = std::atoi(argv[index]);
+    if (value > 0)
+    {
+      return static_cast<unsigned int>(value);
+    }
+  }
+  return default_value;
+}
+
+} // benchmark_tools namespace
+#endif
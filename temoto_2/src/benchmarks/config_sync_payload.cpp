@@ -0,0 +1,129 @@
+/*
+ * Measures the cost of carrying an object list through the ConfigSynchronizer with the payload
+ * handling it had before (serialization into a temporary array which is copied byte by byte into
+ * the message, the message published by value, the payload copied out again before deserializing)
+ * and the one it has now (serialization straight into the message, the message published by
+ * pointer and the payload deserialized in place). The publishing is emulated, so the numbers show
+ * the cost of the copies and not of the transport.
+ *
+ * Usage: config_sync_payload [rounds] [objects]
+ */
+
+#include "benchmark_tools.h"
+
+#include "rmp/message_serialization.h"
+#include "temoto_2/ConfigSync.h"
+#include "context_manager/context_manager_containers.h"
+#include <boost/make_shared.hpp>
+#include <boost/shared_array.hpp>
+
+using namespace benchmark_tools;
+namespace ser = ros::serialization;
+
+namespace
+{
+
+context_manager::Objects makeObjects(unsigned int object_count)
+{
+  context_manager::Objects objects(object_count);
+  for (unsigned int i = 0; i < object_count; i++)
+  {
+    temoto_2::ObjectContainer& object = objects[i];
+    object.name = "object_" + std::to_string(i);
+    object.detection_methods.push_back(temoto_2::ObjectContainer::ARTAG);
+    object.tag_id = i;
+    object.marker.ns = object.name;
+    object.marker.points.resize(8);
+    object.mesh.vertices.resize(8);
+    object.pose.header.frame_id = "world";
+  }
+  return objects;
+}
+
+/**
+ * @brief The payload handling as it was
+ */
+size_t syncByCopy(const context_manager::Objects& objects)
+{
+  // advertise
+  temoto_2::ConfigSync msg;
+  uint32_t payload_size = ser::serializationLength(objects);
+  boost::shared_array<uint8_t> buffer(new uint8_t[payload_size]);
+  ser::OStream stream(buffer.get(), payload_size);
+  ser::serialize(stream, objects);
+
+  std::vector<uint8_t> payload_byte_array;
+  for (uint32_t i = 0; i < payload_size; i++)
+  {
+    payload_byte_array.push_back(buffer.get()[i]);
+  }
+  msg.payload = payload_byte_array;
+
+  // publish by value, the subscriber gets its own message
+  temoto_2::ConfigSync received_msg;
+  rmp::deserializeMessage(rmp::serializeMessage(msg), received_msg);
+
+  // receive
+  uint32_t received_size = received_msg.payload.size();
+  boost::shared_array<uint8_t> received_buffer(new uint8_t[received_size]);
+  for (uint32_t i = 0; i < received_size; i++)
+  {
+    received_buffer.get()[i] = received_msg.payload[i];
+  }
+  context_manager::Objects received_objects;
+  ser::IStream received_stream(received_buffer.get(), received_size);
+  ser::deserialize(received_stream, received_objects);
+  return received_objects.size();
+}
+
+/**
+ * @brief The payload handling as it is now
+ */
+size_t syncInPlace(const context_manager::Objects& objects)
+{
+  // advertise
+  temoto_2::ConfigSync::Ptr msg = boost::make_shared<temoto_2::ConfigSync>();
+  rmp::serializeMessage(objects, msg->payload);
+
+  // publish by pointer, the subscriber shares the message
+  temoto_2::ConfigSync::ConstPtr received_msg = msg;
+
+  // receive
+  context_manager::Objects received_objects;
+  rmp::deserializeMessage(received_msg->payload.data(), received_msg->payload.size(),
+                          received_objects);
+  return received_objects.size();
+}
+
+template <class Sync>
+void run(const std::string& name, unsigned int round_count, const context_manager::Objects& objects,
+         Sync sync)
+{
+  std::vector<double> latencies;
+  for (unsigned int i = 0; i < round_count; i++)
+  {
+    Clock::time_point start = Clock::now();
+    if (sync(objects) != objects.size())
+    {
+      printf("%s lost objects\n", name.c_str());
+    }
+    latencies.push_back(elapsedUs(start));
+  }
+  printLatencies(name, latencies);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned int round_count = getArgument(argc, argv, 1, 200);
+  unsigned int object_count = getArgument(argc, argv, 2, 1000);
+
+  context_manager::Objects objects = makeObjects(object_count);
+  printf("%u rounds of %u objects, %u bytes of payload\n", round_count, object_count,
+         ser::serializationLength(objects));
+
+  run("before (copied payload)", round_count, objects, syncByCopy);
+  run("after (in-place payload)", round_count, objects, syncInPlace);
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Measures how many processes per second the process manager can start with the launcher it used
+ * before (fork and exec of "bash -c <command>") and with the one it uses now (posix_spawn of the
+ * resolved program). Each child is waited for before the next one is started, so the numbers
+ * show the cost of starting a process, not of running many at once.
+ *
+ * The cost of fork grows with the memory of the parent, hence the process manager's heap can be
+ * emulated by allocating and touching some memory before spawning.
+ *
+ * Usage: process_spawn_rate [spawns] [heap_mb] [program]
+ */
+
+#include "benchmark_tools.h"
+
+#include <cstring>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace benchmark_tools;
+
+namespace
+{
+
+bool waitForChild(pid_t pid)
+{
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief The launcher as it was: fork, then exec bash which runs the command line
+ */
+bool spawnThroughBash(const std::string& command)
+{
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    execlp("/bin/bash", "/bin/bash", "-c", command.c_str(), (char*)NULL);
+    _exit(127);
+  }
+  return pid > 0 && waitForChild(pid);
+}
+
+/**
+ * @brief The launcher as it is now: posix_spawn of the program itself
+ */
+bool spawnDirectly(const std::string& program)
+{
+  char* argv[] = { const_cast<char*>(program.c_str()), NULL };
+  pid_t pid;
+  if (posix_spawn(&pid, program.c_str(), NULL, NULL, argv, environ) != 0)
+  {
+    return false;
+  }
+  return waitForChild(pid);
+}
+
+template <class Launcher>
+void run(const std::string& name, unsigned int spawn_count, Launcher launch)
+{
+  std::vector<double> latencies;
+  unsigned int failures = 0;
+  Clock::time_point start = Clock::now();
+  for (unsigned int i = 0; i < spawn_count; i++)
+  {
+    Clock::time_point spawn_start = Clock::now();
+    if (!launch())
+    {
+      failures++;
+    }
+    latencies.push_back(elapsedUs(spawn_start));
+  }
+  double total_s = elapsedUs(start) / 1e6;
+
+  printf("%-40s %8.1f spawns/s, %u failed\n", name.c_str(), spawn_count / total_s, failures);
+  printLatencies("  " + name, latencies);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned int spawn_count = getArgument(argc, argv, 1, 500);
+  unsigned int heap_mb = getArgument(argc, argv, 2, 256);
+  std::string program = (argc > 3) ? argv[3] : "/bin/true";
+
+  // Emulate the memory of a long running process manager
+  std::vector<char> heap(static_cast<size_t>(heap_mb) << 20);
+  memset(heap.data(), 1, heap.size());
+
+  printf("%u spawns of '%s' with a %u MB heap\n", spawn_count, program.c_str(), heap_mb);
+  run("before (fork + bash -c)", spawn_count, [&] { return spawnThroughBash(program); });
+  run("after (posix_spawn)", spawn_count, [&] { return spawnDirectly(program); });
+  return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Measures the latency of concurrent RMP load requests under the locking which was used before
+ * (try_lock polling with sleeps, as in the old waitForLock functions) and the one used now
+ * (blocking scoped locks). This is a model of the locks, not a run of ResourceServer and
+ * ResourceManager, as those need a ROS master. Each simulated load follows the locking pattern of
+ * ResourceServer::wrappedLoadCallback: the manager's client registry is locked for bookkeeping,
+ * the queries are locked for the lookup, the owner's callback runs without the lock and the
+ * queries are locked again to store the response. The ROS transport is not involved, so the
+ * numbers show only the latency added by the locking. The tail latencies depend on the number of
+ * cores, which is printed along with the results.
+ *
+ * Usage: rmp_lock_contention [threads] [loads_per_thread] [callback_us]
+ */
+
+#include "benchmark_tools.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+using namespace benchmark_tools;
+
+namespace
+{
+
+// Polling intervals of the old waitForLock functions
+const std::chrono::milliseconds MANAGER_POLL_INTERVAL(200);
+const std::chrono::milliseconds SERVER_POLL_INTERVAL(10);
+
+// Time spent on bookkeeping while a lock is held
+const std::chrono::microseconds BOOKKEEPING_TIME(20);
+
+void busyWait(std::chrono::microseconds duration)
+{
+  Clock::time_point end = Clock::now() + duration;
+  while (Clock::now() < end)
+  {
+  }
+}
+
+/**
+ * @brief The locking as it was: try_lock in a loop, sleeping between the tries
+ */
+struct PollingLocks
+{
+  std::mutex clients_mutex;
+  std::mutex queries_mutex;
+
+  static void waitForLock(std::mutex& m, std::chrono::milliseconds interval)
+  {
+    while (!m.try_lock())
+    {
+      std::this_thread::sleep_for(interval);
+    }
+  }
+
+  void load(std::chrono::microseconds callback_time)
+  {
+    waitForLock(clients_mutex, MANAGER_POLL_INTERVAL);
+    busyWait(BOOKKEEPING_TIME);
+    clients_mutex.unlock();
+
+    waitForLock(queries_mutex, SERVER_POLL_INTERVAL);
+    busyWait(BOOKKEEPING_TIME);
+    queries_mutex.unlock();
+
+    std::this_thread::sleep_for(callback_time);
+
+    waitForLock(queries_mutex, SERVER_POLL_INTERVAL);
+    busyWait(BOOKKEEPING_TIME);
+    queries_mutex.unlock();
+  }
+};
+
+/**
+ * @brief The locking as it is now: blocking RAII locks on shared_timed_mutex registries
+ */
+struct BlockingLocks
+{
+  std::shared_timed_mutex clients_mutex;
+  std::shared_timed_mutex queries_mutex;
+
+  void load(std::chrono::microseconds callback_time)
+  {
+    {
+      std::lock_guard<std::shared_timed_mutex> lock(clients_mutex);
+      busyWait(BOOKKEEPING_TIME);
+    }
+    {
+      std::lock_guard<std::shared_timed_mutex> lock(queries_mutex);
+      busyWait(BOOKKEEPING_TIME);
+    }
+
+    std::this_thread::sleep_for(callback_time);
+
+    {
+      std::lock_guard<std::shared_timed_mutex> lock(queries_mutex);
+      busyWait(BOOKKEEPING_TIME);
+    }
+  }
+};
+
+template <class Locks>
+std::vector<double> run(unsigned int thread_count, unsigned int loads_per_thread,
+                        std::chrono::microseconds callback_time)
+{
+  Locks locks;
+  std::vector<std::vector<double>> latencies(thread_count);
+  std::atomic<bool> go(false);
+  std::vector<std::thread> threads;
+
+  for (unsigned int t = 0; t < thread_count; t++)
+  {
+    threads.emplace_back([&, t]
+    {
+      while (!go)
+      {
+        std::this_thread::yield();
+      }
+      for (unsigned int i = 0; i < loads_per_thread; i++)
+      {
+        Clock::time_point start = Clock::now();
+        locks.load(callback_time);
+        latencies[t].push_back(elapsedUs(start));
+      }
+    });
+  }
+
+  go = true;
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  std::vector<double> all_latencies;
+  for (const auto& thread_latencies : latencies)
+  {
+    all_latencies.insert(all_latencies.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  return all_latencies;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned int thread_count = getArgument(argc, argv, 1, 8);
+  unsigned int loads_per_thread = getArgument(argc, argv, 2, 100);
+  std::chrono::microseconds callback_time(getArgument(argc, argv, 3, 1000));
+
+  printf("%u concurrent loaders, %u loads each, %ld us owner callback, %u cores\n",
+         thread_count, loads_per_thread, static_cast<long>(callback_time.count()),
+         std::thread::hardware_concurrency());
+
+  printLatencies("before (polling waitForLock)", run<PollingLocks>(thread_count, loads_per_thread, callback_time));
+  printLatencies("after (blocking scoped locks)", run<BlockingLocks>(thread_count, loads_per_thread, callback_time));
+  return 0;
+}
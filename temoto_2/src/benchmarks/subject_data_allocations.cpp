@@ -0,0 +1,169 @@
+/*
+ * Counts the heap allocations made while the subjects flow through a task tree of 10 nodes, with
+ * the subject data stored as it was before (boost::any, every child receiving a copy of the
+ * outputs of its parent) and as it is now (TTP::DataValue, the children sharing the outputs of
+ * their parent). Each node reads the data of its input subjects and creates output subjects with
+ * a number, a topic and a pointer, as the tasks do. The allocations are counted by replacing the
+ * global operator new.
+ *
+ * Usage: subject_data_allocations [rounds]
+ */
+
+#include "benchmark_tools.h"
+
+#include "TTP/io_descriptor.h"
+#include <boost/any.hpp>
+#include <atomic>
+#include <new>
+
+using namespace benchmark_tools;
+
+namespace
+{
+std::atomic<size_t> allocation_count(0);
+}
+
+void* operator new(std::size_t size)
+{
+  allocation_count++;
+  if (void* memory = std::malloc(size))
+  {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+namespace
+{
+
+// Children of each node: the root has 3 children and each of them 2, which gives 10 nodes
+const std::vector<unsigned int> CHILDREN_PER_LEVEL = { 3, 2, 0 };
+
+const std::string TOPIC = "/temoto/camera/image_raw";
+
+int pointed_object = 0;
+
+/**
+ * @brief Subject data as it was stored before
+ */
+struct AnyData
+{
+  std::string type;
+  boost::any value;
+};
+
+struct AnySubject
+{
+  std::string type_;
+  std::string pos_tag_;
+  std::vector<std::string> words_;
+  std::vector<AnyData> data_;
+  bool is_complete_ = false;
+};
+
+typedef std::vector<AnySubject> AnySubjects;
+
+/**
+ * @brief A node as it was: the data is read with boost::any_cast and each child gets a copy of
+ * the outputs
+ */
+double runAnyNode(AnySubjects inputs, unsigned int level)
+{
+  double sum = 0;
+  for (const auto& subject : inputs)
+  {
+    sum += boost::any_cast<double>(subject.data_[0].value);
+    sum += boost::any_cast<std::string>(subject.data_[1].value).size();
+    sum += *boost::any_cast<int*>(subject.data_[2].value);
+  }
+
+  AnySubjects outputs(2);
+  for (auto& subject : outputs)
+  {
+    subject.type_ = "what";
+    subject.words_.push_back("object");
+    subject.data_.push_back(AnyData{ "number", boost::any(1.0) });
+    subject.data_.push_back(AnyData{ "topic", boost::any(TOPIC) });
+    subject.data_.push_back(AnyData{ "pointer", boost::any(&pointed_object) });
+  }
+
+  for (unsigned int i = 0; i < CHILDREN_PER_LEVEL[level]; i++)
+  {
+    sum += runAnyNode(outputs, level + 1);
+  }
+  return sum;
+}
+
+/**
+ * @brief A node as it is now: the data is read with DataValue::get and the children share the
+ * outputs
+ */
+double runValueNode(const TTP::SubjectsPtr& inputs, unsigned int level)
+{
+  double sum = 0;
+  for (const auto& subject : *inputs)
+  {
+    sum += subject.data_[0].value.get<double>();
+    sum += subject.data_[1].value.get<std::string>().size();
+    sum += *subject.data_[2].value.get<int*>();
+  }
+
+  auto outputs = std::make_shared<TTP::Subjects>(2);
+  for (auto& subject : *outputs)
+  {
+    subject.type_ = "what";
+    subject.words_.push_back("object");
+    subject.data_.emplace_back("number", 1.0);
+    subject.data_.emplace_back("topic", TOPIC);
+    subject.data_.emplace_back("pointer", &pointed_object);
+  }
+
+  TTP::SubjectsPtr shared_outputs = std::move(outputs);
+  for (unsigned int i = 0; i < CHILDREN_PER_LEVEL[level]; i++)
+  {
+    sum += runValueNode(shared_outputs, level + 1);
+  }
+  return sum;
+}
+
+template <class Tree>
+void run(const std::string& name, unsigned int round_count, Tree tree)
+{
+  std::vector<double> latencies;
+  latencies.reserve(round_count);
+  size_t allocations_before = allocation_count;
+  for (unsigned int i = 0; i < round_count; i++)
+  {
+    Clock::time_point start = Clock::now();
+    tree();
+    latencies.push_back(elapsedUs(start));
+  }
+  size_t allocations = allocation_count - allocations_before;
+
+  printf("%-40s %8.1f allocations per tree\n", name.c_str(),
+         static_cast<double>(allocations) / round_count);
+  printLatencies("  " + name, latencies);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned int round_count = getArgument(argc, argv, 1, 10000);
+  printf("%u runs of a 10 node task tree\n", round_count);
+
+  run("before (boost::any, copied)", round_count, [] { return runAnyNode(AnySubjects(), 0); });
+  run("after (DataValue, shared)", round_count,
+      [] { return runValueNode(std::make_shared<const TTP::Subjects>(), 0); });
+  return 0;
+}
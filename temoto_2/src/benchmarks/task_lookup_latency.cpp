@@ -0,0 +1,123 @@
+/*
+ * Measures how the time of finding the task for a task tree node grows with the number of indexed
+ * actions, with the lookup used before (a scan over all indexed tasks, copying each matching task
+ * into the candidates) and the one used now (TaskIndex). The lookup is the part of the path from
+ * an instruction to its execution which depends on the number of indexed tasks, the parsing and
+ * the loading of the task do not.
+ *
+ * Usage: task_lookup_latency [lookups] [max_actions]
+ */
+
+#include "benchmark_tools.h"
+
+#include "TTP/task_index.h"
+#include <random>
+
+using namespace benchmark_tools;
+using namespace TTP;
+
+namespace
+{
+
+const std::vector<std::string> SUBJECT_TYPES = { "what", "where", "numeric" };
+
+/**
+ * @brief Tasks of distinct actions, each with an interface for every subject type
+ */
+std::vector<TaskDescriptor> makeTasks(unsigned int action_count)
+{
+  std::vector<TaskDescriptor> tasks;
+  tasks.reserve(action_count);
+  for (unsigned int i = 0; i < action_count; i++)
+  {
+    Action action = "action_" + std::to_string(i);
+    tasks.emplace_back(action, action);
+    std::vector<TaskInterface>& interfaces = tasks.back().getInterfaces();
+    interfaces.clear();
+    for (unsigned int t = 0; t < SUBJECT_TYPES.size(); t++)
+    {
+      TaskInterface task_interface;
+      task_interface.id_ = t;
+      task_interface.input_subjects_.emplace_back(SUBJECT_TYPES[t], "word");
+      task_interface.output_subjects_.emplace_back(SUBJECT_TYPES[t], "word");
+      interfaces.push_back(task_interface);
+    }
+  }
+  return tasks;
+}
+
+/**
+ * @brief The lookup as it was: every indexed task is compared against the action and the
+ * matching tasks are copied into the candidates. The tasks are created with the stemmed action
+ * equal to the action, so the action is compared.
+ */
+size_t scanTasks(std::vector<TaskDescriptor>& tasks, const Action& action,
+                 const std::vector<Subject>& subjects)
+{
+  std::vector<std::pair<TaskDescriptor, TaskInterface>> candidates;
+  for (auto& task : tasks)
+  {
+    if (task.getAction() != action)
+    {
+      continue;
+    }
+    for (const auto& task_interface : task.getInterfaces())
+    {
+      if (task_interface.input_subjects_.front().type_ == subjects.front().type_)
+      {
+        candidates.emplace_back(task, task_interface);
+      }
+    }
+  }
+  return candidates.size();
+}
+
+template <class Lookup>
+void run(const std::string& name, unsigned int lookup_count, unsigned int action_count,
+         Lookup lookup)
+{
+  std::mt19937 random(action_count);
+  std::uniform_int_distribution<unsigned int> action_number(0, action_count - 1);
+  std::vector<Subject> subjects = { Subject("where", "here") };
+
+  std::vector<double> latencies;
+  for (unsigned int i = 0; i < lookup_count; i++)
+  {
+    Action action = "action_" + std::to_string(action_number(random));
+    Clock::time_point start = Clock::now();
+    if (lookup(action, subjects) != 1)
+    {
+      printf("%s did not find %s\n", name.c_str(), action.c_str());
+    }
+    latencies.push_back(elapsedUs(start));
+  }
+  printLatencies(name, latencies);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+  unsigned int lookup_count = getArgument(argc, argv, 1, 1000);
+  unsigned int max_action_count = getArgument(argc, argv, 2, 10000);
+
+  for (unsigned int action_count = 10; action_count <= max_action_count; action_count *= 10)
+  {
+    std::vector<TaskDescriptor> tasks = makeTasks(action_count);
+    TaskIndex task_index;
+    task_index.build(tasks);
+
+    printf("%u indexed actions, %u lookups\n", action_count, lookup_count);
+    run("  before (scan)", lookup_count, action_count,
+        [&](const Action& action, const std::vector<Subject>& subjects)
+        {
+          return scanTasks(tasks, action, subjects);
+        });
+    run("  after (TaskIndex)", lookup_count, action_count,
+        [&](const Action& action, const std::vector<Subject>& subjects)
+        {
+          return task_index.findInterfaces(action, subjects).size();
+        });
+  }
+  return 0;
+}
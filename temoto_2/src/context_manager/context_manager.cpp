@@ -4,6 +4,7 @@
 #include <utility>
 #include <yaml-cpp/yaml.h>
 #include <fstream>
+#include <future>
 
 namespace context_manager
 {
@@ -122,28 +123,30 @@ void ContextManager::trackedObjectsSyncCb(const temoto_2::ConfigSync& msg, const
  */
 void ContextManager::addOrUpdateObjects(const Objects& objects_to_add, bool from_other_manager)
 {
-  // Loop over the list of provided objects
-  for (auto object : objects_to_add)
+  // Loop over the list of provided objects, each object is copied only into its new container
+  for (const auto& object_to_add : objects_to_add)
   {
+    ObjectPtr object = std::make_shared<temoto_2::ObjectContainer>(object_to_add);
+
     // Replace all spaces in the name with the underscore character
-    std::replace(object.name.begin(), object.name.end(), ' ', '_');
+    std::replace(object->name.begin(), object->name.end(), ' ', '_');
 
     // Check if the object has to be added or updated
     auto it = std::find_if(objects_.begin(), objects_.end(),
-        [&](const ObjectPtr& o_ptr) { return *o_ptr == object; });
+        [&](const ObjectPtr& o_ptr) { return *o_ptr == *object; });
 
     // Update the object
     if (it != objects_.end())
     {
-      TEMOTO_DEBUG("Updating object: '%s'.", object.name.c_str());
-      *it = std::make_shared<temoto_2::ObjectContainer>(object);
+      TEMOTO_DEBUG("Updating object: '%s'.", object->name.c_str());
+      *it = object;
     }
 
     // Add new object
     else
     {
-      TEMOTO_DEBUG("Adding new object: '%s'.", object.name.c_str());
-      objects_.push_back(std::make_shared<temoto_2::ObjectContainer>(object));
+      TEMOTO_DEBUG("Adding new object: '%s'.", object->name.c_str());
+      objects_.push_back(object);
     }
   }
 
@@ -162,6 +165,7 @@ void ContextManager::advertiseAllObjects()
 {
   // Publish all objects
   Objects objects_payload;
+  objects_payload.reserve(objects_.size());
 
   for (auto& object : objects_)
   {
@@ -335,7 +339,7 @@ void ContextManager::loadTrackObjectCb(temoto_2::TrackObject::Request& req, temo
       sub_1.addData("topic", tracked_object_topic);
 
       // This object will be updated inside the tracking AImp (action implementation)
-      sub_1.addData("pointer", boost::any_cast<ObjectPtr>(requested_object));
+      sub_1.addData("pointer", TTP::DataValue(requested_object));
 
       subjects.push_back(sub_0);
       subjects.push_back(sub_1);
@@ -394,7 +398,7 @@ void ContextManager::loadTrackObjectCb(temoto_2::TrackObject::Request& req, temo
       sub_1.addData("topic", tracked_object_topic);
 
       // This object will be updated inside the tracking AImp (action implementation)
-      sub_1.addData("pointer", boost::any_cast<ObjectPtr>(requested_object));
+      sub_1.addData("pointer", TTP::DataValue(requested_object));
 
       subjects.push_back(sub_0);
       subjects.push_back(sub_1);
@@ -461,8 +465,21 @@ void ContextManager::unloadTrackObjectCb(temoto_2::TrackObject::Request& req,
     TEMOTO_DEBUG_STREAM("Received a request to stop tracking an object named: '"
                         << tracked_object << "'");
 
-    // Stop tracking the object
-    tracker_core_.stopTask("", tracked_object);
+    // Stop tracking the object. A tracker which did not stop in time has been abandoned by the
+    // task manager, so the object is not tracked anymore either way
+    try
+    {
+      tracker_core_.stopTask("", tracked_object);
+    }
+    catch (error::ErrorStack& error_stack)
+    {
+      if (error_stack.front().code != static_cast<int>(error::Code::TASK_STOP_TIMEOUT))
+      {
+        throw FORWARD_ERROR(error_stack);
+      }
+      TEMOTO_ERROR_STREAM("The tracker of '" << tracked_object << "' did not stop in time");
+      FORWARD_ERROR(error_stack);
+    }
 
     // Erase the object from the map of tracked objects
     m_tracked_objects_local_.erase(res.rmp.resource_id);
@@ -632,76 +649,121 @@ void ContextManager::loadTrackerCb(temoto_2::LoadTracker::Request& req,
     // TODO: REMOVE AFTER RMP HAS THIS FUNCTIONALITY
     std::vector<int> sub_resource_ids;
 
-    for (unsigned int i=0; i<pipe.size(); i++)
+    /*
+     * The algorithms publish to the output topics chosen here, hence the input topics of a filter
+     * are known without waiting for the preceding algorithm to load. The algorithms are loaded
+     * concurrently, so the pipe is ready as soon as its slowest filter is.
+     */
+    std::vector<std::future<temoto_2::LoadAlgorithm>> algorithm_loads;
+    error::ErrorStack load_errors;
+
+    try
     {
-      /*
-       * If the filter is a sensor
-       */
-      if (pipe.at(i).filter_category_ == "sensor")
+      for (unsigned int i=0; i<pipe.size(); i++)
       {
-        // Compose the LoadSensor message
-        temoto_2::LoadSensor load_sensor_msg;
-        load_sensor_msg.request.sensor_type = pipe.at(i).filter_type_;
-        load_sensor_msg.request.output_topics = required_topics.outputTopicsAsKeyValues();
+        /*
+         * If the filter is a sensor
+         */
+        if (pipe.at(i).filter_category_ == "sensor")
+        {
+          // Compose the LoadSensor message
+          temoto_2::LoadSensor load_sensor_msg;
+          load_sensor_msg.request.sensor_type = pipe.at(i).filter_type_;
+          load_sensor_msg.request.output_topics = required_topics.outputTopicsAsKeyValues();
 
-        // Call the Sensor Manager
-        resource_manager_2_.call<temoto_2::LoadSensor>(sensor_manager::srv_name::MANAGER,
-                                                       sensor_manager::srv_name::SERVER,
-                                                       load_sensor_msg);
+          // Call the Sensor Manager. The output topics are decided by the sensor manager, so the
+          // response is needed before the proceeding filters can be loaded.
+          resource_manager_2_.call<temoto_2::LoadSensor>(sensor_manager::srv_name::MANAGER,
+                                                         sensor_manager::srv_name::SERVER,
+                                                         load_sensor_msg);
 
-        // TODO: REMOVE AFTER RMP HAS THIS FUNCTIONALITY
-        sub_resource_ids.push_back(load_sensor_msg.response.rmp.resource_id);
+          // TODO: REMOVE AFTER RMP HAS THIS FUNCTIONALITY
+          sub_resource_ids.push_back(load_sensor_msg.response.rmp.resource_id);
 
-        required_topics.setInputTopicsByKeyValue(load_sensor_msg.response.output_topics);
+          required_topics.setInputTopicsByKeyValue(load_sensor_msg.response.output_topics);
 
-        // This line is necessary if the pipe size is 1
-        required_topics.setOutputTopicsByKeyValue(load_sensor_msg.response.output_topics);
-      }
+          // This line is necessary if the pipe size is 1
+          required_topics.setOutputTopicsByKeyValue(load_sensor_msg.response.output_topics);
+        }
 
-      /*
-       * If the filter is an algorithm
-       */
-      else if (pipe.at(i).filter_category_ == "algorithm")
-      {
+        /*
+         * If the filter is an algorithm
+         */
+        else if (pipe.at(i).filter_category_ == "algorithm")
+        {
 
-        // Clear out the required output topics
-        required_topics.clearOutputTopics();
+          // Clear out the required output topics
+          required_topics.clearOutputTopics();
 
-        // If it is not the last filter then ...
-        if (i != pipe.size()-1)
-        {
-          // ... get the requirements for the output topic types from the proceding filter
-          for (auto& topic_type : pipe.at(i+1).required_input_topic_types_)
+          // If it is not the last filter then ...
+          if (i != pipe.size()-1)
           {
-            required_topics.addOutputTopic(topic_type, "/" + pipe_id + "/filter_" + std::to_string(i) + "/" + topic_type);
+            // ... get the requirements for the output topic types from the proceding filter
+            for (auto& topic_type : pipe.at(i+1).required_input_topic_types_)
+            {
+              required_topics.addOutputTopic(topic_type, "/" + pipe_id + "/filter_" + std::to_string(i) + "/" + topic_type);
+            }
           }
-        }
-        else
-        {
-          // ... get the requirements for the output topics from own output topic requirements
-          // TODO: throw if the "required_output_topic_types_" is empty
-          for (auto& topic_type : pipe.at(i).required_output_topic_types_)
+          else
           {
-            required_topics.addOutputTopic(topic_type, "/" + pipe_id + "/filter_" + std::to_string(i) + "/" + topic_type);
+            // ... get the requirements for the output topics from own output topic requirements
+            // TODO: throw if the "required_output_topic_types_" is empty
+            for (auto& topic_type : pipe.at(i).required_output_topic_types_)
+            {
+              required_topics.addOutputTopic(topic_type, "/" + pipe_id + "/filter_" + std::to_string(i) + "/" + topic_type);
+            }
           }
-        }
 
-        // Compose the LoadAlgorithm message
-        temoto_2::LoadAlgorithm load_algorithm_msg;
-        load_algorithm_msg.request.algorithm_type = pipe.at(i).filter_type_;
-        load_algorithm_msg.request.input_topics = required_topics.inputTopicsAsKeyValues();
-        load_algorithm_msg.request.output_topics = required_topics.outputTopicsAsKeyValues();
+          // Compose the LoadAlgorithm message
+          temoto_2::LoadAlgorithm load_algorithm_msg;
+          load_algorithm_msg.request.algorithm_type = pipe.at(i).filter_type_;
+          load_algorithm_msg.request.input_topics = required_topics.inputTopicsAsKeyValues();
+          load_algorithm_msg.request.output_topics = required_topics.outputTopicsAsKeyValues();
 
-        // Call the Algorithm Manager
-        resource_manager_2_.call<temoto_2::LoadAlgorithm>(algorithm_manager::srv_name::MANAGER,
-                                                          algorithm_manager::srv_name::SERVER,
-                                                          load_algorithm_msg);
+          // Call the Algorithm Manager without waiting for the response
+          algorithm_loads.push_back(resource_manager_2_.callAsync<temoto_2::LoadAlgorithm>(
+              algorithm_manager::srv_name::MANAGER, algorithm_manager::srv_name::SERVER,
+              load_algorithm_msg));
 
+          // The algorithm manager remaps the outputs to the requested topics
+          required_topics.setInputTopicsByKeyValue(load_algorithm_msg.request.output_topics);
+        }
+      }
+    }
+    catch (error::ErrorStack& error_stack)
+    {
+      load_errors += error_stack;
+    }
+
+    // Wait for the algorithms, also when the pipe has already failed, as they have to be unloaded
+    for (auto& algorithm_load : algorithm_loads)
+    {
+      try
+      {
         // TODO: REMOVE AFTER RMP HAS THIS FUNCTIONALITY
-        sub_resource_ids.push_back(load_algorithm_msg.response.rmp.resource_id);
+        sub_resource_ids.push_back(algorithm_load.get().response.rmp.resource_id);
+      }
+      catch (error::ErrorStack& error_stack)
+      {
+        load_errors += error_stack;
+      }
+    }
 
-        required_topics.setInputTopicsByKeyValue(load_algorithm_msg.response.output_topics);
+    if (!load_errors.empty())
+    {
+      // The pipe is not usable without all of its filters
+      for (int sub_resource_id : sub_resource_ids)
+      {
+        try
+        {
+          resource_manager_2_.unloadClientResource(sub_resource_id);
+        }
+        catch (error::ErrorStack& error_stack)
+        {
+          load_errors += error_stack;
+        }
       }
+      throw FORWARD_ERROR(load_errors);
     }
 
     // Send the output topics of the last filter back via response
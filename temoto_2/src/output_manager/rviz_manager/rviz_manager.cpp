@@ -65,6 +65,13 @@ void RvizManager::runRviz()
   msg.request.package_name = "rviz_plugin_manager";
   msg.request.executable = "rviz_plugin_manager.launch";
 
+  // Rviz is ready once all the rviz_plugin_manager services are available
+  msg.request.ready_services.push_back(load_plugin_client_.getService());
+  msg.request.ready_services.push_back(unload_plugin_client_.getService());
+  msg.request.ready_services.push_back(set_plugin_config_client_.getService());
+  msg.request.ready_services.push_back(get_plugin_config_client_.getService());
+  msg.request.ready_timeout = 10;
+
   TEMOTO_INFO("%s Requesting to launch rviz ...", prefix.c_str());
 
   try
@@ -76,23 +83,6 @@ void RvizManager::runRviz()
     {
       TEMOTO_INFO("%s Rviz launched succesfully: %s", prefix.c_str(),
                   msg.response.rmp.message.c_str());
-
-      // Wait until rviz_plugin_manager clients become active or throw an error on timeout
-      ros::Time timeout = ros::Time::now() + ros::Duration(10);
-      while ((!load_plugin_client_.exists() || !unload_plugin_client_.exists() ||
-              !set_plugin_config_client_.exists() || !get_plugin_config_client_.exists()) &&
-             ros::Time::now() < timeout)
-      {
-        ros::Duration diff = timeout - ros::Time::now();
-        TEMOTO_DEBUG("%s Waiting for rviz to start (timeout in %.1f sec).", prefix.c_str(),
-                     diff.toSec());
-        ros::Duration(1).sleep();
-      }
-
-      if (ros::Time::now() >= timeout)
-      {
-        throw CREATE_ERROR(error::Code::RVIZ_OPEN_FAIL, "Failed to launch rviz plugin manager: Timeout reached.");
-      }
       TEMOTO_DEBUG("%s All rviz_plugin_manager services connected.", prefix.c_str());
     }
     else
@@ -1,9 +1,6 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  *
  *          MASSIVE TODO: * CATCH ALL EXCEPTIONS !!!
- *                        * implement interprocess piping service
- *                          that starts streaming the std::out of
- *                          a requested process.
  *                        * organize your sh*t
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -11,223 +8,654 @@
 #include "process_manager/process_manager.h"
 
 #include "ros/package.h"
+#include "std_msgs/String.h"
 
 #include <stdio.h>
 #include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 #include <sys/wait.h>
+#include <unistd.h>
 #include <algorithm>
 #include <spawn.h>
 #include <regex>
 
 namespace process_manager
 {
-ProcessManager::ProcessManager() : resource_manager_(srv_name::MANAGER, this)
+namespace
 {
-  class_name_ = __func__;
-  subsystem_name_ = "process_manager";
-  subsystem_code_ = error::Subsystem::PROCESS_MANAGER;
-  log_group_ = "process_manager";
-  error_handler_ = error::ErrorHandler(subsystem_code_, log_group_);
+// How deep the source directory of a package is searched for an executable
+const unsigned int MAX_PACKAGE_SEARCH_DEPTH = 8;
+
+/**
+ * @brief Splits the argument string into separate arguments. Whitespace separates the
+ * arguments, single and double quotes group them and backslash escapes a character, as in shell.
+ */
+std::vector<std::string> splitArguments(const std::string& args)
+{
+  std::vector<std::string> arguments;
+  std::string argument;
+  bool in_argument = false;
+  char quote = 0;
+
+  for (size_t i = 0; i < args.size(); i++)
+  {
+    char c = args[i];
+    if (quote)
+    {
+      if (c == quote)
+      {
+        quote = 0;
+      }
+      else if (c == '\\' && quote == '"' && i + 1 < args.size())
+      {
+        argument += args[++i];
+      }
+      else
+      {
+        argument += c;
+      }
+    }
+    else if (c == '\'' || c == '"')
+    {
+      quote = c;
+      in_argument = true;
+    }
+    else if (c == '\\' && i + 1 < args.size())
+    {
+      argument += args[++i];
+      in_argument = true;
+    }
+    else if (isspace(c))
+    {
+      if (in_argument)
+      {
+        arguments.push_back(argument);
+        argument.clear();
+        in_argument = false;
+      }
+    }
+    else
+    {
+      argument += c;
+      in_argument = true;
+    }
+  }
+
+  if (in_argument)
+  {
+    arguments.push_back(argument);
+  }
+  return arguments;
+}
+
+bool isExecutableFile(const std::string& path)
+{
+  struct stat buffer;
+  return stat(path.c_str(), &buffer) == 0 && S_ISREG(buffer.st_mode) &&
+         access(path.c_str(), X_OK) == 0;
+}
+
+/**
+ * @brief Searches the executable from the list of directories separated by ':'
+ */
+std::string findInDirectories(const std::string& directories, const std::string& sub_path)
+{
+  std::stringstream ss(directories);
+  std::string directory;
+  while (std::getline(ss, directory, ':'))
+  {
+    if (directory != "" && isExecutableFile(directory + "/" + sub_path))
+    {
+      return directory + "/" + sub_path;
+    }
+  }
+  return "";
+}
+
+/**
+ * @brief Recursively searches the directory for an executable file with the given name.
+ */
+std::string findInDirectoryTree(const std::string& directory, const std::string& name,
+                                unsigned int search_depth)
+{
+  DIR* dir = opendir(directory.c_str());
+  if (!dir)
+  {
+    return "";
+  }
+
+  std::string result;
+  std::vector<std::string> sub_directories;
+  while (struct dirent* entry = readdir(dir))
+  {
+    std::string entry_name = entry->d_name;
+    if (entry_name == "." || entry_name == "..")
+    {
+      continue;
+    }
+
+    std::string entry_path = directory + "/" + entry_name;
+    if (entry_name == name && isExecutableFile(entry_path))
+    {
+      result = entry_path;
+      break;
+    }
+
+    struct stat buffer;
+    if (search_depth > 0 && stat(entry_path.c_str(), &buffer) == 0 && S_ISDIR(buffer.st_mode))
+    {
+      sub_directories.push_back(entry_path);
+    }
+  }
+  closedir(dir);
+
+  for (auto it = sub_directories.begin(); result == "" && it != sub_directories.end(); it++)
+  {
+    result = findInDirectoryTree(*it, name, search_depth - 1);
+  }
+  return result;
+}
+
+std::string findInPath(const std::string& name)
+{
+  const char* path = getenv("PATH");
+  return (path) ? findInDirectories(path, name) : "";
+}
+
+std::string findNodeExecutable(const std::string& package_name, const std::string& package_path,
+                               const std::string& executable)
+{
+  // Same lookup order as in rosrun: first the libexec directories of the catkin workspaces,
+  // then the directory of the package itself.
+  const char* prefix_path = getenv("CMAKE_PREFIX_PATH");
+  if (prefix_path)
+  {
+    std::string found = findInDirectories(prefix_path, "lib/" + package_name + "/" + executable);
+    if (found != "")
+    {
+      return found;
+    }
+  }
+  return findInDirectoryTree(package_path, executable, MAX_PACKAGE_SEARCH_DEPTH);
+}
+
+std::string executableKey(const temoto_2::LoadProcess::Request& req)
+{
+  return req.action + ":" + req.package_name + "/" + req.executable;
+}
+}  // namespace
+
+ProcessManager::ProcessManager()
+  : BaseSubsystem("process_manager", error::Subsystem::PROCESS_MANAGER, __func__)
+  , resource_manager_(srv_name::MANAGER, this)
+  , process_monitor_(this)
+{
+  // Exited children are detected through a signalfd. It receives SIGCHLD only if the signal is
+  // blocked in every thread, see blockChildSignals(). The eventfd is used for waking up the
+  // supervisor when the process manager is destroyed.
+  sigset_t child_signals;
+  sigemptyset(&child_signals);
+  sigaddset(&child_signals, SIGCHLD);
+  signal_fd_ = signalfd(-1, &child_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (signal_fd_ < 0 || wakeup_fd_ < 0)
+  {
+    TEMOTO_ERROR("Unable to create the child supervision descriptors: %s", strerror(errno));
+  }
+  supervising_ = true;
+  supervisor_thread_ = std::thread(&ProcessManager::supervise, this);
 
   resource_manager_.addServer<temoto_2::LoadProcess>(srv_name::SERVER, &ProcessManager::loadCb,
-                                                     &ProcessManager::unloadCb);
+                                                     &ProcessManager::unloadCb, LOAD_THREAD_COUNT);
+  get_output_server_ =
+      nh_.advertiseService(srv_name::SERVER_GET_OUTPUT, &ProcessManager::getOutputCb, this);
   TEMOTO_INFO("Process manager is ready.");
 }
 
 ProcessManager::~ProcessManager()
 {
+  supervising_ = false;
+  uint64_t wakeup = 1;
+  if (write(wakeup_fd_, &wakeup, sizeof(wakeup)) < 0)
+  {
+    TEMOTO_WARN("Unable to wake up the child supervisor: %s", strerror(errno));
+  }
+  if (supervisor_thread_.joinable())
+  {
+    supervisor_thread_.join();
+  }
+  close(signal_fd_);
+  close(wakeup_fd_);
+}
+
+void ProcessManager::blockChildSignals()
+{
+  sigset_t child_signals;
+  sigemptyset(&child_signals);
+  sigaddset(&child_signals, SIGCHLD);
+  pthread_sigmask(SIG_BLOCK, &child_signals, NULL);
 }
 
-// Timer callback where running proceses are checked if they are operational
-void ProcessManager::update(const ros::TimerEvent&)
+ProcessManager::Executable ProcessManager::resolveExecutable(const temoto_2::LoadProcess::Request& req)
 {
-  // execute each process in loading_processes vector
-  waitForLock(running_mutex_);
-  waitForLock(loading_mutex_);
-  for (auto& srv : loading_processes_)
+  // Look up the cache first, the executable is searched only once.
+  const std::string key = executableKey(req);
   {
-    const std::string& package_name = srv.request.package_name;
-    const std::string& executable = srv.request.executable;
-    const std::string& args = srv.request.args;
+    std::lock_guard<std::mutex> executables_lock(executables_mutex_);
+    auto executable_it = executables_.find(key);
+    if (executable_it != executables_.end())
+    {
+      return executable_it->second;
+    }
+  }
 
-    std::string cmd = "";
+  Executable executable;
+  if (req.action == action::ROS_EXECUTE)
+  {
+    std::string path = ros::package::getPath(req.package_name);
+    if(path=="")
+    {
+      throw CREATE_ERROR(error::Code::PACKAGE_NOT_FOUND, "ROS Package: '%s' was not found.", req.package_name.c_str());
+    }
+
+    // Check if .launch file exists.
+    std::regex rx(".*\\.launch$");
+    if (std::regex_match(req.executable, rx))
+    {
+      if (!executableExists(path + "/launch/" + req.executable))
+      {
+        throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND,
+                           "ROS Package: '%s' does not contain the requsted launch file '%s'.",
+                           req.package_name.c_str(), req.executable.c_str());
+      }
 
-    if (srv.request.action == action::ROS_EXECUTE)
+      executable.program = findInPath("roslaunch");
+      if (executable.program == "")
+      {
+        throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND, "'roslaunch' was not found in PATH.");
+      }
+      executable.leading_args.push_back(path + "/launch/" + req.executable);
+    }
+    else
     {
-      if (srv.request.ros_namespace != "")
+      executable.program = findNodeExecutable(req.package_name, path, req.executable);
+      if (executable.program == "")
       {
-        cmd += "ROS_NAMESPACE=" + common::getAbsolutePath(srv.request.ros_namespace) + " ";
+        throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND,
+                           "ROS Package: '%s' does not contain the executable '%s'.",
+                           req.package_name.c_str(), req.executable.c_str());
       }
-      std::regex rx(".*\\.launch$");
-      cmd += (std::regex_match(executable, rx)) ? "roslaunch " : "rosrun ";
-      cmd += package_name + " " + executable + " " + args;
     }
-    else if (srv.request.action == action::SYS_EXECUTE)
+  }
+  else if (req.action == action::SYS_EXECUTE)
+  {
+    executable.program = (req.executable.find('/') != std::string::npos)
+                             ? req.executable
+                             : findInPath(req.executable);
+    if (executable.program == "")
     {
-      cmd += executable + " " + args;
+      throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND, "'%s' was not found in PATH.",
+                         req.executable.c_str());
     }
+  }
 
-    // Fork the parent process
-    TEMOTO_DEBUG("Forking the process.");
-    pid_t pid = fork();
+  std::lock_guard<std::mutex> executables_lock(executables_mutex_);
+  executables_[key] = executable;
+  return executable;
+}
 
-    // Child process
-    if (pid == 0)
+pid_t ProcessManager::spawnProcess(const temoto_2::LoadProcess::Request& req,
+                                   const Executable& executable, int output_fd)
+{
+  // Build the argument list. The arguments are split the way a shell would split them, so
+  // remappings and quoted arguments are passed to the program as they were before.
+  std::vector<std::string> arguments;
+  arguments.push_back(executable.program);
+  arguments.insert(arguments.end(), executable.leading_args.begin(), executable.leading_args.end());
+  std::vector<std::string> split_args = splitArguments(req.args);
+  arguments.insert(arguments.end(), split_args.begin(), split_args.end());
+
+  // The program inherits the environment of the process manager, except for the ROS_NAMESPACE.
+  std::vector<std::string> environment;
+  bool set_namespace = (req.action == action::ROS_EXECUTE && req.ros_namespace != "");
+  for (char** env = environ; *env != NULL; env++)
+  {
+    if (set_namespace && strncmp(*env, "ROS_NAMESPACE=", 14) == 0)
     {
-      // Execute the requested process
-      //  std::cout << "Child is executing a program ..." << std::endl;
-      execlp("/bin/bash", "/bin/bash", "-c", cmd.c_str() , (char*)NULL);
-      return;
+      continue;
     }
+    environment.push_back(*env);
+  }
+  if (set_namespace)
+  {
+    environment.push_back("ROS_NAMESPACE=" + common::getAbsolutePath(req.ros_namespace));
+  }
+
+  std::vector<char*> argv;
+  for (auto& argument : arguments)
+  {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(NULL);
 
-    // Only parent gets here
-    TEMOTO_DEBUG("Child %d forked.", pid);
-    running_processes_.insert({ pid, srv });
+  std::vector<char*> envp;
+  for (auto& variable : environment)
+  {
+    envp.push_back(const_cast<char*>(variable.c_str()));
   }
-  loading_processes_.clear();
-  loading_mutex_.unlock();
+  envp.push_back(NULL);
+
+  // The blocked SIGCHLD would be inherited by the executed program, unblock it.
+  sigset_t no_signals;
+  sigemptyset(&no_signals);
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  posix_spawnattr_setsigmask(&attr, &no_signals);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
 
-  // unload each process in unload_processes vector
-  waitForLock(unloading_mutex_);
-  for (auto pid : unloading_processes_)
+  // Redirect both stdout and stderr to the output pipe, if one is given
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  if (output_fd >= 0)
   {
-    // consistency check, ensure that pid is still in running_processes
-    auto proc_it = running_processes_.find(pid);
-    if (proc_it != running_processes_.end())
+    posix_spawn_file_actions_adddup2(&file_actions, output_fd, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&file_actions, output_fd, STDERR_FILENO);
+  }
+
+  TEMOTO_DEBUG("Spawning '%s'.", executable.program.c_str());
+  pid_t pid;
+  int ret = posix_spawn(&pid, executable.program.c_str(), &file_actions, &attr, argv.data(),
+                        envp.data());
+  posix_spawn_file_actions_destroy(&file_actions);
+  posix_spawnattr_destroy(&attr);
+
+  if (ret != 0)
+  {
+    // The cached executable may have been removed or rebuilt elsewhere. Search for it again
+    // on the next request.
+    if (ret == ENOENT)
     {
-      // Kill the process
-      TEMOTO_DEBUG("Sending kill(SIGTERM) to %d", pid);
+      std::lock_guard<std::mutex> executables_lock(executables_mutex_);
+      executables_.erase(executableKey(req));
+    }
+    throw CREATE_ERROR(error::Code::PROCESS_SPAWN_FAIL, "Unable to spawn '%s': %s",
+                       executable.program.c_str(), strerror(ret));
+  }
 
-      int ret = kill(pid, SIGTERM);
-      TEMOTO_DEBUG("kill(SIGTERM) returned: %d", ret);
-      // TODO: Check the returned value
+  TEMOTO_DEBUG("Child %d spawned.", pid);
+  return pid;
+}
 
-      // Remove the process from the map
-      running_processes_.erase(proc_it);
+void ProcessManager::supervise()
+{
+  struct pollfd fds[2];
+  fds[0].fd = signal_fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd = wakeup_fd_;
+  fds[1].events = POLLIN;
+
+  while (supervising_)
+  {
+    // The timeout is only a fallback for the case when SIGCHLD is not blocked and thus never
+    // reaches the signalfd. Normally the supervisor is woken up as soon as a child exits.
+    int ret = poll(fds, 2, SUPERVISOR_FALLBACK_PERIOD_MS);
+    if (ret < 0 && errno != EINTR)
+    {
+      TEMOTO_ERROR("Polling the child supervision descriptors failed: %s", strerror(errno));
+    }
+
+    // Drain the pending signals. Multiple SIGCHLDs may be merged into one, hence all children
+    // are checked below.
+    if (ret > 0 && (fds[0].revents & POLLIN))
+    {
+      struct signalfd_siginfo info;
+      while (read(signal_fd_, &info, sizeof(info)) == sizeof(info))
+      {
+      }
     }
-    // Process failed and does not exist any more.
-    // Remove it from the failed processes map
-    else if(!failed_processes_.erase(pid))
+
+    if (supervising_)
     {
-      TEMOTO_DEBUG("Unable to unload reource with pid: %d. Resource is not running nor marked as failed.", pid);
+      reapChildren();
     }
   }
-  unloading_processes_.clear();
+}
 
-  // Check the status of all running processes
-  // cache all to statuses before actual sending, so we can release the running_mutex.
-  std::vector<temoto_2::ResourceStatus> statuses_to_send; 
-  auto proc_it = running_processes_.begin();
-  while (proc_it != running_processes_.end())
+void ProcessManager::reapChildren()
+{
+  // cache all to statuses before actual sending, so we can release the processes_mutex_.
+  std::vector<temoto_2::ResourceStatus> statuses_to_send;
+  std::vector<pid_t> exited_pids;
   {
-    int status;
-    int kill_response = waitpid(proc_it->first, &status, WNOHANG);
-    // If the child process has stopped running,
-    if (kill_response != 0)
+    std::lock_guard<std::mutex> processes_lock(processes_mutex_);
+
+    // Reap the processes which were unloaded, so that they do not remain as zombies.
+    auto stopping_it = stopping_processes_.begin();
+    while (stopping_it != stopping_processes_.end())
     {
-      TEMOTO_ERROR("Process %d ('%s' '%s' '%s') has stopped.", proc_it->first,
-                   proc_it->second.request.action.c_str(),
-                   proc_it->second.request.package_name.c_str(),
-                   proc_it->second.request.executable.c_str());
-
-      // TODO: send error information to all related connections
-      temoto_2::ResourceStatus srv;
-      srv.request.resource_id = proc_it->second.response.rmp.resource_id;
-      srv.request.status_code = rmp::status_codes::FAILED;
-      std::stringstream ss;
-      ss << "The process with pid '" << proc_it->first << "' has stopped.";
-      srv.request.message = ss.str();
-      srv.request.error_stack = CREATE_ERROR(error::Code::PROCESS_STOPPED, ss.str());
-
-      // store statuses to send
-      statuses_to_send.push_back(srv);
-      
-      // Remove the process from the map
-      // Currently the status is propagated to who ever is using the resource,
-      // each of which is responsible to unload the failed resource on its own.
-      failed_processes_.insert(*proc_it);
-      proc_it = running_processes_.erase(proc_it);
+      int status;
+      if (waitpid(*stopping_it, &status, WNOHANG) != 0)
+      {
+        TEMOTO_DEBUG("Unloaded process %d has exited.", *stopping_it);
+        stopping_it = stopping_processes_.erase(stopping_it);
+      }
+      else
+      {
+        stopping_it++;
+      }
     }
-    else
+
+    // Check the status of all running processes
+    auto proc_it = running_processes_.begin();
+    while (proc_it != running_processes_.end())
     {
-      proc_it++;
+      int status;
+      int kill_response = waitpid(proc_it->first, &status, WNOHANG);
+      // If the child process has stopped running,
+      if (kill_response != 0)
+      {
+        TEMOTO_ERROR("Process %d ('%s' '%s' '%s') has stopped.", proc_it->first,
+                     proc_it->second.request.action.c_str(),
+                     proc_it->second.request.package_name.c_str(),
+                     proc_it->second.request.executable.c_str());
+
+        // TODO: send error information to all related connections
+        temoto_2::ResourceStatus srv;
+        srv.request.resource_id = proc_it->second.response.rmp.resource_id;
+        srv.request.status_code = rmp::status_codes::FAILED;
+        std::stringstream ss;
+        ss << "The process with pid '" << proc_it->first << "' has stopped.";
+        srv.request.message = ss.str();
+        srv.request.error_stack = CREATE_ERROR(error::Code::PROCESS_STOPPED, ss.str());
+
+        // store statuses to send
+        statuses_to_send.push_back(srv);
+        exited_pids.push_back(proc_it->first);
+
+        // Remove the process from the map
+        // Currently the status is propagated to who ever is using the resource,
+        // each of which is responsible to unload the failed resource on its own.
+        failed_processes_.insert(*proc_it);
+        proc_it = running_processes_.erase(proc_it);
+      }
+      else
+      {
+        proc_it++;
+      }
     }
   }
-  running_mutex_.unlock();
-  unloading_mutex_.unlock();
+
+  // Fail the loads which are still waiting for these processes to become ready
+  for (pid_t pid : exited_pids)
+  {
+    process_monitor_.processExited(pid);
+  }
 
   for (auto& srv : statuses_to_send)
   {
-    resource_manager_.sendStatus(srv);
+    try
+    {
+      resource_manager_.sendStatus(srv);
+    }
+    catch (error::ErrorStack& error_stack)
+    {
+      SEND_ERROR(FORWARD_ERROR(error_stack));
+    }
 
     // TODO: Normally unload command should come from upper chain, howerver, when sending status is unsucessful, we should unload the resource manually?
    // running_processes_.erase(proc_it++);
   }
 }
 
+ReadinessConditions ProcessManager::getReadinessConditions(const temoto_2::LoadProcess::Request& req)
+{
+  // Relative names are resolved in the namespace the process is executed in
+  std::string ns = (req.ros_namespace != "") ? common::getAbsolutePath(req.ros_namespace)
+                                             : common::getAbsolutePath(common::getTemotoNamespace());
+  auto resolve = [&](const std::vector<std::string>& names) {
+    std::vector<std::string> resolved_names;
+    for (auto& name : names)
+    {
+      resolved_names.push_back((name.size() && name[0] == '/') ? name : ros::names::append(ns, name));
+    }
+    return resolved_names;
+  };
+
+  ReadinessConditions conditions;
+  conditions.topics = resolve(req.ready_topics);
+  conditions.services = resolve(req.ready_services);
+  conditions.params = resolve(req.ready_params);
+  conditions.log_regex = req.ready_log_regex;
+
+  double timeout = (req.ready_timeout > 0) ? req.ready_timeout : DEFAULT_READY_TIMEOUT;
+  conditions.deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(static_cast<long>(timeout * 1000));
+  return conditions;
+}
+
+void ProcessManager::stopProcess(pid_t pid)
+{
+  std::lock_guard<std::mutex> processes_lock(processes_mutex_);
+  process_monitor_.forgetOutput(pid);
+  failed_processes_.erase(pid);
+  if (running_processes_.erase(pid))
+  {
+    TEMOTO_DEBUG("Sending kill(SIGTERM) to %d", pid);
+    kill(pid, SIGTERM);
+    stopping_processes_.insert(pid);
+  }
+}
+
+std::string ProcessManager::getOutputTopic(temoto_id::ID resource_id) const
+{
+  return srv_name::MANAGER + "/output/" + std::to_string(resource_id);
+}
+
+bool ProcessManager::getOutputCb(temoto_2::GetProcessOutput::Request& req,
+                                 temoto_2::GetProcessOutput::Response& res)
+{
+  // Look up the process by its resource id. Failed processes are included, their output is
+  // usually the most interesting.
+  pid_t pid = 0;
+  {
+    std::lock_guard<std::mutex> processes_lock(processes_mutex_);
+    for (auto* processes : { &running_processes_, &failed_processes_ })
+    {
+      for (auto& process : *processes)
+      {
+        if (process.second.response.rmp.resource_id == req.resource_id)
+        {
+          pid = process.first;
+        }
+      }
+    }
+  }
+
+  if (pid && process_monitor_.getOutput(pid, req.max_bytes, res.output, res.topic))
+  {
+    res.code = rmp::status_codes::OK;
+    res.message = "Output found.";
+  }
+  else
+  {
+    res.code = rmp::status_codes::FAILED;
+    res.message = "No output was found for the resource with id '" +
+                  std::to_string(req.resource_id) + "'.";
+    res.error_stack = CREATE_ERROR(error::Code::RESOURCE_NOT_FOUND, res.message);
+  }
+  return true;
+}
+
 void ProcessManager::loadCb(temoto_2::LoadProcess::Request& req,
                             temoto_2::LoadProcess::Response& res)
 {
   // Validate the action command.
   if (req.action == action::ROS_EXECUTE) //|| action == action::SYS_EXECUTE)
   {
-    std::string path = ros::package::getPath(req.package_name);
-    if(path=="")
+    // Throws if the ros package or the executable does not exist.
+    Executable executable = resolveExecutable(req);
+
+    // Yey, the executable and ros package exists. Start it right away.
+
+    TEMOTO_DEBUG("Starting '%s' '%s' '%s' '%s'.", req.action.c_str(),
+                 req.package_name.c_str(), req.executable.c_str(), req.args.c_str());
+
+    temoto_2::LoadProcess srv;
+    srv.request = req;
+    srv.response = res;
+
+    ReadinessConditions conditions = getReadinessConditions(req);
+
+    // The output of the process is captured by the process monitor. The read end of the pipe
+    // is made non-blocking there, the child writes to the blocking end as it would to a terminal.
+    int output_fds[2] = { -1, -1 };
+    if (pipe2(output_fds, O_CLOEXEC) != 0)
     {
-      throw CREATE_ERROR(error::Code::PACKAGE_NOT_FOUND, "ROS Package: '%s' was not found.", req.package_name.c_str());
+      throw CREATE_ERROR(error::Code::PROCESS_SPAWN_FAIL, "Unable to create the output pipe: %s",
+                         strerror(errno));
     }
 
-    // Check if .launch file exists.
-    std::regex rx(".*\\.launch$");
-    if (std::regex_match(req.executable, rx))
+    // The process is registered under the same lock it is spawned in. Hence the supervisor cannot
+    // miss the child, even if it exits before this callback returns.
+    pid_t pid;
+    ReadinessCheckPtr readiness_check;
+    try
     {
-      if (!executableExists(path + "/launch/" + req.executable))
+      std::lock_guard<std::mutex> processes_lock(processes_mutex_);
+      pid = spawnProcess(req, executable, output_fds[1]);
+      running_processes_.insert({ pid, srv });
+      if (!conditions.empty())
       {
-        throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND,
-                           "ROS Package: '%s' does not contain the requsted launch file '%s'.",
-                           req.package_name.c_str(), req.executable.c_str());
+        readiness_check = process_monitor_.addReadinessCheck(pid, conditions);
       }
     }
-    // TODO: In whats below, catkin_find is unable to find .py files. That's why its commented out.
-//    else
-//    {
-//      // Check if the requested binary exists
-//      std::string catkin_find_cmd = "catkin_find " + req.package_name + " " + req.executable;
-//      std::shared_ptr<FILE> pipe(popen(catkin_find_cmd.c_str(), "r"), pclose);
-//      if(pipe)
-//      {
-//        std::array<char, 128> buffer;
-//        std::string result;
-//        while(!feof(pipe.get()))
-//        {
-//          if (fgets(buffer.data(), 128, pipe.get()) != nullptr)
-//          {
-//            result += buffer.data();
-//          }
-//        }
-//
-//        //catkin find does not write anything to stdout if the binary does not exist.
-//        if (!result.size())
-//        {
-//          throw CREATE_ERROR(error::Code::EXECUTABLE_NOT_FOUND,
-//                             "ROS Package: '%s' does not contain the executable '%s'.",
-//                             req.package_name.c_str(), req.executable.c_str());
-//        }
-//      }
-//    }
-
-    // Yey, the executable and ros package exists. Add it to the loading queue.
-
-    TEMOTO_DEBUG("Adding '%s' '%s' '%s' '%s' to the loading queue.", req.action.c_str(),
-                 req.package_name.c_str(), req.executable.c_str(), req.args.c_str());
+    catch (error::ErrorStack& error_stack)
+    {
+      close(output_fds[0]);
+      close(output_fds[1]);
+      throw FORWARD_ERROR(error_stack);
+    }
 
-    temoto_2::LoadProcess srv;
-    srv.request = req;
-    srv.response = res;
+    // Only the child writes to the pipe
+    close(output_fds[1]);
+    ros::Publisher output_publisher =
+        nh_.advertise<std_msgs::String>(getOutputTopic(res.rmp.resource_id), 100);
+    process_monitor_.watchOutput(pid, output_fds[0], output_publisher);
 
-    loading_mutex_.lock();
-    loading_processes_.push_back(srv);
-    loading_mutex_.unlock();
+    // Respond only after the process is ready. If it is not, it is stopped and the load fails,
+    // since the resource server forgets the query and thus never unloads it.
+    if (readiness_check && !process_monitor_.waitUntilReady(readiness_check))
+    {
+      stopProcess(pid);
+      throw CREATE_ERROR(error::Code::PROCESS_NOT_READY, "Process '%s' '%s' did not become ready: %s",
+                         req.package_name.c_str(), req.executable.c_str(),
+                         readiness_check->message.c_str());
+    }
   }
   else
   {
@@ -237,7 +665,7 @@ void ProcessManager::loadCb(temoto_2::LoadProcess::Request& req,
 
   // Fill response
   res.rmp.code = rmp::status_codes::OK;
-  res.rmp.message = "Request added to the loading queue.";
+  res.rmp.message = "Process started.";
 }
 
 void ProcessManager::unloadCb(temoto_2::LoadProcess::Request& req,
@@ -246,7 +674,7 @@ void ProcessManager::unloadCb(temoto_2::LoadProcess::Request& req,
   TEMOTO_DEBUG("Unloading resource with id '%ld' ...", res.rmp.resource_id);
 
   // Lookup the requested process by its resource id.
-  waitForLock(running_mutex_);
+  std::lock_guard<std::mutex> processes_lock(processes_mutex_);
   auto proc_it =
       std::find_if(running_processes_.begin(), running_processes_.end(),
                    [&](const std::pair< pid_t, temoto_2::LoadProcess>& p) -> bool { return p.second.request == req; });
@@ -255,13 +683,24 @@ void ProcessManager::unloadCb(temoto_2::LoadProcess::Request& req,
                    [&](const std::pair< pid_t, temoto_2::LoadProcess>& p) -> bool { return p.second.request == req; });
   if (proc_it != running_processes_.end())
   {
-    unloading_processes_.push_back(proc_it->first);
+    // Kill the process. It is reaped by the supervisor once it has exited.
+    pid_t pid = proc_it->first;
+    TEMOTO_DEBUG("Sending kill(SIGTERM) to %d", pid);
+
+    int ret = kill(pid, SIGTERM);
+    TEMOTO_DEBUG("kill(SIGTERM) returned: %d", ret);
+    // TODO: Check the returned value
+
+    running_processes_.erase(proc_it);
+    stopping_processes_.insert(pid);
+    process_monitor_.forgetOutput(pid);
     res.rmp.code = 0;
-    res.rmp.message = "Resource added to unload queue.";
-    TEMOTO_DEBUG("Resource with id '%ld' added to unload queue.", res.rmp.resource_id);
+    res.rmp.message = "Resource unloaded.";
+    TEMOTO_DEBUG("Unloaded resource with id '%ld'.", res.rmp.resource_id);
   }
   else if (failed_proc_it != failed_processes_.end())
   {
+    process_monitor_.forgetOutput(failed_proc_it->first);
     failed_processes_.erase(failed_proc_it);
     res.rmp.code = 0;
     res.rmp.message = "Resource unloaded.";
@@ -274,17 +713,5 @@ void ProcessManager::unloadCb(temoto_2::LoadProcess::Request& req,
     res.rmp.code = rmp::status_codes::FAILED;
     res.rmp.message = "Resource is not running nor failed. Unable to unload.";
   }
-  running_mutex_.unlock();
-
-  unloading_mutex_.unlock();
 }
-
-  void ProcessManager::waitForLock(std::mutex& m)
-  {
-    while (!m.try_lock())
-    {
-      TEMOTO_DEBUG("Waiting for lock()");
-      ros::Duration(0.1).sleep();  // sleep for few ms
-    }
-  }
 }  // namespace process_manager
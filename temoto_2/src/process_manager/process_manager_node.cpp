@@ -5,15 +5,14 @@
 
 int main(int argc, char** argv)
 {
+  // Has to be done before ROS starts its threads, see ProcessManager::blockChildSignals
+  process_manager::ProcessManager::blockChildSignals();
+
   ros::init(argc, argv, "process_manager");
 
   // Create instance of process manager
   process_manager::ProcessManager pm;
 
-  // set up ROS timer to update the process_manager
-  ros::NodeHandle nh;
-  ros::Timer timer =
-      nh.createTimer(ros::Duration(1), &process_manager::ProcessManager::update, &pm);
   ros::spin();
   return 0;
 }
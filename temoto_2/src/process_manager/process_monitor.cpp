@@ -0,0 +1,412 @@
+#include "process_manager/process_monitor.h"
+
+#include "ros/ros.h"
+#include "std_msgs/String.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace process_manager
+{
+ProcessMonitor::ProcessMonitor(BaseSubsystem* b) : BaseSubsystem(*b, __func__)
+{
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup_fd_ < 0)
+  {
+    TEMOTO_ERROR("Unable to create the wakeup descriptor: %s", strerror(errno));
+  }
+  running_ = true;
+  monitor_thread_ = std::thread(&ProcessMonitor::run, this);
+}
+
+ProcessMonitor::~ProcessMonitor()
+{
+  running_ = false;
+  wakeUp();
+  if (monitor_thread_.joinable())
+  {
+    monitor_thread_.join();
+  }
+
+  // Release the callers which are still waiting
+  std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+  std::vector<ReadinessCheckPtr> checks = checks_;
+  for (auto& check : checks)
+  {
+    complete(check, false, "The process monitor was stopped.");
+  }
+
+  for (auto& stream : output_streams_)
+  {
+    close(stream.first);
+  }
+  outputs_.clear();
+  close(wakeup_fd_);
+}
+
+void ProcessMonitor::watchOutput(pid_t pid, int fd, ros::Publisher publisher)
+{
+  // The output is read until there is nothing left, so that the process never blocks on it.
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  {
+    std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+    OutputStream stream;
+    stream.pid = pid;
+    output_streams_[fd] = stream;
+    outputs_.erase(pid);
+    outputs_.emplace(pid, ProcessOutput(publisher));
+  }
+  wakeUp();
+}
+
+bool ProcessMonitor::getOutput(pid_t pid, size_t max_bytes, std::string& output, std::string& topic)
+{
+  std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+  auto output_it = outputs_.find(pid);
+  if (output_it == outputs_.end())
+  {
+    return false;
+  }
+  output = output_it->second.buffer.tail(max_bytes);
+  topic = output_it->second.publisher.getTopic();
+  return true;
+}
+
+void ProcessMonitor::forgetOutput(pid_t pid)
+{
+  std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+  outputs_.erase(pid);
+}
+
+ReadinessCheckPtr ProcessMonitor::addReadinessCheck(pid_t pid, const ReadinessConditions& conditions)
+{
+  ReadinessCheckPtr check = std::make_shared<ReadinessCheck>();
+  check->pid = pid;
+  check->conditions = conditions;
+
+  std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+  try
+  {
+    check->log_regex = std::regex(conditions.log_regex);
+  }
+  catch (std::regex_error& e)
+  {
+    check->done = true;
+    check->message = "Invalid log regex '" + conditions.log_regex + "': " + e.what();
+    return check;
+  }
+
+  checks_.push_back(check);
+  wakeUp();
+  return check;
+}
+
+bool ProcessMonitor::waitUntilReady(const ReadinessCheckPtr& check)
+{
+  std::unique_lock<std::mutex> monitor_lock(monitor_mutex_);
+  check_done_cv_.wait(monitor_lock, [&] { return check->done; });
+  return check->ready;
+}
+
+void ProcessMonitor::processExited(pid_t pid)
+{
+  std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+  std::vector<ReadinessCheckPtr> checks = checks_;
+  for (auto& check : checks)
+  {
+    if (check->pid == pid)
+    {
+      complete(check, false, "The process has exited before it became ready.");
+    }
+  }
+}
+
+void ProcessMonitor::run()
+{
+  std::chrono::steady_clock::time_point next_check = std::chrono::steady_clock::now();
+  while (running_)
+  {
+    // Wait for output, a new check or the next check period. Without pending checks only the
+    // descriptors wake the monitor up.
+    std::vector<struct pollfd> fds;
+    bool checks_pending;
+    {
+      std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+      fds.push_back({ wakeup_fd_, POLLIN, 0 });
+      for (auto& stream : output_streams_)
+      {
+        fds.push_back({ stream.first, POLLIN, 0 });
+      }
+      checks_pending = !checks_.empty();
+    }
+
+    int timeout = -1;
+    if (checks_pending)
+    {
+      auto until_check = std::chrono::duration_cast<std::chrono::milliseconds>(
+          next_check - std::chrono::steady_clock::now());
+      timeout = std::max<int>(0, until_check.count());
+    }
+
+    int ret = poll(fds.data(), fds.size(), timeout);
+    if (ret < 0 && errno != EINTR)
+    {
+      TEMOTO_ERROR("Polling the process monitor descriptors failed: %s", strerror(errno));
+    }
+
+    if (ret > 0)
+    {
+      if (fds[0].revents & POLLIN)
+      {
+        uint64_t wakeups;
+        if (read(wakeup_fd_, &wakeups, sizeof(wakeups)) < 0)
+        {
+          // Nothing to do, the counter was reset by an earlier read
+        }
+      }
+
+      std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+      for (size_t i = 1; i < fds.size(); i++)
+      {
+        if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+          continue;
+        }
+
+        auto stream_it = output_streams_.find(fds[i].fd);
+        if (stream_it != output_streams_.end() && !readOutput(fds[i].fd, stream_it->second))
+        {
+          close(fds[i].fd);
+          output_streams_.erase(stream_it);
+        }
+      }
+    }
+
+    if (checks_pending && std::chrono::steady_clock::now() >= next_check)
+    {
+      checkReadiness();
+      next_check = std::chrono::steady_clock::now() + CHECK_PERIOD;
+    }
+    else if (!checks_pending)
+    {
+      // A check added later is evaluated right away
+      next_check = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+void ProcessMonitor::wakeUp()
+{
+  uint64_t wakeup = 1;
+  if (write(wakeup_fd_, &wakeup, sizeof(wakeup)) < 0)
+  {
+    TEMOTO_WARN("Unable to wake up the process monitor: %s", strerror(errno));
+  }
+}
+
+bool ProcessMonitor::readOutput(int fd, OutputStream& stream)
+{
+  char buffer[4096];
+  while (true)
+  {
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count == 0)
+    {
+      return false;
+    }
+    if (count < 0)
+    {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+
+    // Forward the output, it would have gone to the same terminal without the pipe.
+    if (write(STDOUT_FILENO, buffer, count) < 0)
+    {
+      // The output of the process manager is not available, the capturing still works.
+    }
+
+    // Keep the latest output and publish it only if someone is listening
+    auto output_it = outputs_.find(stream.pid);
+    if (output_it != outputs_.end())
+    {
+      output_it->second.buffer.append(buffer, count);
+      if (output_it->second.publisher.getNumSubscribers() > 0)
+      {
+        std_msgs::String msg;
+        msg.data.assign(buffer, count);
+        output_it->second.publisher.publish(msg);
+      }
+    }
+
+    // Match the complete lines, only while a check is waiting for a log line of the process.
+    bool log_pending = std::any_of(checks_.begin(), checks_.end(), [&](const ReadinessCheckPtr& c) {
+      return c->pid == stream.pid && !c->log_matched && !c->conditions.log_regex.empty();
+    });
+    if (!log_pending)
+    {
+      stream.partial_line.clear();
+      continue;
+    }
+
+    stream.partial_line.append(buffer, count);
+    size_t line_start = 0;
+    size_t line_end;
+    while ((line_end = stream.partial_line.find('\n', line_start)) != std::string::npos)
+    {
+      matchLogLine(stream.pid, stream.partial_line.substr(line_start, line_end - line_start));
+      line_start = line_end + 1;
+    }
+    stream.partial_line.erase(0, line_start);
+  }
+}
+
+void ProcessMonitor::matchLogLine(pid_t pid, const std::string& line)
+{
+  std::vector<ReadinessCheckPtr> checks = checks_;
+  for (auto& check : checks)
+  {
+    if (check->pid != pid || check->log_matched || check->conditions.log_regex.empty())
+    {
+      continue;
+    }
+
+    if (std::regex_search(line, check->log_regex))
+    {
+      check->log_matched = true;
+
+      // Nothing to ask from the master, the process is ready right away.
+      if (check->conditions.topics.empty() && check->conditions.services.empty() &&
+          check->conditions.params.empty())
+      {
+        complete(check, true, "The process is ready.");
+      }
+    }
+  }
+}
+
+void ProcessMonitor::checkReadiness()
+{
+  std::vector<ReadinessCheckPtr> checks;
+  {
+    std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+    checks = checks_;
+  }
+
+  // Query the master once for all the checks
+  bool need_topics = false;
+  bool need_services = false;
+  for (auto& check : checks)
+  {
+    need_topics |= !check->conditions.topics.empty();
+    need_services |= !check->conditions.services.empty();
+  }
+
+  std::set<std::string> topics;
+  if (need_topics)
+  {
+    ros::master::V_TopicInfo master_topics;
+    ros::master::getTopics(master_topics);
+    for (auto& master_topic : master_topics)
+    {
+      topics.insert(master_topic.name);
+    }
+  }
+
+  std::set<std::string> services;
+  if (need_services)
+  {
+    services = getServices();
+  }
+
+  for (auto& check : checks)
+  {
+    std::string missing;
+    for (auto& topic : check->conditions.topics)
+    {
+      if (!topics.count(topic))
+      {
+        missing = "topic '" + topic + "'";
+        break;
+      }
+    }
+
+    for (auto& service : check->conditions.services)
+    {
+      if (missing.empty() && !services.count(service))
+      {
+        missing = "service '" + service + "'";
+        break;
+      }
+    }
+
+    for (auto& param : check->conditions.params)
+    {
+      if (missing.empty() && !ros::param::has(param))
+      {
+        missing = "parameter '" + param + "'";
+        break;
+      }
+    }
+
+    std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+    if (check->done)
+    {
+      continue;
+    }
+
+    if (missing.empty() && !check->conditions.log_regex.empty() && !check->log_matched)
+    {
+      missing = "log line matching '" + check->conditions.log_regex + "'";
+    }
+
+    if (missing.empty())
+    {
+      complete(check, true, "The process is ready.");
+    }
+    else if (std::chrono::steady_clock::now() >= check->conditions.deadline)
+    {
+      complete(check, false, "Timeout reached while waiting for the " + missing + ".");
+    }
+    else
+    {
+      TEMOTO_DEBUG("Process %d is waiting for the %s.", check->pid, missing.c_str());
+    }
+  }
+}
+
+void ProcessMonitor::complete(const ReadinessCheckPtr& check, bool ready, const std::string& message)
+{
+  check->done = true;
+  check->ready = ready;
+  check->message = message;
+  checks_.erase(std::remove(checks_.begin(), checks_.end(), check), checks_.end());
+  check_done_cv_.notify_all();
+}
+
+std::set<std::string> ProcessMonitor::getServices()
+{
+  std::set<std::string> services;
+  XmlRpc::XmlRpcValue args, result, payload;
+  args[0] = ros::this_node::getName();
+  if (!ros::master::execute("getSystemState", args, result, payload, false))
+  {
+    TEMOTO_WARN("Unable to get the system state from the master.");
+    return services;
+  }
+
+  // The payload consists of publishers, subscribers and services, each entry of which is a
+  // [name, [providers]] pair.
+  XmlRpc::XmlRpcValue& service_list = payload[2];
+  for (int i = 0; i < service_list.size(); i++)
+  {
+    services.insert(static_cast<std::string>(service_list[i][0]));
+  }
+  return services;
+}
+
+}  // namespace process_manager
@@ -20,42 +20,58 @@ Robot::~Robot()
 {
   if(isLocal())
   {
-    // Unload features
+    // Unload features with a single request
+    std::vector<temoto_id::ID> resource_ids;
     if (config_->getFeatureURDF().isLoaded())
     {
       TEMOTO_WARN("Unloading URDF Feature.");
-      resource_manager_.unloadClientResource(config_->getFeatureURDF().getResourceId());
+      resource_ids.push_back(config_->getFeatureURDF().getResourceId());
       config_->getFeatureURDF().setLoaded(false);
     }
 
     if (config_->getFeatureManipulation().isLoaded())
     {
       TEMOTO_WARN("Unloading Manipulation Feature.");
-      resource_manager_.unloadClientResource(config_->getFeatureManipulation().getResourceId());
+      resource_ids.push_back(config_->getFeatureManipulation().getResourceId());
       config_->getFeatureManipulation().setLoaded(false);
     }
 
     if (config_->getFeatureManipulation().isDriverLoaded())
     {
       TEMOTO_WARN("Unloading Manipulation driver Feature.");
-      resource_manager_.unloadClientResource(config_->getFeatureManipulation().getDriverResourceId());
+      resource_ids.push_back(config_->getFeatureManipulation().getDriverResourceId());
       config_->getFeatureManipulation().setDriverLoaded(false);
     }
 
     if (config_->getFeatureNavigation().isLoaded())
     {
       TEMOTO_WARN("Unloading Manipulation Feature.");
-      resource_manager_.unloadClientResource(config_->getFeatureNavigation().getResourceId());
+      resource_ids.push_back(config_->getFeatureNavigation().getResourceId());
       config_->getFeatureNavigation().setLoaded(false);
     }
 
     if (config_->getFeatureNavigation().isDriverLoaded())
     {
       TEMOTO_WARN("Unloading Manipulation driver Feature.");
-      resource_manager_.unloadClientResource(config_->getFeatureNavigation().getDriverResourceId());
+      resource_ids.push_back(config_->getFeatureNavigation().getDriverResourceId());
       config_->getFeatureNavigation().setDriverLoaded(false);
     }
-    
+
+    // A destructor must not throw, log the errors of the unload instead
+    try
+    {
+      resource_manager_.unloadClientResources(resource_ids);
+    }
+    catch (error::ErrorStack& error_stack)
+    {
+      TEMOTO_ERROR("Failed to unload the features of the robot.");
+      FORWARD_ERROR(error_stack);
+    }
+    catch (std::exception& e)
+    {
+      TEMOTO_ERROR("Failed to unload the features of the robot: %s", e.what());
+    }
+
     // Remove parameters
     if(nh_.deleteParam(config_->getAbsRobotNamespace()))
     {
@@ -82,66 +98,32 @@ void Robot::load()
   }
 
   // Load robot features
-  
-  if (config_->getFeatureURDF().isEnabled() and config_->getFeatureManipulation().isDriverEnabled())
-  {
-    loadUrdf();
-    loadManipulationDriver();  // We need joint states and robot states to visualize the robot
-  }
+  bool load_urdf = config_->getFeatureURDF().isEnabled() and
+                   config_->getFeatureManipulation().isDriverEnabled();
+  bool load_manipulation = config_->getFeatureManipulation().isEnabled() and
+                           config_->getFeatureManipulation().isDriverEnabled();
+  bool load_navigation = config_->getFeatureNavigation().isEnabled() and
+                         config_->getFeatureNavigation().isDriverEnabled();
 
-  if (config_->getFeatureManipulation().isEnabled() and config_->getFeatureManipulation().isDriverEnabled())
+  // The drivers need the robot description
+  if (load_urdf)
   {
-    loadManipulationDriver();
-    loadManipulation();
-  }
-  
-  if (config_->getFeatureNavigation().isEnabled() and config_->getFeatureNavigation().isDriverEnabled())
-  {
-    loadNavigationDriver();
-    loadNavigation();
+    loadUrdf();
   }
-}
 
-void Robot::waitForParam(const std::string& param, temoto_id::ID interrupt_res_id)
-{
-//\TODO: add 30 sec timeout protection.
+  // We need joint states and robot states to visualize the robot. The drivers do not depend on
+  // each other, so they are started together.
+  loadDrivers(load_urdf or load_manipulation, load_navigation);
 
-  while (!nh_.hasParam(param))
+  if (load_manipulation)
   {
-    TEMOTO_DEBUG("Waiting for %s ...", param.c_str());
-    if (resource_manager_.hasFailed(interrupt_res_id))
-    {
-      throw CREATE_ERROR(error::Code::SERVICE_STATUS_FAIL, "Loading interrupted. A FAILED status was received from process manager.");
-    }
-    ros::Duration(1).sleep();
+    loadManipulation();
   }
-  TEMOTO_DEBUG("Parameter '%s' was found.", param.c_str());
-}
 
-void Robot::waitForTopic(const std::string& topic, temoto_id::ID interrupt_res_id)
-{
-  //\TODO: add 30 sec timeout protection.
-  while (!isTopicAvailable(topic))
+  if (load_navigation)
   {
-    TEMOTO_DEBUG("Waiting for %s ...", topic.c_str());
-    if (resource_manager_.hasFailed(interrupt_res_id))
-    {
-      throw CREATE_ERROR(error::Code::SERVICE_STATUS_FAIL, "Loading interrupted. A FAILED status was received from process manager.");
-    }
-    ros::Duration(1).sleep();
+    loadNavigation();
   }
-  TEMOTO_DEBUG("Topic '%s' was found.", topic.c_str());
-}
-
-bool Robot::isTopicAvailable(const std::string& topic)
-{
-  ros::master::V_TopicInfo master_topics;
-  ros::master::getTopics(master_topics);
-
-  auto it = std::find_if(
-      master_topics.begin(), master_topics.end(),
-      [&](ros::master::TopicInfo& master_topic) -> bool { return master_topic.name == topic; });
-  return it != master_topics.end();
 }
 
 // Load robot's urdf
@@ -151,12 +133,12 @@ void Robot::loadUrdf()
   {
     FeatureURDF& ftr = config_->getFeatureURDF();
     std::string urdf_path = '/' + ros::package::getPath(ftr.getPackageName()) + '/' + ftr.getExecutable();
-    temoto_id::ID res_id = rosExecute("temoto_2", "urdf_loader.py", urdf_path);
+    std::string robot_desc_param = config_->getAbsRobotNamespace() + "/robot_description";
+    temoto_2::LoadProcess load_proc_srvc;
+    load_proc_srvc.request.ready_params.push_back(robot_desc_param);
+    temoto_id::ID res_id = rosExecute("temoto_2", "urdf_loader.py", urdf_path, load_proc_srvc);
     TEMOTO_DEBUG("URDF resource id: %d", res_id);
     ftr.setResourceId(res_id);
-
-    std::string robot_desc_param = config_->getAbsRobotNamespace() + "/robot_description";
-    waitForParam(robot_desc_param, res_id);
     ftr.setLoaded(true);
     TEMOTO_DEBUG("Feature 'urdf' loaded.");
   }
@@ -177,13 +159,14 @@ void Robot::loadManipulation()
   try
   {
     FeatureManipulation& ftr = config_->getFeatureManipulation();
-    temoto_id::ID res_id = rosExecute(ftr.getPackageName(), ftr.getExecutable(), ftr.getArgs());
+    std::string desc_sem_param = config_->getAbsRobotNamespace() + "/robot_description_semantic";
+    temoto_2::LoadProcess load_proc_srvc;
+    load_proc_srvc.request.ready_params.push_back(desc_sem_param);
+    temoto_id::ID res_id = rosExecute(ftr.getPackageName(), ftr.getExecutable(), ftr.getArgs(),
+                                      load_proc_srvc);
     TEMOTO_DEBUG("Manipulation resource id: %d", res_id);
     ftr.setResourceId(res_id);
 
-    std::string desc_sem_param = config_->getAbsRobotNamespace() + "/robot_description_semantic";
-    waitForParam(desc_sem_param, res_id);
-
     ros::Duration(5).sleep();
 
     // Add planning groups
@@ -203,33 +186,6 @@ void Robot::loadManipulation()
   }
 }
 
-// Load robot driver that will publish joint states and robot state
-void Robot::loadManipulationDriver()
-{
-  if (config_->getFeatureManipulation().isDriverLoaded())
-  {
-    return; // Return if already loaded.
-  }
-
-  try
-  {
-    FeatureManipulation& ftr = config_->getFeatureManipulation();
-    temoto_id::ID res_id = rosExecute(ftr.getDriverPackageName(), ftr.getDriverExecutable(), ftr.getDriverArgs());
-    TEMOTO_DEBUG("Manipulation driver resource id: %d", res_id);
-    ftr.setDriverResourceId(res_id);
-
-    std::string joint_states_topic = config_->getAbsRobotNamespace() + "/joint_states";
-    waitForTopic(joint_states_topic, res_id);
-
-    ftr.setDriverLoaded(true);
-    TEMOTO_DEBUG("Feature 'manipulation driver' loaded.");
-  }
-  catch(error::ErrorStack& error_stack)
-  {
-    throw FORWARD_ERROR(error_stack);
-  }
-}
-
 // Load Move Base
 void Robot::loadNavigation()
 {
@@ -241,13 +197,14 @@ void Robot::loadNavigation()
   try
   {
     FeatureNavigation& ftr = config_->getFeatureNavigation();
-    temoto_id::ID res_id = rosExecute(ftr.getPackageName(), ftr.getExecutable(), ftr.getArgs());
-    TEMOTO_DEBUG("Navigation resource id: %d", res_id);
-    ftr.setResourceId(res_id);
-
     // wait for command velocity to be published
     std::string cmd_vel_topic = config_->getAbsRobotNamespace() + "/cmd_vel";
-    waitForTopic(cmd_vel_topic, res_id);
+    temoto_2::LoadProcess load_proc_srvc;
+    load_proc_srvc.request.ready_topics.push_back(cmd_vel_topic);
+    temoto_id::ID res_id = rosExecute(ftr.getPackageName(), ftr.getExecutable(), ftr.getArgs(),
+                                      load_proc_srvc);
+    TEMOTO_DEBUG("Navigation resource id: %d", res_id);
+    ftr.setResourceId(res_id);
 
     ftr.setLoaded(true);
     TEMOTO_DEBUG("Feature 'navigation' loaded.");
@@ -258,37 +215,72 @@ void Robot::loadNavigation()
   }
 }
 
-// Load robot driver that will publish odom
-void Robot::loadNavigationDriver()
+// Load robot drivers that will publish joint states, robot state and odom
+void Robot::loadDrivers(bool manipulation_driver, bool navigation_driver)
 {
-  if (config_->getFeatureNavigation().isDriverLoaded())
+  FeatureManipulation& manipulation_ftr = config_->getFeatureManipulation();
+  FeatureNavigation& navigation_ftr = config_->getFeatureNavigation();
+  manipulation_driver = manipulation_driver and !manipulation_ftr.isDriverLoaded();
+  navigation_driver = navigation_driver and !navigation_ftr.isDriverLoaded();
+
+  std::vector<temoto_2::LoadProcess> load_proc_srvcs;
+  if (manipulation_driver)
   {
-    return; // Return if already loaded.
+    temoto_2::LoadProcess load_proc_srvc;
+    load_proc_srvc.request.package_name = manipulation_ftr.getDriverPackageName();
+    load_proc_srvc.request.executable = manipulation_ftr.getDriverExecutable();
+    load_proc_srvc.request.args = manipulation_ftr.getDriverArgs();
+    load_proc_srvc.request.ready_topics.push_back(config_->getAbsRobotNamespace() + "/joint_states");
+    load_proc_srvcs.push_back(load_proc_srvc);
   }
 
-  try
+  if (navigation_driver)
   {
-    FeatureNavigation& ftr = config_->getFeatureNavigation();
-    temoto_id::ID res_id = rosExecute(ftr.getDriverPackageName(), ftr.getDriverExecutable(), ftr.getDriverArgs());
-    TEMOTO_DEBUG("Manipulation driver resource id: %d", res_id);
-    ftr.setDriverResourceId(res_id);
+    temoto_2::LoadProcess load_proc_srvc;
+    load_proc_srvc.request.package_name = navigation_ftr.getDriverPackageName();
+    load_proc_srvc.request.executable = navigation_ftr.getDriverExecutable();
+    load_proc_srvc.request.args = navigation_ftr.getDriverArgs();
+    load_proc_srvc.request.ready_topics.push_back(config_->getAbsRobotNamespace() + "/odom");
+    load_proc_srvcs.push_back(load_proc_srvc);
+  }
 
-    std::string odom_topic = config_->getAbsRobotNamespace() + "/odom";
-    waitForTopic(odom_topic, res_id);
+  if (load_proc_srvcs.empty())
+  {
+    return; // Return if already loaded.
+  }
 
-    ftr.setDriverLoaded(true);
-    TEMOTO_DEBUG("Feature 'navigation driver' loaded.");
+  try
+  {
+    rosExecute(load_proc_srvcs);
   }
   catch(error::ErrorStack& error_stack)
   {
     throw FORWARD_ERROR(error_stack);
   }
+
+  auto srvc_it = load_proc_srvcs.begin();
+  if (manipulation_driver)
+  {
+    temoto_id::ID res_id = (srvc_it++)->response.rmp.resource_id;
+    TEMOTO_DEBUG("Manipulation driver resource id: %d", res_id);
+    manipulation_ftr.setDriverResourceId(res_id);
+    manipulation_ftr.setDriverLoaded(true);
+    TEMOTO_DEBUG("Feature 'manipulation driver' loaded.");
+  }
+
+  if (navigation_driver)
+  {
+    temoto_id::ID res_id = (srvc_it++)->response.rmp.resource_id;
+    TEMOTO_DEBUG("Navigation driver resource id: %d", res_id);
+    navigation_ftr.setDriverResourceId(res_id);
+    navigation_ftr.setDriverLoaded(true);
+    TEMOTO_DEBUG("Feature 'navigation driver' loaded.");
+  }
 }
 
 temoto_id::ID Robot::rosExecute(const std::string& package_name, const std::string& executable,
-                       const std::string& args)
+                       const std::string& args, temoto_2::LoadProcess& load_proc_srvc)
 {
-  temoto_2::LoadProcess load_proc_srvc;
   load_proc_srvc.request.package_name = package_name;
   load_proc_srvc.request.ros_namespace = config_->getAbsRobotNamespace(); //Execute in robot namespace
   load_proc_srvc.request.action = process_manager::action::ROS_EXECUTE;
@@ -308,6 +300,25 @@ temoto_id::ID Robot::rosExecute(const std::string& package_name, const std::stri
   return load_proc_srvc.response.rmp.resource_id;
 }
 
+void Robot::rosExecute(std::vector<temoto_2::LoadProcess>& load_proc_srvcs)
+{
+  for (auto& load_proc_srvc : load_proc_srvcs)
+  {
+    load_proc_srvc.request.ros_namespace = config_->getAbsRobotNamespace(); //Execute in robot namespace
+    load_proc_srvc.request.action = process_manager::action::ROS_EXECUTE;
+  }
+
+  try
+  {
+    resource_manager_.callBatch<temoto_2::LoadProcess>(
+        process_manager::srv_name::MANAGER, process_manager::srv_name::SERVER, load_proc_srvcs);
+  }
+  catch(error::ErrorStack& error_stack)
+  {
+    throw FORWARD_ERROR(error_stack);
+  }
+}
+
 
 void Robot::addPlanningGroup(const std::string& planning_group_name)
 {
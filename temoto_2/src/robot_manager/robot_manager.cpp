@@ -112,8 +112,13 @@ void RobotManager::loadLocalRobot(RobotConfigPtr config, temoto_id::ID resource_
 
   try
   {
-    active_robot_ = std::make_shared<Robot>(config, resource_manager_, *this);
-    loaded_robots_.emplace(resource_id, active_robot_);
+    // The robot loads its features through the resource manager, so it is not created under the lock
+    RobotPtr robot = std::make_shared<Robot>(config, resource_manager_, *this);
+    {
+      std::lock_guard<std::mutex> robots_lock(robots_mutex_);
+      active_robot_ = robot;
+      loaded_robots_.emplace(resource_id, robot);
+    }
     config->adjustReliability(1.0);
     advertiseConfig(config);
     TEMOTO_DEBUG("Robot '%s' loaded.", config->getName().c_str());
@@ -170,8 +175,10 @@ void RobotManager::loadCb(temoto_2::RobotLoad::Request& req, temoto_2::RobotLoad
                                                   config->getTemotoNamespace());
       TEMOTO_DEBUG("Call to remote RobotManager was sucessful.");
       res.rmp = load_robot_srvc.response.rmp;
-      active_robot_ = std::make_shared<Robot>(config, resource_manager_, *this);
-      loaded_robots_.emplace(load_robot_srvc.response.rmp.resource_id, active_robot_);
+      RobotPtr robot = std::make_shared<Robot>(config, resource_manager_, *this);
+      std::lock_guard<std::mutex> robots_lock(robots_mutex_);
+      active_robot_ = robot;
+      loaded_robots_.emplace(load_robot_srvc.response.rmp.resource_id, robot);
     }
     catch(error::ErrorStack& error_stack)
     {
@@ -197,24 +204,32 @@ void RobotManager::unloadCb(temoto_2::RobotLoad::Request& req, temoto_2::RobotLo
   TEMOTO_WARN_STREAM(req);
   TEMOTO_WARN_STREAM(res);
 
+  // The robot is destroyed after the lock has been released, as it unloads its features
+  RobotPtr unloaded_robot;
+  {
+    std::lock_guard<std::mutex> robots_lock(robots_mutex_);
+
 //  ros::Duration(5).sleep();
 for (const auto& r : loaded_robots_)
 {
   TEMOTO_WARN_STREAM(r.first);
 }
 
-  // search for the robot based on its resource id, remove from map,
-  // and clear active_robot_ if the unloaded robot was active.
-  auto it = loaded_robots_.find(res.rmp.resource_id);
-  if (it != loaded_robots_.end())
-  {
-    TEMOTO_WARN("REMOVING ROBOT");
-    if (active_robot_ == it->second)
+    // search for the robot based on its resource id, remove from map,
+    // and clear active_robot_ if the unloaded robot was active.
+    auto it = loaded_robots_.find(res.rmp.resource_id);
+    if (it != loaded_robots_.end())
     {
-      active_robot_ = NULL;
+      TEMOTO_WARN("REMOVING ROBOT");
+      if (active_robot_ == it->second)
+      {
+        active_robot_ = NULL;
+      }
+      unloaded_robot = std::move(it->second);
+      loaded_robots_.erase(it);
     }
-    loaded_robots_.erase(it);
   }
+  unloaded_robot.reset();
   TEMOTO_DEBUG("ROBOT '%s' unloaded.", req.robot_name.c_str());
 }
 
@@ -259,30 +274,27 @@ void RobotManager::syncCb(const temoto_2::ConfigSync& msg, const PayloadType& pa
 
 void RobotManager::advertiseConfig(RobotConfigPtr config)
 {
-  // publish all local robots
-  YAML::Node yaml_config;
-  yaml_config["Robots"].push_back(config->getYAMLConfig());
-  PayloadType payload;
-  payload.data = YAML::Dump(yaml_config);
-  config_syncer_.advertise(payload);
+  config_syncer_.advertiseEntry(config->getName(), getSyncPayload(config));
 }
 
 void RobotManager::advertiseConfigs(RobotConfigs configs)
 {
-  // publish all local robots
-  YAML::Node yaml_config;
+  // publish the local robots, only the ones that have changed are sent to other managers
+  std::vector<std::pair<std::string, PayloadType>> entries;
   for (auto& config : configs)
   {
-    yaml_config["Robots"].push_back(config->getYAMLConfig());
+    entries.emplace_back(config->getName(), getSyncPayload(config));
   }
+  config_syncer_.advertiseEntries(entries);
+}
 
-  // send to other managers if there is anything to send
-  if (yaml_config.size())
-  {
-    PayloadType payload;
-    payload.data = YAML::Dump(yaml_config);
-    config_syncer_.advertise(payload);
-  }
+PayloadType RobotManager::getSyncPayload(RobotConfigPtr config)
+{
+  YAML::Node yaml_config;
+  yaml_config["Robots"].push_back(config->getYAMLConfig());
+  PayloadType payload;
+  payload.data = YAML::Dump(yaml_config);
+  return payload;
 }
 
 RobotConfigs RobotManager::parseRobotConfigs(const YAML::Node& yaml_config)
@@ -342,7 +354,8 @@ RobotConfigs RobotManager::parseRobotConfigs(const YAML::Node& yaml_config)
 bool RobotManager::planCb(temoto_2::RobotPlan::Request& req, temoto_2::RobotPlan::Response& res)
 {
   TEMOTO_DEBUG("PLANNING...");
-  if (!active_robot_)
+  RobotPtr active_robot = getActiveRobot();
+  if (!active_robot)
   {
     res.error_stack = CREATE_ERROR(error::Code::ROBOT_PLAN_FAIL, "Unable to plan, because no robot "
                                                                  "is loaded.");
@@ -350,7 +363,7 @@ bool RobotManager::planCb(temoto_2::RobotPlan::Request& req, temoto_2::RobotPlan
     return true;
   }
 
-  if (active_robot_->isLocal())
+  if (active_robot->isLocal())
   {
     geometry_msgs::PoseStamped pose;
     if (req.use_default_target)
@@ -368,7 +381,7 @@ bool RobotManager::planCb(temoto_2::RobotPlan::Request& req, temoto_2::RobotPlan
 
     try
     {
-      active_robot_->plan(req.planning_group, pose);
+      active_robot->plan(req.planning_group, pose);
     }
     catch (error::ErrorStack(e))
     {
@@ -383,13 +396,12 @@ bool RobotManager::planCb(temoto_2::RobotPlan::Request& req, temoto_2::RobotPlan
   else
   {
     // This robot is present in a remote robotmanager, forward the planning command to there.
-    std::string topic = "/" + active_robot_->getConfig()->getTemotoNamespace() + "/" +
+    std::string topic = "/" + active_robot->getConfig()->getTemotoNamespace() + "/" +
                         robot_manager::srv_name::SERVER_PLAN;
-    ros::ServiceClient client_plan = nh_.serviceClient<temoto_2::RobotPlan>(topic);
     temoto_2::RobotPlan fwd_plan_srvc;
     fwd_plan_srvc.request = req;
     fwd_plan_srvc.response = res;
-    if (client_plan.call(fwd_plan_srvc))
+    if (resource_manager_.getConnectionPool().call(topic, fwd_plan_srvc, true))
     {
       res = fwd_plan_srvc.response;
     }
@@ -409,11 +421,12 @@ bool RobotManager::execCb(temoto_2::RobotExecute::Request& req,
                           temoto_2::RobotExecute::Response& res)
 {
   TEMOTO_INFO("EXECUTING...");
-  if (active_robot_)
+  RobotPtr active_robot = getActiveRobot();
+  if (active_robot)
   {
-    if (active_robot_->isLocal())
+    if (active_robot->isLocal())
     {
-      active_robot_->execute();
+      active_robot->execute();
       TEMOTO_DEBUG("DONE EXECUTING...");
       res.message = "Execute command sent to MoveIt";
       res.code = rmp::status_codes::OK;
@@ -421,13 +434,12 @@ bool RobotManager::execCb(temoto_2::RobotExecute::Request& req,
     else
     {
       // This robot is present in a remote robotmanager, forward the command to there.
-      std::string topic = "/" + active_robot_->getConfig()->getTemotoNamespace() + "/" +
+      std::string topic = "/" + active_robot->getConfig()->getTemotoNamespace() + "/" +
                           robot_manager::srv_name::SERVER_EXECUTE;
-      ros::ServiceClient client_exec = nh_.serviceClient<temoto_2::RobotExecute>(topic);
       temoto_2::RobotExecute fwd_exec_srvc;
       fwd_exec_srvc.request = req;
       fwd_exec_srvc.response = res;
-      if (client_exec.call(fwd_exec_srvc))
+      if (resource_manager_.getConnectionPool().call(topic, fwd_exec_srvc))
       {
         TEMOTO_DEBUG("Call to remote RobotManager was sucessful.");
         res = fwd_exec_srvc.response;
@@ -451,6 +463,7 @@ bool RobotManager::getVizInfoCb(temoto_2::RobotGetVizInfo::Request& req,
                                 temoto_2::RobotGetVizInfo::Response& res)
 {
   TEMOTO_INFO("GETTING visualization info...");
+  std::lock_guard<std::mutex> robots_lock(robots_mutex_);
   // Search for the loaded robot, when its name is specified.
   if (req.robot_name != "")
   {
@@ -492,7 +505,16 @@ bool RobotManager::getVizInfoCb(temoto_2::RobotGetVizInfo::Request& req,
 bool RobotManager::setTargetCb(temoto_2::RobotSetTarget::Request& req,
                                temoto_2::RobotSetTarget::Response& res)
 {
-  if (active_robot_->isLocal())
+  RobotPtr active_robot = getActiveRobot();
+  if (!active_robot)
+  {
+    TEMOTO_ERROR("Unable to set the target, because the robot is not loaded.");
+    res.message = "Unable to set the target, because the robot is not loaded.";
+    res.code = rmp::status_codes::FAILED;
+    return true;
+  }
+
+  if (active_robot->isLocal())
   {
     TEMOTO_INFO("Setting target to object '%s'", req.object_name.c_str());
 
@@ -519,13 +541,12 @@ bool RobotManager::setTargetCb(temoto_2::RobotSetTarget::Request& req,
   {
     // This is remote robot, forward the set target command
 
-    std::string topic = "/" + active_robot_->getConfig()->getTemotoNamespace() + "/" +
+    std::string topic = "/" + active_robot->getConfig()->getTemotoNamespace() + "/" +
                         robot_manager::srv_name::SERVER_SET_TARGET;
-    ros::ServiceClient client_mode = nh_.serviceClient<temoto_2::RobotSetTarget>(topic);
     temoto_2::RobotSetTarget fwd_target_srvc;
     fwd_target_srvc.request = req;
     fwd_target_srvc.response = res;
-    if (client_mode.call(fwd_target_srvc))
+    if (resource_manager_.getConnectionPool().call(topic, fwd_target_srvc, true))
     {
       TEMOTO_DEBUG("Call to remote RobotManager was sucessful.");
       res = fwd_target_srvc.response;
@@ -545,6 +566,7 @@ bool RobotManager::setModeCb(temoto_2::RobotSetMode::Request& req,
                              temoto_2::RobotSetMode::Response& res)
 {
   TEMOTO_INFO("SET MODE...");
+  RobotPtr active_robot = getActiveRobot();
   // input validation
   if (req.mode != modes::AUTO && req.mode != modes::NAVIGATION && req.mode != modes::MANIPULATION)
   {
@@ -554,9 +576,9 @@ bool RobotManager::setModeCb(temoto_2::RobotSetMode::Request& req,
     return true;
   }
 
-  if (active_robot_)
+  if (active_robot)
   {
-    if (active_robot_->isLocal())
+    if (active_robot->isLocal())
     {
       mode_ = req.mode;
       TEMOTO_DEBUG("Robot mode set to: %s...", mode_.c_str());
@@ -566,13 +588,12 @@ bool RobotManager::setModeCb(temoto_2::RobotSetMode::Request& req,
     else
     {
       // This robot is present in a remote robotmanager, forward the command to there.
-      std::string topic = "/" + active_robot_->getConfig()->getTemotoNamespace() + "/" +
+      std::string topic = "/" + active_robot->getConfig()->getTemotoNamespace() + "/" +
                           robot_manager::srv_name::SERVER_SET_MODE;
-      ros::ServiceClient client_mode = nh_.serviceClient<temoto_2::RobotSetMode>(topic);
       temoto_2::RobotSetMode fwd_mode_srvc;
       fwd_mode_srvc.request = req;
       fwd_mode_srvc.response = res;
-      if (client_mode.call(fwd_mode_srvc))
+      if (resource_manager_.getConnectionPool().call(topic, fwd_mode_srvc, true))
       {
         TEMOTO_DEBUG("Call to remote RobotManager was sucessful.");
         res = fwd_mode_srvc.response;
@@ -694,9 +715,17 @@ void RobotManager::statusInfoCb(temoto_2::ResourceStatus& srv)
   // Currently we simply remove the loaded robot if it failed
   if (srv.request.status_code == rmp::status_codes::FAILED)
   {
+    // The failed robot is destroyed after the lock has been released, as it unloads its features
+    RobotPtr failed_robot;
+    std::unique_lock<std::mutex> robots_lock(robots_mutex_);
+
     // was it a remote robot
-    if (loaded_robots_.erase(srv.request.resource_id))
+    auto robot_it = loaded_robots_.find(srv.request.resource_id);
+    if (robot_it != loaded_robots_.end())
     {
+      failed_robot = std::move(robot_it->second);
+      loaded_robots_.erase(robot_it);
+      robots_lock.unlock();
       TEMOTO_DEBUG("Removed remote robot, because its status failed.");
       return;
     }
@@ -707,21 +736,28 @@ void RobotManager::statusInfoCb(temoto_2::ResourceStatus& srv)
     {
       if (it->second->hasResource(srv.request.resource_id))
       {
-        RobotConfigPtr config = it->second->getConfig();
-        config->adjustReliability(0.0);
-        YAML::Node yaml_config;
-        yaml_config["Robots"].push_back(config->getYAMLConfig());
-        PayloadType payload;
-        payload.data = YAML::Dump(yaml_config);
-        std::cout << payload << std::endl;
-        config_syncer_.advertise(payload);
+        failed_robot = std::move(it->second);
         loaded_robots_.erase(it);
         break;
       }
     }
+    robots_lock.unlock();
+
+    if (failed_robot)
+    {
+      RobotConfigPtr config = failed_robot->getConfig();
+      config->adjustReliability(0.0);
+      advertiseConfig(config);
+    }
   }
 }
 
+RobotManager::RobotPtr RobotManager::getActiveRobot()
+{
+  std::lock_guard<std::mutex> robots_lock(robots_mutex_);
+  return active_robot_;
+}
+
 RobotConfigPtr RobotManager::findRobot(const std::string& robot_name, const RobotConfigs& configs)
 {
   // Local list of devices that follow the requirements
@@ -17,7 +17,8 @@ SensorManagerServers::SensorManagerServers(BaseSubsystem *b, SensorInfoRegistry
   // Start the server
   resource_manager_.addServer<temoto_2::LoadSensor>( srv_name::SERVER
                                                    , &SensorManagerServers::loadSensorCb
-                                                   , &SensorManagerServers::unloadSensorCb);
+                                                   , &SensorManagerServers::unloadSensorCb
+                                                   , rmp::PARALLEL_LOAD_THREAD_COUNT);
   // Register callback for status info
   resource_manager_.registerStatusCb(&SensorManagerServers::statusCb);
 
@@ -38,6 +39,7 @@ void SensorManagerServers::statusCb(temoto_2::ResourceStatus& srv)
   // synchronizer.
   if (srv.request.status_code == rmp::status_codes::FAILED)
   {
+    std::lock_guard<std::mutex> lock(allocated_sensors_mutex_);
     auto it = allocated_sensors_.find(srv.request.resource_id);
     if (it != allocated_sensors_.end())
     {
@@ -128,7 +130,10 @@ void SensorManagerServers::loadSensorCb( temoto_2::LoadSensor::Request& req
       throw FORWARD_ERROR(error_stack);
     }
 
-    allocated_sensors_.emplace(res.rmp.resource_id, si);
+    {
+      std::lock_guard<std::mutex> lock(allocated_sensors_mutex_);
+      allocated_sensors_.emplace(res.rmp.resource_id, si);
+    }
 
     return;
   }
@@ -165,6 +170,7 @@ void SensorManagerServers::loadSensorCb( temoto_2::LoadSensor::Request& req
 
       TEMOTO_DEBUG("Call to remote SensorManagerServers was sucessful.");
       res = load_sensor_msg.response;
+      std::lock_guard<std::mutex> lock(allocated_sensors_mutex_);
       allocated_sensors_.emplace(res.rmp.resource_id, si);
     }
     catch(error::ErrorStack& error_stack)
@@ -185,6 +191,7 @@ void SensorManagerServers::unloadSensorCb(temoto_2::LoadSensor::Request& req,
                                  temoto_2::LoadSensor::Response& res)
 {
   TEMOTO_DEBUG("received a request to stop sensor with id '%ld'", res.rmp.resource_id);
+  std::lock_guard<std::mutex> lock(allocated_sensors_mutex_);
   allocated_sensors_.erase(res.rmp.resource_id);
   return;
 }
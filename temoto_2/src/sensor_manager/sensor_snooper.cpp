@@ -19,8 +19,9 @@ SensorSnooper::SensorSnooper( BaseSubsystem*b
 , action_engine_(this, false, ros::package::getPath(ROS_PACKAGE_NAME) + "/../temoto_actions/resource_snooper_actions")
 , sir_(sir)
 {
-  // Sensor Info update monitoring timer
-  update_monitoring_timer_ = nh_.createTimer(ros::Duration(1), &SensorSnooper::updateMonitoringTimerCb, this);
+  // The local sensor infos are asynchronously updated/created by snooper agents and the sensor
+  // manager, advertise every change to other instances of temoto
+  sir_->setUpdateCallback([this](const SensorInfo& si) { advertiseSensor(si); });
 
   // Get remote sensor_infos
   config_syncer_.requestRemoteConfigs();
@@ -47,7 +48,7 @@ void SensorSnooper::startSnooping()
   sub_0.addData("string", catkin_ws);
 
   // This object will be updated insire the tracking action
-  sub_0.addData("pointer", boost::any_cast<SensorInfoRegistry*>(sir_));
+  sub_0.addData("pointer", TTP::DataValue(sir_));
 
   subjects.push_back(sub_0);
 
@@ -63,36 +64,47 @@ void SensorSnooper::startSnooping()
   TTP::TaskTreeNode& root_node = sft.getRootNode();
   sft.printTaskDescriptors(root_node);
 
-  // Execute the SFT
-  action_engine_.executeSFTThreaded(std::move(sft));
+  // Execute the SFT. The snooping is not started if the executor does not admit the tree.
+  try
+  {
+    action_engine_.executeSFTThreaded(std::move(sft));
+  }
+  catch (error::ErrorStack& error_stack)
+  {
+    TEMOTO_ERROR("Unable to start snooping for sensors.");
+    FORWARD_ERROR(error_stack);
+  }
 }
 
-void SensorSnooper::advertiseSensor(SensorInfo& si) const
+void SensorSnooper::advertiseSensor(const SensorInfo& si) const
 {
   //TEMOTO_DEBUG("------ Advertising Sensor \n %s", sensor_ptr->toString().c_str());
-  YAML::Node config;
-  config["Sensors"].push_back(si);
-  PayloadType payload;
-  payload.data = Dump(config);
-  config_syncer_.advertise(payload);
+  config_syncer_.advertiseEntry(getSyncKey(si), getSyncPayload(si));
 }
 
 void SensorSnooper::advertiseLocalSensors() const
 {
-  // publish all local sensors
-  YAML::Node config;
+  // publish the local sensors, only the ones that have changed are sent to other managers
+  std::vector<std::pair<std::string, PayloadType>> entries;
   for(const auto& s : sir_->getLocalSensors())
   {
-    config["Sensors"].push_back(s);
+    entries.emplace_back(getSyncKey(s), getSyncPayload(s));
   }
+  config_syncer_.advertiseEntries(entries);
+}
 
-  // send to other managers if there is anything to send
-  if(config.size())
-  {
-    PayloadType payload;
-    payload.data = Dump(config);
-    config_syncer_.advertise(payload);
-  }
+std::string SensorSnooper::getSyncKey(const SensorInfo& si)
+{
+  return si.getPackageName() + "/" + si.getExecutable() + "/" + si.getName();
+}
+
+SensorSnooper::PayloadType SensorSnooper::getSyncPayload(const SensorInfo& si)
+{
+  YAML::Node config;
+  config["Sensors"].push_back(si);
+  PayloadType payload;
+  payload.data = Dump(config);
+  return payload;
 }
 
 std::vector<SensorInfoPtr> SensorSnooper::parseSensors(const YAML::Node& config)
@@ -191,23 +203,9 @@ void SensorSnooper::syncCb(const temoto_2::ConfigSync& msg, const PayloadType& p
   }
 }
 
-void SensorSnooper::updateMonitoringTimerCb(const ros::TimerEvent& e)
-{
-
-  // Iterate through local sensors and check if their reliability has been updated
-  for (const auto sensor : sir_->getLocalSensors())
-  {
-    if (!sensor.getAdvertised())
-    {
-      SensorInfo si = sensor;
-      sir_->updateLocalSensor(si, true);
-      advertiseSensor(si);
-    }
-  }
-}
-
 SensorSnooper::~SensorSnooper()
 {
+  sir_->setUpdateCallback(nullptr);
   TEMOTO_INFO("in the destructor of Sensor Snooper");
 }
 
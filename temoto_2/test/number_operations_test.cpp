@@ -0,0 +1,59 @@
+#include "TTP/language_processors/nlp_tools/number_operations.h"
+#include <gtest/gtest.h>
+#include <map>
+
+namespace
+{
+
+// The largest number the lookup table of the meta language processor used to contain
+const unsigned int MAX_NUMBER = 999999;
+
+/**
+ * @brief The str->int map which strtoint replaced, as it was built before
+ */
+std::map<std::string, int> generateStrToNrMap(int max_nr)
+{
+  std::map<std::string, int> str_int_map;
+  for (int i = 0; i <= max_nr; i++)
+  {
+    str_int_map[TTP::inttostr(i)] = i;
+  }
+  return str_int_map;
+}
+
+} // anonymous namespace
+
+TEST(NumberOperations, StrtointMatchesTheLookupTable)
+{
+  std::map<std::string, int> str_int_map = generateStrToNrMap(MAX_NUMBER);
+  ASSERT_EQ(str_int_map.size(), MAX_NUMBER + 1);
+
+  for (const auto& str_int : str_int_map)
+  {
+    unsigned int number = 0;
+    ASSERT_TRUE(TTP::strtoint(str_int.first, number)) << "'" << str_int.first << "'";
+    ASSERT_EQ(static_cast<unsigned int>(str_int.second), number) << "'" << str_int.first << "'";
+  }
+}
+
+TEST(NumberOperations, StrtointRejectsWhatTheLookupTableLacks)
+{
+  const std::vector<std::string> not_numbers = { "", " ", "one ", " one", "one  hundred",
+                                                 "twenty twenty", "hundred", "one hundred and one",
+                                                 "ten thousand thousand", "one million",
+                                                 "fifteen hundred", "forty", "twentyone",
+                                                 "zero thousand", "thirty zero", "eleventeen" };
+  std::map<std::string, int> str_int_map = generateStrToNrMap(MAX_NUMBER);
+
+  for (const auto& str : not_numbers)
+  {
+    unsigned int number = 12345;
+    EXPECT_EQ(str_int_map.count(str) != 0, TTP::strtoint(str, number)) << "'" << str << "'";
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -56,9 +56,9 @@ void startInterface_0()
 
   TTP::Subject what_1_in = TTP::getSubjectByType("what", input_subjects);
   std::string  what_1_word_in = what_1_in.words_[0];
-  std::string  what_1_data_0_in = boost::any_cast<std::string>(what_1_in.data_[0].value);
-  std::string  what_1_data_1_in = boost::any_cast<std::string>(what_1_in.data_[1].value);
-  context_manager::ObjectPtr  what_1_data_2_in = boost::any_cast<context_manager::ObjectPtr>(what_1_in.data_[2].value);
+  std::string  what_1_data_0_in = what_1_in.data_[0].value.get<std::string>();
+  std::string  what_1_data_1_in = what_1_in.data_[1].value.get<std::string>();
+  context_manager::ObjectPtr  what_1_data_2_in = what_1_in.data_[2].value.get<context_manager::ObjectPtr>();
 
   // </ AUTO-GENERATED, DO NOT MODIFY >
 
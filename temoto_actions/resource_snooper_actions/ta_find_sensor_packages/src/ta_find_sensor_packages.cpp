@@ -23,8 +23,8 @@
 
 #include "sensor_manager/sensor_info.h"
 #include "sensor_manager/sensor_info_registry.h"
+#include "common/description_watcher.h"
 
-#include <boost/filesystem/operations.hpp>
 #include <yaml-cpp/yaml.h>
 #include <fstream>
 
@@ -82,110 +82,59 @@ void startInterface_0()
   /* EXTRACTION OF INPUT SUBJECTS */
   TTP::Subject what_0_in = TTP::getSubjectByType("what", input_subjects);
   std::string  what_0_word_in = what_0_in.words_[0];
-  std::string  what_0_data_0_in = boost::any_cast<std::string>(what_0_in.data_[0].value);
-  sensor_manager::SensorInfoRegistry*     what_0_data_1_in = boost::any_cast<sensor_manager::SensorInfoRegistry*>(what_0_in.data_[1].value);
+  std::string  what_0_data_0_in = what_0_in.data_[0].value.get<std::string>();
+  sensor_manager::SensorInfoRegistry*     what_0_data_1_in = what_0_in.data_[1].value.get<sensor_manager::SensorInfoRegistry*>();
 
   // Get the catkin workspace src directory path
   std::string catkin_ws_src_dir = what_0_data_0_in;
   sensor_manager::SensorInfoRegistry* sid = what_0_data_1_in;
 
-  // Look for new packages every 10 seconds
-  while(stop_task_ == false)
-  {
-    TEMOTO_DEBUG_STREAM("Snooping the catkin workspace at: " << catkin_ws_src_dir);
+  // Watch the sensor descriptor files in the workspace
+  common::DescriptionWatcher<sensor_manager::SensorInfo> watcher( catkin_ws_src_dir
+                                                                , description_file_
+                                                                , ignore_dirs_
+                                                                , [this](const std::string& path)
+                                                                  {
+                                                                    return getSensorInfo(path);
+                                                                  });
 
-    // Find all sensor descriptor file paths
-    boost::filesystem::path base_path (catkin_ws_src_dir);
-    std::vector<std::string> sensor_desc_file_paths = findSensorDescFiles(base_path);
+  TEMOTO_DEBUG_STREAM("Snooping the catkin workspace at: " << catkin_ws_src_dir);
+  addSensors(watcher.scan(), sid);
 
-    // Read in the sensor descriptors
-    std::vector<sensor_manager::SensorInfo> sensor_infos;
-    for (const std::string& desc_file_path : sensor_desc_file_paths)
-    {
-      try
-      {
-        std::vector<sensor_manager::SensorInfo> sensor_infos_current = getSensorInfo(desc_file_path);
-        sensor_infos.insert( sensor_infos.end()
-                           , sensor_infos_current.begin()
-                           , sensor_infos_current.end());
-      }
-      catch(...)
-      {
-        // TODO: implement a proper catch block
-      }
-    }
-
-    TEMOTO_DEBUG_STREAM("got " << sensor_infos.size() << " sensors");
-
-    for (auto si : sensor_infos)
-    {
-      if (sid->addLocalSensor(si))
-      {
-        TEMOTO_DEBUG("Added a new sensor");
-      }
-      else
-      {
-        TEMOTO_DEBUG("This sensor already exists in the SID");
-      }
-    }
-
-    // Sleep for 10 seconds
-    ros::Duration(10).sleep();
+  // Only the created and modified descriptor files are read in from now on
+  while(stop_task_ == false)
+  {
+    addSensors(watcher.waitForChanges(1000), sid);
   }
 }
 
 /**
- * @brief findSensorDescFiles
- * @param path
- * @return
+ * @brief addSensors
+ * @param sensor_infos
+ * @param sid
  */
-std::vector<std::string> findSensorDescFiles( const boost::filesystem::path& base_path, int search_depth = 1)
+void addSensors( const std::vector<sensor_manager::SensorInfo>& sensor_infos
+               , sensor_manager::SensorInfoRegistry* sid)
 {
-  boost::filesystem::directory_iterator end_itr;
-  std::vector <std::string> desc_file_paths;
-
-  try
+  if (sensor_infos.empty())
   {
-    // Start looking the files inside current directory
-    for (boost::filesystem::directory_iterator itr( base_path ); itr != end_itr; ++itr)
-    {
-      // if its a directory and depth limit is not there yet, go inside it
-      if (boost::filesystem::is_directory(*itr) &&
-          checkIgnoreDirs(itr->path().filename().string()) &&
-          (search_depth > 0))
-      {
-         std::vector <std::string> sub_desc_file_paths = findSensorDescFiles( *itr, search_depth - 1 );
-
-        // Append the subtasks if not empty
-        if (!sub_desc_file_paths.empty())
-        {
-          desc_file_paths.insert( std::end(desc_file_paths)
-                                , std::begin(sub_desc_file_paths)
-                                , std::end(sub_desc_file_paths));
-        }
-      }
-
-      // if its a file and matches the desc file name, process the file
-      else if ( boost::filesystem::is_regular_file(*itr) &&
-                (itr->path().filename() == description_file_) )
-      {
-        desc_file_paths.push_back(itr->path().string());
-      }
-
-
-    }
-    return desc_file_paths;
-  }
-  catch (std::exception& e)
-  {
-    // Rethrow the exception
-    throw CREATE_ERROR(error::Code::FIND_TASK_FAIL, e.what());
+    return;
   }
 
-  catch(...)
+  TEMOTO_DEBUG_STREAM("got " << sensor_infos.size() << " sensors");
+
+  for (const auto& si : sensor_infos)
   {
-    // Rethrow the exception
-    throw CREATE_ERROR(error::Code::UNHANDLED_EXCEPTION, "Received an unhandled exception");
+    if (sid->addLocalSensor(si))
+    {
+      TEMOTO_DEBUG("Added a new sensor");
+    }
+    else
+    {
+      // The descriptor file of an existing sensor was modified
+      sid->updateLocalSensor(si);
+      TEMOTO_DEBUG("Updated a sensor that already exists in the SID");
+    }
   }
 }
 
@@ -280,24 +229,6 @@ std::vector<sensor_manager::SensorInfo> parseSensors(const YAML::Node& config) c
   return std::move(sensors);
 }
 
-/**
- * @brief Checks if the given directory should be ignored or not
- * @param dir
- * @return
- */
-bool checkIgnoreDirs( std::string dir)
-{
-  for (const std::string& ignore_dir : ignore_dirs_)
-  {
-    if (dir == ignore_dir)
-    {
-      return false;
-    }
-  }
-
-  return true;
-}
-
 /// Directories that can be ignored
 std::vector<std::string> ignore_dirs_{"src", "launch", "config", "build", "description"};
 
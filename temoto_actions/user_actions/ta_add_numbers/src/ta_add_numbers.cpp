@@ -53,11 +53,11 @@ void startInterface_0()
     // Extracting input subjects
     TTP::Subject numeric_0_in = TTP::getSubjectByType("numeric", input_subjects);
     std::string  numeric_0_word_in = numeric_0_in.words_[0];
-    float        numeric_0_data_0_in = boost::any_cast<float>(numeric_0_in.data_[0].value);
+    float        numeric_0_data_0_in = numeric_0_in.data_[0].value.get<float>();
 
     TTP::Subject numeric_1_in = TTP::getSubjectByType("numeric", input_subjects);
     std::string  numeric_1_word_in = numeric_1_in.words_[0];
-    float        numeric_1_data_0_in = boost::any_cast<float>(numeric_1_in.data_[0].value);
+    float        numeric_1_data_0_in = numeric_1_in.data_[0].value.get<float>();
 
     std::string  numeric_0_word_out;
     float        numeric_0_data_0_out;
@@ -79,7 +79,7 @@ void startInterface_0()
 
     TTP::Subject numeric_0_out("numeric", numeric_0_word_out);
     numeric_0_out.markComplete();
-    numeric_0_out.data_.emplace_back("number", boost::any_cast<float>(numeric_0_data_0_out));
+    numeric_0_out.data_.emplace_back("number", numeric_0_data_0_out);
     output_subjects.push_back(numeric_0_out);
 
     // </ AUTO-GENERATED, DO NOT MODIFY >
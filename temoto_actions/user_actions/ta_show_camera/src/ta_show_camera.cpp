@@ -50,7 +50,7 @@ void startTask(TTP::TaskInterface task_interface)
       break;
     }
   }
-  catch(boost::bad_any_cast& e)
+  catch(boost::bad_get& e)
   {
       std::cout << "OH NO: " << e.what() << std::endl;
   }
@@ -68,7 +68,7 @@ void startInterface_0()
   // Extracting input subjects
   TTP::Subject what_0_in = TTP::getSubjectByType("what", input_subjects);
   std::string  what_0_word_in = what_0_in.words_[0];
-  std::string  what_0_data_0_in = boost::any_cast<std::string>(what_0_in.data_[0].value);
+  std::string  what_0_data_0_in = what_0_in.data_[0].value.get<std::string>();
 
   TTP::Subject where_0_in = TTP::getSubjectByType("where", input_subjects);
   std::string  where_0_word_in = where_0_in.words_[0];
@@ -100,7 +100,7 @@ void startInterface_0()
 
   TTP::Subject what_0_out("what", what_0_word_out);
   what_0_out.markComplete();
-  what_0_out.data_.emplace_back("topic", boost::any_cast<std::string>(what_0_data_0_out));
+  what_0_out.data_.emplace_back("topic", what_0_data_0_out);
   output_subjects.push_back(what_0_out);
 
   // </ AUTO-GENERATED, DO NOT MODIFY >
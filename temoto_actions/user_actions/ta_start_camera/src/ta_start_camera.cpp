@@ -98,7 +98,7 @@ public:
 
     TTP::Subject what_0_out("what", what_0_word_out);
     what_0_out.markComplete();
-    what_0_out.data_.emplace_back("topic", boost::any_cast<std::string>(what_0_data_0_out));
+    what_0_out.data_.emplace_back("topic", what_0_data_0_out);
     output_subjects.push_back(what_0_out);
 
     // </ AUTO-GENERATED, DO NOT MODIFY >